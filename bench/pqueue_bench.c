@@ -0,0 +1,119 @@
+/*******************************************************************************
+************************** - PRIORITY QUEUE BENCHMARK - ************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Enqueue n random keys, then dequeue them all, per engine.
+*					Build with every source of src:
+*					gcc -ansi -pedantic-errors -O2 -DNDEBUG -Iinclude
+*						src/<all>.c bench/pqueue_bench.c -pthread -lm
+*					./a.out [n]		(default 10000000)
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L		/* clock_gettime */
+
+#include <stdio.h>		/* printf */
+#include <stdlib.h>		/* malloc, free, strtoul */
+#include <stddef.h>		/* size_t */
+#include <time.h>		/* clock_gettime */
+
+#include "utilities.h"
+#include "pqueue.h"
+
+#define DEFAULT_NUM 10000000
+#define LIST_MAX_NUM 20000			/* SortLInsert is O(n) per element */
+
+static int CmpUnsigned(const void *obj1, const void *obj2, const void *param);
+static double NowImp(void);
+static void RunImp(pq_engine_ty engine, const char *name, unsigned *keys, size_t n);
+
+int main(int argc, char *argv[])
+{
+	size_t n = (1 < argc) ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_NUM;
+	unsigned *keys = (unsigned *)malloc(n * sizeof(unsigned) + 1);
+	unsigned long seed = 12345;
+	size_t i = 0;
+
+	if (NULL == keys)
+	{
+		return 1;
+	}
+
+	for (i = 0; i < n; ++i)
+	{
+		seed = (seed * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+		keys[i] = (unsigned)(seed >> 1);
+	}
+
+	printf("%-10s %12s %12s %12s\n", "engine", "n", "enqueue s", "dequeue s");
+
+	RunImp(PQ_ENGINE_LIST, "list", keys, (n < LIST_MAX_NUM) ? n : LIST_MAX_NUM);
+	RunImp(PQ_ENGINE_HEAP, "heap", keys, n);
+	RunImp(PQ_ENGINE_SEQHEAP, "seqheap", keys, n);
+
+	free(keys);
+
+	return 0;
+}
+
+static void RunImp(pq_engine_ty engine, const char *name, unsigned *keys, size_t n)
+{
+	pq_config_ty config = {PQ_ENGINE_LIST, NULL, 0, 0, NULL, NULL, NULL, NULL};
+	pqueue_ty *pqueue = NULL;
+	double start = 0;
+	double enqueued = 0;
+	size_t i = 0;
+
+	config.engine = engine;
+	pqueue = PQueueCreateEx(CmpUnsigned, NULL, &config);
+
+	if (NULL == pqueue)
+	{
+		printf("%-10s create failed\n", name);
+		return;
+	}
+
+	start = NowImp();
+
+	for (i = 0; i < n; ++i)
+	{
+		if (0 != PQueueEnqueue(pqueue, &keys[i]))
+		{
+			printf("%-10s enqueue failed\n", name);
+			PQueueDestroy(pqueue);
+			return;
+		}
+	}
+
+	enqueued = NowImp();
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		PQueueDequeue(pqueue);
+	}
+
+	printf("%-10s %12lu %12.3f %12.3f\n", name, (unsigned long)n,
+			enqueued - start, NowImp() - enqueued);
+
+	PQueueDestroy(pqueue);
+}
+
+static int CmpUnsigned(const void *obj1, const void *obj2, const void *param)
+{
+	unsigned key1 = *(const unsigned *)obj1;
+	unsigned key2 = *(const unsigned *)obj2;
+
+	UNUSED(param);
+
+	return (key1 > key2) - (key1 < key2);
+}
+
+static double NowImp(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
@@ -0,0 +1,102 @@
+/*******************************************************************************
+*************************** - EDF SCHEDULER - *********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of Earliest deadline first scheduler with aging
+*	AUTHOR 			Liad Raz
+*	FILES			edf.c edf_test.c edf.h
+*
+*******************************************************************************/
+
+#ifndef __EDF_H__
+#define __EDF_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct edf edf_ty;
+typedef struct edf_task edf_task_ty;
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Creates a scheduler. The task with the earliest deadline runs
+				first. aging_percent credits a waiting task aging_percent / 100
+				deadline units per unit of waiting, so a task which waits long
+				overtakes later submitted tasks with earlier deadlines.
+				0 is plain EDF. Time is in any unit of the user.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated container.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+edf_ty *EDFCreate(unsigned int aging_percent);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the scheduler and the tasks left; their data is not freed.
+
+* Time Complexity 	O(n)
+*******************************************************************************/
+void EDFDestroy(edf_ty *sched);
+
+/*******************************************************************************
+* DESCRIPTION	Add a task of budget units of work, due at deadline.
+				now is the time of the submission, for aging.
+				deadline and now may be any unsigned long: the priority
+				deadline * 100 + aging_percent * now is computed in two words
+				and does not overflow.
+* RETURN		Handle of the task, valid until it completes or is canceled;
+				NULL on memory allocation FAILURE.
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+edf_task_ty *EDFSubmit(edf_ty *sched, void *data, unsigned long deadline,
+						unsigned long budget, unsigned long now);
+
+/*******************************************************************************
+* DESCRIPTION	Get the task to run now. Equal priorities run in submission order.
+* RETURN		NULL when no task is left.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+edf_task_ty *EDFNext(const edf_ty *sched);
+
+/*******************************************************************************
+* DESCRIPTION	Charge the task returned by EDFNext with used units of work.
+				A task whose budget is used up completes and is freed.
+* RETURN		The data of the completed task; NULL while it has budget left.
+* IMPORTANT		Undefined behavior when sched is empty.
+
+* Time Complexity 	O(log(n)) on completion; O(1) otherwise
+*******************************************************************************/
+void *EDFCharge(edf_ty *sched, unsigned long used);
+
+/*******************************************************************************
+* DESCRIPTION	Remove a task before it completes; the task is freed.
+* RETURN		The data of the task.
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+void *EDFCancel(edf_ty *sched, edf_task_ty *task);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of tasks.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t EDFSize(const edf_ty *sched);
+
+/*******************************************************************************
+* DESCRIPTION	Get the data, deadline and budget left of a task.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void *EDFTaskData(const edf_task_ty *task);
+unsigned long EDFTaskDeadline(const edf_task_ty *task);
+unsigned long EDFTaskBudget(const edf_task_ty *task);
+
+
+#endif /* __EDF_H__ */
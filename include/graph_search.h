@@ -0,0 +1,124 @@
+/*******************************************************************************
+***************************** - GRAPH SEARCH - ********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of Shortest paths (Dijkstra / A*) over a CSR graph
+*	AUTHOR 			Liad Raz
+*	FILES			graph_search.c graph_search_test.c graph_search.h
+*
+*******************************************************************************/
+
+#ifndef __GRAPH_SEARCH_H__
+#define __GRAPH_SEARCH_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct graph_search graph_search_ty;
+
+/* node id - 32 bit */
+typedef unsigned int graph_node_ty;
+
+#define GRAPH_NO_NODE ((graph_node_ty)-1)
+#define GRAPH_INFINITY ((unsigned long)-1)
+
+/*******************************************************************************
+* DESCRIPTION	Graph in compressed sparse rows. The edges of node u are
+				targets[i], weights[i] for offsets[u] <= i < offsets[u + 1].
+				The arrays are not copied; they must outlive the search.
+*******************************************************************************/
+typedef struct csr_graph
+{
+	size_t num_nodes;
+	const size_t *offsets;				/* num_nodes + 1 */
+	const graph_node_ty *targets;
+	const unsigned int *weights;
+} csr_graph_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Open set of the search.
+				GRAPH_OPEN_HEAP	 - binary heap with decrease-key.
+				GRAPH_OPEN_RADIX - radix heap: buckets by the highest bit in
+								   which a key differs from the last minimum.
+								   Needs monotone keys, which Dijkstra and A*
+								   with a consistent heuristic give.
+*******************************************************************************/
+typedef enum graph_open_set
+{
+	GRAPH_OPEN_HEAP = 0,
+	GRAPH_OPEN_RADIX
+} graph_open_set_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in GraphSearchRun. Lower bound of the distance from node
+				to target; must be consistent: h(u) <= weight(u, v) + h(v).
+*******************************************************************************/
+typedef unsigned long (*GraphHeuristicFunc)(graph_node_ty node, graph_node_ty target,
+											void *param);
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Creates a search workspace for graph. The workspace is reused
+				by every run; a run touches only the nodes it reaches.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated container.
+
+* Time Complexity 	O(num_nodes)
+*******************************************************************************/
+graph_search_ty *GraphSearchCreate(const csr_graph_ty *graph, graph_open_set_ty open_set);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the workspace; the graph is not freed.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void GraphSearchDestroy(graph_search_ty *search);
+
+/*******************************************************************************
+* DESCRIPTION	Shortest paths from source. Stops when target is settled;
+				target GRAPH_NO_NODE settles every reachable node (Dijkstra).
+				heuristic_func_p NULL is Dijkstra, otherwise A*.
+				Results are valid until the next run.
+* RETURN		Distance of target; GRAPH_INFINITY when it is unreachable or
+				GRAPH_NO_NODE.
+* IMPORTANT		Never allocates. Distances must fit in unsigned long.
+
+* Time Complexity 	O(edges * log(nodes)) heap; O(edges + nodes * bits) radix
+*******************************************************************************/
+unsigned long GraphSearchRun(graph_search_ty *search, graph_node_ty source,
+								graph_node_ty target,
+								GraphHeuristicFunc heuristic_func_p, void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Distance of node found by the last run. A node not settled has
+				an upper bound of its distance.
+* RETURN		GRAPH_INFINITY when node was not reached.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+unsigned long GraphSearchDistance(const graph_search_ty *search, graph_node_ty node);
+
+/*******************************************************************************
+* DESCRIPTION	Previous node on the path to node found by the last run.
+* RETURN		GRAPH_NO_NODE for the source and for nodes not reached.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+graph_node_ty GraphSearchPredecessor(const graph_search_ty *search, graph_node_ty node);
+
+/*******************************************************************************
+* DESCRIPTION	Write the path of the last run from the source to node into
+				out, when it fits in max_len nodes.
+* RETURN		Number of nodes on the path; 0 when node was not reached.
+
+* Time Complexity 	O(path length)
+*******************************************************************************/
+size_t GraphSearchPath(const graph_search_ty *search, graph_node_ty node,
+						graph_node_ty *out, size_t max_len);
+
+
+#endif /* __GRAPH_SEARCH_H__ */
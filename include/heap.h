@@ -0,0 +1,201 @@
+/*******************************************************************************
+********************************* - HEAP - ************************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of Binary heap (minimum on top)
+*	AUTHOR 			Liad Raz
+*	FILES			heap.c heap_test.c heap.h
+*
+*******************************************************************************/
+
+#ifndef __HEAP_H__
+#define __HEAP_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct heap heap_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in Create
+* RETURN		0 SUCCESS; POSITIVE value obj1 > obj2; NEGATIVE value obj1 < obj2
+*******************************************************************************/
+typedef int (*HeapCmpFunc)(const void *object1, const void *object2, const void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in HeapFindIf
+* RETURN		boolean => 1 FOUND;	0 NOT_FOUND
+*******************************************************************************/
+typedef int (*HeapIsMatch)(const void *data, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in HeapSetMoveFunc. Called whenever data is placed at
+				index, so the user may keep a handle to it.
+*******************************************************************************/
+typedef void (*HeapMoveFunc)(void *data, size_t index, void *move_param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in HeapRemoveIf. Receives a removed element; it must not
+				use the heap.
+*******************************************************************************/
+typedef void (*HeapRemoveFunc)(void *data, void *remove_param);
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Creates an empty heap.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated container.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+heap_ty *HeapCreate(HeapCmpFunc cmp_func_p, const void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the heap; the elements are not freed.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void HeapDestroy(heap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Report every move of an element through move_func_p.
+				NULL stops the reports.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void HeapSetMoveFunc(heap_ty *heap, HeapMoveFunc move_func_p, void *move_param);
+
+/*******************************************************************************
+* DESCRIPTION	Add an element.
+* RETURN		status => 0 SUCCESS; non-zero value on memory allocation FAILURE
+
+* Time Complexity 	O(log(n)) amortized
+*******************************************************************************/
+int HeapPush(heap_ty *heap, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Add n elements. A big batch is appended and the heap is rebuilt
+				bottom up, instead of n sift ups.
+* RETURN		Number of elements added: n, or 0 on memory allocation FAILURE.
+
+* Time Complexity 	O(n + heap_size)
+*******************************************************************************/
+size_t HeapPushBatch(heap_ty *heap, void **items, size_t n);
+
+/*******************************************************************************
+* DESCRIPTION	Remove the minimum.
+* RETURN		The removed element; NULL when heap is empty.
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+void *HeapPop(heap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Replace the minimum by data - one sift down instead of a Pop
+				and a Push.
+* RETURN		The replaced minimum.
+* IMPORTANT		Undefined behavior when heap is empty.
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+void *HeapReplaceTop(heap_ty *heap, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Get the minimum.
+* RETURN		NULL when heap is empty.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void *HeapPeek(const heap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Get the element at index (0 is the minimum).
+* IMPORTANT		Undefined behavior when index >= HeapSize.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void *HeapGet(const heap_ty *heap, size_t index);
+
+/*******************************************************************************
+* DESCRIPTION	Remove the element at index.
+* RETURN		The removed element.
+* IMPORTANT		Undefined behavior when index >= HeapSize.
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+void *HeapRemoveAt(heap_ty *heap, size_t index);
+
+/*******************************************************************************
+* DESCRIPTION	Restore the order after the priority of the element at index
+				was changed in place (increased or decreased).
+* IMPORTANT		Undefined behavior when index >= HeapSize.
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+void HeapUpdateAt(heap_ty *heap, size_t index);
+
+/*******************************************************************************
+* DESCRIPTION	Find an element, in array order.
+* RETURN		Its index; HeapSize when not found.
+
+* Time Complexity 	O(n)
+*******************************************************************************/
+size_t HeapFindIf(const heap_ty *heap, HeapIsMatch match_func_p, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Remove every matching element in one pass over the array, then
+				rebuild the heap once. Each removed element is passed to
+				remove_func_p (may be NULL).
+* RETURN		Number of removed elements.
+
+* Time Complexity 	O(n)
+*******************************************************************************/
+size_t HeapRemoveIf(heap_ty *heap, HeapIsMatch match_func_p, const void *match_param,
+					HeapRemoveFunc remove_func_p, void *remove_param);
+
+/*******************************************************************************
+* DESCRIPTION	Replace the parameter of the comparison function and rebuild
+				the heap in place. Every element is reported to the move
+				function.
+
+* Time Complexity 	O(n)
+*******************************************************************************/
+void HeapSetCmpParam(heap_ty *heap, const void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t HeapSize(const heap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Checks if elements are stored in heap
+* RETURN		boolean => 	1 EMPTY; 0 NOT EMPTY.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+int HeapIsEmpty(const heap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Make room for capacity elements, so that pushing up to that
+				size does not allocate.
+* RETURN		status => 0 SUCCESS; non-zero value on memory allocation FAILURE
+
+* Time Complexity 	O(capacity)
+*******************************************************************************/
+int HeapReserve(heap_ty *heap, size_t capacity);
+
+/*******************************************************************************
+* DESCRIPTION	Remove all elements; the memory is kept for reuse.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void HeapClear(heap_ty *heap);
+
+
+#endif /* __HEAP_H__ */
@@ -0,0 +1,94 @@
+/*******************************************************************************
+****************************** - LOSER TREE - *********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of Tournament (loser) tree for k-way merging
+*	AUTHOR 			Liad Raz
+*	FILES			loser_tree.c loser_tree_test.c loser_tree.h
+*
+*******************************************************************************/
+
+#ifndef __LOSER_TREE_H__
+#define __LOSER_TREE_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct loser_tree loser_tree_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in Create
+* RETURN		0 SUCCESS; POSITIVE value obj1 > obj2; NEGATIVE value obj1 < obj2
+*******************************************************************************/
+typedef int (*LTCmpFunc)(const void *object1, const void *object2, const void *cmp_param);
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Creates a tree of num_sources sources, all exhausted.
+				A source holds one key - its current head. A NULL key marks an
+				exhausted source; it loses to every other key.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated container.
+
+* Time Complexity 	O(num_sources)
+*******************************************************************************/
+loser_tree_ty *LoserTreeCreate(size_t num_sources, LTCmpFunc cmp_func_p,
+								const void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the tree; the keys are not freed.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void LoserTreeDestroy(loser_tree_ty *tree);
+
+/*******************************************************************************
+* DESCRIPTION	Set the key of a source. Takes effect with LoserTreeBuild.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void LoserTreeSet(loser_tree_ty *tree, size_t source, void *key);
+
+/*******************************************************************************
+* DESCRIPTION	Play the whole tournament over the keys of all the sources.
+
+* Time Complexity 	O(num_sources)
+*******************************************************************************/
+void LoserTreeBuild(loser_tree_ty *tree);
+
+/*******************************************************************************
+* DESCRIPTION	Get the smallest key. Ties are won by the lower source.
+* RETURN		NULL when all the sources are exhausted.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void *LoserTreeTop(const loser_tree_ty *tree);
+
+/*******************************************************************************
+* DESCRIPTION	Get the source of the smallest key.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t LoserTreeWinner(const loser_tree_ty *tree);
+
+/*******************************************************************************
+* DESCRIPTION	Replace the key of the winner (its next head, or NULL) and
+				replay its path - one comparison per level.
+
+* Time Complexity 	O(log(num_sources))
+*******************************************************************************/
+void LoserTreeReplay(loser_tree_ty *tree, void *key);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of sources.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t LoserTreeNumSources(const loser_tree_ty *tree);
+
+
+#endif /* __LOSER_TREE_H__ */
@@ -0,0 +1,118 @@
+/*******************************************************************************
+************************** - PRIORITY QUEUE ENGINES - **************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Interface between pqueue and its storage engines.
+*					Used by pqueue.c and the engines; not part of the API.
+*	AUTHOR 			Liad Raz
+*	FILES			pqueue.c pq_mmap.c pq_external.c pq_heap.c pq_seqheap.c
+*					pq_engine.h
+*
+*******************************************************************************/
+
+#ifndef __PQ_ENGINE_H__
+#define __PQ_ENGINE_H__
+
+#include <stddef.h> 	/* size_t */
+
+#include "pqueue.h"
+#include "sorted_list.h"
+
+/*******************************************************************************
+* DESCRIPTION	Used in for_each
+* RETURN		status => 0 SUCCESS; non-zero value stops the traversal
+*******************************************************************************/
+typedef int (*PQVisitFunc)(void *data, void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in track and erase_at. Where an engine keeps an element:
+				the array engines use index, the list engine iter.
+*******************************************************************************/
+typedef union pq_handle
+{
+	size_t index;
+	sortl_itr_ty iter;
+} pq_handle_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in track. handle_func_p returns the handle of data, which
+				the engine updates.
+*******************************************************************************/
+typedef struct pq_tracker
+{
+	pq_handle_ty *(*handle_func_p)(const void *data, void *param);
+	void *param;
+} pq_tracker_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Operations of an engine; engine is the pointer returned by the
+				engine's create function. Every operation behaves as the
+				pqueue function of the same name.
+				enqueue_sorted - enqueue_batch of items already in priority
+							order; merged, not sorted again.
+				for_each  - visit all elements in priority order.
+				append	  - add an element which is not smaller than all the
+							others, without comparing.
+				track	  - from now on, update the handle of every element the
+							engine adds or moves. NULL stops. The engine must
+							be empty.
+				erase_at  - remove the element of handle; return it.
+				erase_if  - remove every match in one pass; pass each to
+							out_func_p. Return their number.
+				set_cmp_param - replace the parameter of the comparison
+							and restore the order of the elements stored.
+				error	  - non-zero once stored elements could not be read
+							back.
+				enqueue_batch, enqueue_sorted, for_each, append, track,
+				erase_at, erase_if, set_cmp_param may be NULL (not
+				supported); error may be NULL when the engine cannot lose
+				elements.
+*******************************************************************************/
+typedef struct pq_engine_ops
+{
+	void (*destroy)(void *engine);
+	int (*enqueue)(void *engine, void *data);
+	size_t (*enqueue_batch)(void *engine, void **items, size_t n);
+	size_t (*enqueue_sorted)(void *engine, void **items, size_t n);
+	void (*dequeue)(void *engine);
+	void *(*peek)(const void *engine);
+	int (*is_empty)(const void *engine);
+	size_t (*size)(const void *engine);
+	void (*clear)(void *engine);
+	void *(*erase)(void *engine, PQIsMatch match_func_p, void *param);
+	int (*for_each)(void *engine, PQVisitFunc visit_func_p, void *param);
+	int (*append)(void *engine, void *data);
+	void (*track)(void *engine, pq_tracker_ty *tracker);
+	void *(*erase_at)(void *engine, const pq_handle_ty *handle);
+	size_t (*erase_if)(void *engine, PQIsMatch match_func_p, void *match_param,
+						PQReleaseFunc out_func_p, void *out_param);
+	void (*set_cmp_param)(void *engine, const void *cmp_param);
+	int (*error)(const void *engine);
+} pq_engine_ops_ty;
+
+
+/*******************************************************************************
+******************************** Engines **************************************/
+
+/* PQ_ENGINE_MMAP - array heap in a memory mapped file (pq_mmap.c) */
+void *PQMmapEngineCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config);
+extern const pq_engine_ops_ty pq_mmap_engine_ops;
+
+/* PQ_ENGINE_EXTERNAL - heap spilled into sorted runs (pq_external.c) */
+void *PQExternalEngineCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+								const pq_config_ty *config);
+extern const pq_engine_ops_ty pq_external_engine_ops;
+
+/* PQ_ENGINE_HEAP - binary heap of pointers (pq_heap.c) */
+void *PQHeapEngineCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config);
+extern const pq_engine_ops_ty pq_heap_engine_ops;
+
+/* PQ_ENGINE_SEQHEAP - sequence heap of pointers (pq_seqheap.c) */
+void *PQSeqHeapEngineCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config);
+extern const pq_engine_ops_ty pq_seqheap_engine_ops;
+
+
+#endif /* __PQ_ENGINE_H__ */
@@ -0,0 +1,84 @@
+/*******************************************************************************
+**************************** - PQ INGEST BUFFER - ******************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of a multi-producer single-consumer staging ring
+*					placed in front of a priority queue.
+*	AUTHOR 			Liad Raz
+*	FILES			pq_ingest.c pq_ingest_test.c pq_ingest.h
+*
+*******************************************************************************/
+
+#ifndef __PQ_INGEST_H__
+#define __PQ_INGEST_H__
+
+#include <stddef.h> 	/* size_t */
+
+#include "pqueue.h"
+
+typedef struct pq_ingest pq_ingest_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Creates an ingestion ring for pqueue.
+				capacity is rounded up to a power of two.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		pqueue is owned by the user and must outlive the ring.
+				User needs to free the allocated ring.
+*
+* Time Complexity 	O(capacity)
+*******************************************************************************/
+pq_ingest_ty *PQIngestCreate(pqueue_ty *pqueue, size_t capacity);
+
+/*******************************************************************************
+* DESCRIPTION	Free the ring. Elements still staged are not moved to pqueue.
+
+* Time Complexity   O(1)
+*******************************************************************************/
+void PQIngestDestroy(pq_ingest_ty *ingest);
+
+/*******************************************************************************
+* DESCRIPTION	Stage an element. Safe to call from any number of threads.
+				Never waits for the consumer, and never touches pqueue.
+* RETURN		status => 0 SUCCESS; non-zero value when the ring is full.
+
+* Time Complexity   O(1)
+*******************************************************************************/
+int PQIngestPush(pq_ingest_ty *ingest, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Move every staged element into pqueue in one batched merge.
+* RETURN		status => 0 SUCCESS; non-zero value on memory allocation
+				failure. Elements which were not merged are kept and retried
+				by the next drain.
+* IMPORTANT		Consumer only. All the following functions drain first.
+
+* Time Complexity   O(k * log(k) + pqueue_size); k - number of staged elements
+*******************************************************************************/
+int PQIngestDrain(pq_ingest_ty *ingest);
+
+/*******************************************************************************
+* DESCRIPTION	Get the value with the highest priority.
+* RETURN		NULL when there are no elements.
+
+* Time Complexity   O(1) + drain
+*******************************************************************************/
+void *PQIngestPeek(pq_ingest_ty *ingest);
+
+/*******************************************************************************
+* DESCRIPTION	Remove the element with the highest priority.
+* IMPORTANT		Undefined behavior when there are no elements.
+
+* Time Complexity   O(1) + drain
+*******************************************************************************/
+void PQIngestDequeue(pq_ingest_ty *ingest);
+
+/*******************************************************************************
+* DESCRIPTION	Checks if elements are stored in pqueue or staged.
+* RETURN		boolean => 	1 EMPTY; 0 NOT EMPTY.
+
+* Time Complexity   O(1) + drain
+*******************************************************************************/
+int PQIngestIsEmpty(pq_ingest_ty *ingest);
+
+
+#endif /* __PQ_INGEST_H__ */
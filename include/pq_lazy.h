@@ -0,0 +1,104 @@
+/*******************************************************************************
+************************ - LAZY DELETION PRIORITY QUEUE - **********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of Priority queue with cancel by handle
+*	AUTHOR 			Liad Raz
+*	FILES			pq_lazy.c pq_lazy_test.c pq_lazy.h
+*
+*******************************************************************************/
+
+#ifndef __PQ_LAZY_H__
+#define __PQ_LAZY_H__
+
+#include <stddef.h> 	/* size_t */
+
+#include "pqueue.h"
+
+/*******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct pq_lazy pq_lazy_ty;
+typedef struct pq_lazy_handle pq_lazy_handle_ty;
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Creates a priority queue whose elements are cancelled by
+				handle without being removed: a cancelled element is marked
+				dead and dropped when it reaches the top, or when the dead
+				pass compact_percent (1 to 100) of the elements stored.
+				Dropped elements are passed to release_func_p (may be NULL).
+				config (may be NULL) picks the engine: PQ_ENGINE_LIST,
+				PQ_ENGINE_HEAP or PQ_ENGINE_SEQHEAP.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated container.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+pq_lazy_ty *PQLazyCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config, unsigned int compact_percent,
+							PQReleaseFunc release_func_p, void *release_param);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the queue; the elements left, dead or alive, are passed
+				to release_func_p.
+
+* Time Complexity 	O(n)
+*******************************************************************************/
+void PQLazyDestroy(pq_lazy_ty *lazy);
+
+/*******************************************************************************
+* DESCRIPTION	Add an element.
+* RETURN		Handle of the element, valid until it is dequeued or cancelled.
+				NULL on memory allocation FAILURE.
+
+* Time Complexity 	as PQueueEnqueue of the engine
+*******************************************************************************/
+pq_lazy_handle_ty *PQLazyEnqueue(pq_lazy_ty *lazy, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Cancel the element of handle. It is not removed from the
+				engine; Peek and Dequeue skip it.
+* IMPORTANT		The element is still compared until it is dropped: it must stay
+				valid until release_func_p receives it.
+
+* Time Complexity 	O(1); amortized when it triggers a compaction
+*******************************************************************************/
+void PQLazyCancel(pq_lazy_ty *lazy, pq_lazy_handle_ty *handle);
+
+/*******************************************************************************
+* DESCRIPTION	Drop the cancelled elements at the top, then get the top one.
+* RETURN		NULL when no element is alive.
+
+* Time Complexity 	as PQueueDequeue per dropped element; O(1) otherwise
+*******************************************************************************/
+void *PQLazyPeek(pq_lazy_ty *lazy);
+
+/*******************************************************************************
+* DESCRIPTION	Remove the top element alive. It passes back to the user and
+				is not released.
+* RETURN		The element; NULL when no element is alive.
+
+* Time Complexity 	as PQueueDequeue, plus the dropped elements
+*******************************************************************************/
+void *PQLazyDequeue(pq_lazy_ty *lazy);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements alive.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t PQLazySize(const pq_lazy_ty *lazy);
+
+/*******************************************************************************
+* DESCRIPTION	Checks if elements alive are stored.
+* RETURN		boolean => 	1 EMPTY; 0 NOT EMPTY.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+int PQLazyIsEmpty(const pq_lazy_ty *lazy);
+
+
+#endif /* __PQ_LAZY_H__ */
@@ -0,0 +1,61 @@
+/*******************************************************************************
+************************** - K-WAY MERGE OF STREAMS - **************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of merging sorted streams into one ordered output
+*	AUTHOR 			Liad Raz
+*	FILES			pq_merge.c pq_merge_test.c pq_merge.h
+*
+*******************************************************************************/
+
+#ifndef __PQ_MERGE_H__
+#define __PQ_MERGE_H__
+
+#include <stddef.h> 	/* size_t */
+
+#include "pqueue.h"
+
+/*******************************************************************************
+* DESCRIPTION	Used in pq_stream_ty. Write the next records of the stream, in
+				order, into buffer.
+* RETURN		Number of records written, up to capacity; 0 when the stream is
+				exhausted.
+* IMPORTANT		The records must stay valid until they are emitted.
+*******************************************************************************/
+typedef size_t (*PQPullFunc)(void **buffer, size_t capacity, void *stream_param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in PQMergeStreams. Receives the records in order.
+* RETURN		status => 0 continue; non-zero value stops the merge
+*******************************************************************************/
+typedef int (*PQEmitFunc)(void *data, void *emit_param);
+
+typedef struct pq_stream
+{
+	PQPullFunc pull_func_p;
+	void *stream_param;
+} pq_stream_ty;
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Merge num_streams sorted streams into emit_func_p. Records are
+				pulled in batches; a loser tree picks the next record with one
+				comparison per level. Equal records come out by stream index.
+* RETURN		status => 0 SUCCESS; the non-zero value of emit_func_p when it
+				stopped the merge; 1 on memory allocation FAILURE.
+* IMPORTANT		No record is copied or freed; emit_func_p may take ownership.
+				Once emit_func_p stops the merge no stream is pulled again;
+				the records already pulled but not emitted (up to one batch
+				per stream) are left unconsumed - neither emitted nor freed.
+*
+* Time Complexity 	O(records * log(num_streams))
+*******************************************************************************/
+int PQMergeStreams(const pq_stream_ty *streams, size_t num_streams,
+					PQCmpFunc cmp_func_p, const void *cmp_param,
+					PQEmitFunc emit_func_p, void *emit_param);
+
+
+#endif /* __PQ_MERGE_H__ */
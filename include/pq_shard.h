@@ -0,0 +1,101 @@
+/*******************************************************************************
+*************************** - SHARDED PRIORITY QUEUE - *************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of a NUMA aware priority queue, one shard per node
+*	AUTHOR 			Liad Raz
+*	FILES			pq_shard.c pq_shard_test.c pq_shard.h
+*
+*******************************************************************************/
+
+#ifndef __PQ_SHARD_H__
+#define __PQ_SHARD_H__
+
+#include <stddef.h> 	/* size_t */
+
+typedef struct pq_shard pq_shard_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in Create. Maps an element to its priority key.
+* RETURN		The key; a smaller key means a higher priority.
+*******************************************************************************/
+typedef long (*PQShardKeyFunc)(const void *data, const void *key_param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in pq_shard_topology_ty.
+* RETURN		The node of the calling thread, in range [0, num_nodes).
+*******************************************************************************/
+typedef size_t (*PQShardNodeFunc)(void *node_param);
+
+/*******************************************************************************
+* DESCRIPTION	Describes the machine. Pass NULL to Create to detect the real
+				topology (Linux sysfs and getcpu), or fill it to simulate one.
+				Detected node ids may be sparse: there is a shard for every
+				id up to the highest possible one.
+*******************************************************************************/
+typedef struct pq_shard_topology
+{
+	size_t num_nodes;
+	PQShardNodeFunc current_node;
+	void *node_param;
+} pq_shard_topology_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Creates a sharded pqueue.
+				threshold - the local shard is served first, unless the best
+				remote key is smaller than the local one by more than it.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated queue.
+				The shards and their pqueues are all allocated by the calling
+				thread, so they are local to its node. Only the list nodes,
+				allocated by Enqueue, are local to the node using them.
+*
+* Time Complexity 	O(num_nodes)
+*******************************************************************************/
+pq_shard_ty *PQShardCreate(PQShardKeyFunc key_func, const void *key_param,
+							const pq_shard_topology_ty *topology, long threshold);
+
+/*******************************************************************************
+* DESCRIPTION	Free the sharded pqueue.
+
+* Time Complexity   O(pqueue_size)
+*******************************************************************************/
+void PQShardDestroy(pq_shard_ty *pq_shard);
+
+/*******************************************************************************
+* DESCRIPTION	Add new element to the shard of the caller's node. The node of
+				the list is allocated by the calling thread, so it is local.
+				Thread safe.
+* RETURN		status => 0 SUCCESS; non-zero value FAILURE
+
+* Time Complexity   O(shard_size)
+*******************************************************************************/
+int PQShardEnqueue(pq_shard_ty *pq_shard, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Remove and return an element with a high priority. Remote
+				shards are only read through their published top keys, and
+				locked only when they are ahead by more than the threshold.
+				Thread safe.
+* RETURN		NULL when all shards are empty.
+
+* Time Complexity   O(num_nodes)
+*******************************************************************************/
+void *PQShardDequeue(pq_shard_ty *pq_shard);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements in all the shards.
+
+* Time Complexity   O(pqueue_size)
+*******************************************************************************/
+size_t PQShardSize(pq_shard_ty *pq_shard);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of shards (NUMA nodes).
+
+* Time Complexity   O(1)
+*******************************************************************************/
+size_t PQShardNumNodes(const pq_shard_ty *pq_shard);
+
+
+#endif /* __PQ_SHARD_H__ */
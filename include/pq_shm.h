@@ -0,0 +1,97 @@
+/*******************************************************************************
+************************* - SHARED MEMORY PRIORITY QUEUE - *********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of an inter-process priority queue which lives
+*					entirely in a caller provided shared memory region.
+*	AUTHOR 			Liad Raz
+*	FILES			pq_shm.c pq_shm_test.c pq_shm.h
+*
+*******************************************************************************/
+
+#ifndef __PQ_SHM_H__
+#define __PQ_SHM_H__
+
+#include <stddef.h> 	/* size_t */
+
+#include "pqueue.h"
+
+/* process local handle to a queue stored in shared memory */
+typedef struct pq_shm pq_shm_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the region size needed for capacity elements of
+				elem_size bytes each.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t PQShmRegionSize(size_t capacity, size_t elem_size);
+
+/*******************************************************************************
+* DESCRIPTION	Initialize an empty queue inside region (shm_open + mmap with
+				MAP_SHARED). Called once, by the process which created it.
+				Elements are copied into the region, elem_size bytes each.
+* RETURN		status => 0 SUCCESS; non-zero value when region_size is too
+				small or the process-shared lock cannot be initialized.
+* IMPORTANT		The region must stay mapped while any process is attached.
+*
+* Time Complexity 	O(capacity)
+*******************************************************************************/
+int PQShmFormat(void *region, size_t region_size, size_t capacity, size_t elem_size);
+
+/*******************************************************************************
+* DESCRIPTION	Attach the calling process to a formatted region. The region
+				may be mapped at a different address in every process.
+				cmp_func_p must order the elements the same in all processes.
+* RETURN		NULL when memory allocation failed or region is not formatted.
+* IMPORTANT		User needs to free the handle (Use Detach func).
+				May run while another process formats the region: it returns
+				NULL until PQShmFormat is done, then sees the whole queue.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+pq_shm_ty *PQShmAttach(void *region, PQCmpFunc cmp_func_p, const void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Detach the calling process. The queue in the region is kept.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void PQShmDetach(pq_shm_ty *pq_shm);
+
+/*******************************************************************************
+* DESCRIPTION	Copy an element of elem_size bytes into the queue.
+* RETURN		status => 0 SUCCESS; non-zero value when the queue is full.
+
+* Time Complexity   O(log(pqueue_size))
+*******************************************************************************/
+int PQShmEnqueue(pq_shm_ty *pq_shm, const void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Remove the element with the highest priority and copy it to
+				out (out may be NULL).
+* RETURN		status => 0 SUCCESS; non-zero value when the queue is empty.
+* IMPORTANT		If a process dies in the middle of a dequeue, the element may
+				be delivered again after recovery (never lost).
+
+* Time Complexity   O(log(pqueue_size))
+*******************************************************************************/
+int PQShmDequeue(pq_shm_ty *pq_shm, void *out);
+
+/*******************************************************************************
+* DESCRIPTION	Copy the element with the highest priority to out.
+* RETURN		status => 0 SUCCESS; non-zero value when the queue is empty.
+
+* Time Complexity   O(1)
+*******************************************************************************/
+int PQShmPeek(pq_shm_ty *pq_shm, void *out);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements in the queue.
+
+* Time Complexity   O(1)
+*******************************************************************************/
+size_t PQShmSize(pq_shm_ty *pq_shm);
+
+
+#endif /* __PQ_SHM_H__ */
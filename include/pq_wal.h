@@ -0,0 +1,140 @@
+/*******************************************************************************
+************************** - DURABLE PRIORITY QUEUE - **************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of a write-ahead log wrapping a priority queue
+*	AUTHOR 			Liad Raz
+*	FILES			pq_wal.c pq_wal_test.c pq_wal.h
+*
+*******************************************************************************/
+
+#ifndef __PQ_WAL_H__
+#define __PQ_WAL_H__
+
+#include <stddef.h> 	/* size_t */
+
+#include "pqueue.h"
+
+typedef struct pq_wal pq_wal_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Status of PQWalEnqueue and PQWalSync.
+				PQ_WAL_NOT_DONE		  - the operation was not done; pqueue
+										and the log are unchanged
+				PQ_WAL_COMMIT_FAILED  - the records are kept in memory but are
+										not durable; PQWalSync retries them
+				PQ_WAL_COMPACT_FAILED - the records are durable; the snapshot
+										was not taken
+*******************************************************************************/
+typedef enum pq_wal_status
+{
+	PQ_WAL_SUCCESS = 0,
+	PQ_WAL_NOT_DONE,
+	PQ_WAL_COMMIT_FAILED,
+	PQ_WAL_COMPACT_FAILED
+} pq_wal_status_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Durability configuration.
+				path			 - files are <path>.log and <path>.snap
+				group_commit	 - the log is written and fsync'ed once per
+								   group_commit operations (0 behaves as 1)
+				compact_bytes	 - a snapshot is taken and the log truncated
+								   once the log grows past it (0 disables)
+				release_func_p	 - frees an element which was removed from
+								   the queue while the log was replayed;
+								   may be NULL
+*******************************************************************************/
+typedef struct pq_wal_cfg
+{
+	const char *path;
+	PQSerializeFunc serialize_func_p;
+	PQDeserializeFunc deserialize_func_p;
+	PQReleaseFunc release_func_p;
+	void *param;
+	size_t group_commit;
+	size_t compact_bytes;
+} pq_wal_cfg_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Open the log of pqueue. The last snapshot is loaded into pqueue
+				and the log is replayed on top of it. A torn record at the end
+				of the log (crash while writing) is dropped.
+* RETURN		NULL on I/O, format or memory allocation FAILURE.
+* IMPORTANT		pqueue must be empty; it stays owned by the user, and must
+				only be changed through the PQWal functions while open.
+*
+* Time Complexity 	O(snapshot_size + log_size)
+*******************************************************************************/
+pq_wal_ty *PQWalOpen(pqueue_ty *pqueue, const pq_wal_cfg_ty *cfg);
+
+/*******************************************************************************
+* DESCRIPTION	Commit pending operations and close the log. pqueue is kept.
+* RETURN		status => as PQWalSync
+
+* Time Complexity 	O(pending operations)
+*******************************************************************************/
+int PQWalClose(pq_wal_ty *wal);
+
+/*******************************************************************************
+* DESCRIPTION	PQueueEnqueue, logged. The record is made first: when it cannot
+				be, data is not enqueued.
+* RETURN		status => PQ_WAL_SUCCESS; PQ_WAL_NOT_DONE on memory allocation
+				FAILURE, for an image of 4 GiB or more, or while the log is
+				broken - data is not enqueued.
+				PQ_WAL_COMMIT_FAILED or PQ_WAL_COMPACT_FAILED when the group
+				commit it triggered failed - data is enqueued and logged.
+
+* Time Complexity   PQueueEnqueue + O(1) amortized
+*******************************************************************************/
+int PQWalEnqueue(pq_wal_ty *wal, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	PQueuePeek + PQueueDequeue, logged. The image of the element
+				identifies it when the log is replayed.
+* RETURN		The removed element; NULL when pqueue is empty, or when the
+				record could not be made - the element stays and the next
+				PQWalSync returns PQ_WAL_NOT_DONE.
+
+* Time Complexity   PQueueDequeue + O(1) amortized
+*******************************************************************************/
+void *PQWalDequeue(pq_wal_ty *wal);
+
+/*******************************************************************************
+* DESCRIPTION	PQueueErase, logged. The serialized image of the erased
+				element identifies it when the log is replayed.
+* RETURN		The erased element; NULL if not found, or when the record could
+				not be made - the element stays and the next PQWalSync returns
+				PQ_WAL_NOT_DONE.
+
+* Time Complexity   PQueueErase + O(1) amortized
+*******************************************************************************/
+void *PQWalErase(pq_wal_ty *wal, PQIsMatch match_func_p, void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Commit now: write pending records and fsync the log.
+				Operations are durable once committed. A failed write is cut
+				from the log, and the records stay pending for a retry.
+* RETURN		status => PQ_WAL_SUCCESS; PQ_WAL_COMMIT_FAILED on I/O FAILURE;
+				PQ_WAL_COMPACT_FAILED when committed but the compaction due 
+				failed; PQ_WAL_NOT_DONE when committed, but a PQWalDequeue or
+				PQWalErase since the last call was not done.
+* IMPORTANT		After a failed fsync, or a log which cannot be cut or reset,
+				the log is broken: every operation is refused until a 
+				PQWalCompact succeeds and starts a new one from pqueue.
+
+* Time Complexity   O(pending operations)
+*******************************************************************************/
+int PQWalSync(pq_wal_ty *wal);
+
+/*******************************************************************************
+* DESCRIPTION	Write a snapshot of pqueue and start an empty log. Pending
+				records are part of the snapshot; a broken log is replaced.
+* RETURN		status => 0 SUCCESS; non-zero value on I/O FAILURE
+
+* Time Complexity   O(pqueue_size)
+*******************************************************************************/
+int PQWalCompact(pq_wal_ty *wal);
+
+
+#endif /* __PQ_WAL_H__ */
@@ -0,0 +1,94 @@
+/*******************************************************************************
+************************ - SLIDING WINDOW PRIORITY QUEUE - *********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of Priority queue of elements with an expiry time
+*	AUTHOR 			Liad Raz
+*	FILES			pq_window.c pq_window_test.c pq_window.h
+*
+*******************************************************************************/
+
+#ifndef __PQ_WINDOW_H__
+#define __PQ_WINDOW_H__
+
+#include <stddef.h> 	/* size_t */
+
+#include "pqueue.h"
+
+/*******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct pq_window pq_window_ty;
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Creates a priority queue whose elements expire. Time is in any
+				unit of the user; an element is alive while now < its expiry.
+				Expired elements are passed to release_func_p (may be NULL).
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated container.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+pq_window_ty *PQWindowCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+								PQReleaseFunc release_func_p, void *release_param);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the queue; the elements left are passed to release_func_p.
+
+* Time Complexity 	O(n)
+*******************************************************************************/
+void PQWindowDestroy(pq_window_ty *window);
+
+/*******************************************************************************
+* DESCRIPTION	Add an element which expires at expiry.
+* RETURN		status => 0 SUCCESS; non-zero value on memory allocation FAILURE
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+int PQWindowEnqueue(pq_window_ty *window, void *data, unsigned long expiry);
+
+/*******************************************************************************
+* DESCRIPTION	Remove the elements expired by now, then get the top element.
+* RETURN		NULL when no element is alive.
+
+* Time Complexity 	O(log(n)) per expired element; O(1) otherwise
+*******************************************************************************/
+void *PQWindowPeek(pq_window_ty *window, unsigned long now);
+
+/*******************************************************************************
+* DESCRIPTION	Remove the top element, as returned by the last PQWindowPeek.
+				It passes back to the user and is not released.
+* IMPORTANT		Undefined behavior when window is empty.
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+void PQWindowDequeue(pq_window_ty *window);
+
+/*******************************************************************************
+* DESCRIPTION	Remove all the elements expired by now, in expiry order.
+* RETURN		Number of removed elements.
+
+* Time Complexity 	O(log(n)) per expired element
+*******************************************************************************/
+size_t PQWindowExpire(pq_window_ty *window, unsigned long now);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements, as of the last Peek or Expire.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t PQWindowSize(const pq_window_ty *window);
+
+/*******************************************************************************
+* DESCRIPTION	Checks if elements are stored, as of the last Peek or Expire.
+* RETURN		boolean => 	1 EMPTY; 0 NOT EMPTY.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+int PQWindowIsEmpty(const pq_window_ty *window);
+
+
+#endif /* __PQ_WINDOW_H__ */
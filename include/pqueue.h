@@ -12,6 +12,8 @@
 #ifndef __PQUEUE_H__
 #define __PQUEUE_H__
 
+#include <stddef.h> 	/* size_t */
+
 typedef struct pqueue pqueue_ty;
 
 /*******************************************************************************
@@ -30,6 +32,111 @@ typedef int (*PQCmpFunc)(const void *object1, const void *object2, const void *c
 *******************************************************************************/
 pqueue_ty *PQueueCreate(PQCmpFunc cmp_func_p, const void *cmp_param);
 
+/*******************************************************************************
+* DESCRIPTION	Used in PQueueSave and pq_config_ty. Write the element into buffer.
+* RETURN		Number of bytes the element needs. The element is written only
+				when it fits in buffer_size; otherwise Save calls again with a
+				bigger buffer.
+*******************************************************************************/
+typedef size_t (*PQSerializeFunc)(const void *data, void *buffer, 
+									size_t buffer_size, void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in PQueueLoad and pq_config_ty. Restore an element from
+				size bytes.
+* RETURN		The restored element; NULL on FAILURE.
+*******************************************************************************/
+typedef void *(*PQDeserializeFunc)(const void *buffer, size_t size, void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in pq_config_ty, to free an element owned by the queue, and
+				in PQueueEraseIf, to receive a removed element.
+*******************************************************************************/
+typedef void (*PQReleaseFunc)(void *data, void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Storage engines, used in pq_config_ty.
+				PQ_ENGINE_LIST	- sorted list of pointers (PQueueCreate).
+				PQ_ENGINE_MMAP	- array heap with inline elements, stored in
+								  a memory mapped file. Survives restarts.
+								  Enqueue and Dequeue in O(log(pqueue_size)).
+				PQ_ENGINE_EXTERNAL - in memory heap of up to capacity elements;
+								  when full it is written to a temporary file
+								  as a sorted run. Peek and Dequeue merge the
+								  heap with the heads of the runs. For queues
+								  bigger than memory.
+								  Runs are kept in levels: 16 runs of a level
+								  are merged into one run of the next, so each
+								  element is written about
+								  1 + log16(pqueue_size / capacity) times and
+								  at most 16 run heads per level are in memory.
+				PQ_ENGINE_HEAP	- binary heap of pointers. Enqueue and Dequeue
+								  in O(log(pqueue_size)).
+				PQ_ENGINE_SEQHEAP - sequence heap of pointers: a small insertion
+								  heap, groups of sorted sequences merged by
+								  loser trees. For very big queues in memory;
+								  the work is mostly sequential scans.
+*******************************************************************************/
+typedef enum pq_engine
+{
+	PQ_ENGINE_LIST = 0,
+	PQ_ENGINE_MMAP,
+	PQ_ENGINE_EXTERNAL,
+	PQ_ENGINE_HEAP,
+	PQ_ENGINE_SEQHEAP
+} pq_engine_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in PQueueCreateEx. Fields not used by an engine are ignored.
+				path		- file of PQ_ENGINE_MMAP. An existing file is
+							  reopened as is; otherwise it is created.
+							  Directory of the runs of PQ_ENGINE_EXTERNAL;
+							  NULL uses the system temporary directory.
+				elem_size	- bytes copied per element (PQ_ENGINE_MMAP); 0 takes
+							  the size stored in an existing file.
+				capacity	- initial number of elements (PQ_ENGINE_MMAP); the
+							  file grows when it is full.
+							  Elements kept in memory (PQ_ENGINE_EXTERNAL).
+				serialize_func_p, deserialize_func_p, release_func_p, io_param
+							- write, read back and free the elements of
+							  PQ_ENGINE_EXTERNAL; release_func_p may be NULL.
+*******************************************************************************/
+typedef struct pq_config
+{
+	pq_engine_ty engine;
+	const char *path;
+	size_t elem_size;
+	size_t capacity;
+	PQSerializeFunc serialize_func_p;
+	PQDeserializeFunc deserialize_func_p;
+	PQReleaseFunc release_func_p;
+	void *io_param;
+} pq_config_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Creates pqueue container over the engine in config.
+				config NULL behaves as PQueueCreate.
+* RETURN		NULL on memory allocation, I/O or file format FAILURE.
+* IMPORTANT		PQ_ENGINE_MMAP stores copies of the elements:
+				Enqueue copies elem_size bytes from data, Peek returns a
+				pointer into the file and Erase a copy; both are valid until
+				the next call on pqueue. PQueueLoad is not supported.
+				PQueueDestroy syncs the file and keeps it; reopening it maps the
+				heap as is, without reading or comparing the elements.
+				PQ_ENGINE_EXTERNAL owns the elements: Enqueue passes data to
+				pqueue, Peek + Dequeue (or Erase) pass it back to the user.
+				A written element is released and later comes back as a new
+				element made by deserialize_func_p. Clear and Destroy release
+				the elements left. Erase finds only elements in memory.
+				A run which cannot be read back is kept, not dropped; the
+				failure is reported by PQueueError.
+				PQueueSave and PQueueLoad are not supported.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+pqueue_ty *PQueueCreateEx(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config);
+
 /*******************************************************************************
 * DESCRIPTION	Free priority pqueue.
 		
@@ -45,6 +152,35 @@ void PQueueDestroy(pqueue_ty *pqueue);
 *******************************************************************************/
 int PQueueEnqueue(pqueue_ty *pqueue, void *data);
 
+/*******************************************************************************
+* DESCRIPTION	Add a batch of elements in one step (sort, then a single merge).
+* RETURN		Number of elements added. Less than n on memory allocation 
+				failure; in that case items[ret..n) are the ones not added.
+* IMPORTANT		The order of the items array is changed.
+	
+* Time Complexity   O(n * log(n) + pqueue_size)
+*******************************************************************************/
+size_t PQueueEnqueueBatch(pqueue_ty *pqueue, void **items, size_t n);
+
+/*******************************************************************************
+* DESCRIPTION	Add a big batch of elements, sorted on up to nthreads threads:
+				each sorts a chunk of items, then pairs of chunks are merged
+				in parallel. Into an empty pqueue the sorted items are then
+				appended without comparisons; into a PQ_ENGINE_LIST which is
+				not empty they are merged without sorting again. Otherwise
+				the items are not sorted first and it behaves as
+				PQueueEnqueueBatch. Below 4096 items per thread fewer threads
+				are used; with one left it behaves as PQueueEnqueueBatch.
+* RETURN		Number of elements added. Less than n on memory allocation 
+				failure; in that case items[ret..n) are the ones not added.
+* IMPORTANT		The order of the items array is changed. The comparison
+				function is called from several threads at once.
+	
+* Time Complexity   O(n * log(n) / nthreads + n) on an empty pqueue
+*******************************************************************************/
+size_t PQueueEnqueueBulkParallel(pqueue_ty *pqueue, void **items, size_t n, 
+									size_t nthreads);
+
 /*******************************************************************************		
 * DESCRIPTION	Remove element from priority pqueue and frees it from memory.
 
@@ -74,6 +210,20 @@ int PQueueIsEmpty(const pqueue_ty *pqueue);
 *******************************************************************************/
 size_t PQueueSize(const pqueue_ty *pqueue);
 
+/*******************************************************************************
+* DESCRIPTION	Checks if a PQ_ENGINE_EXTERNAL run could not be read back.
+				The records of such a run are kept and counted by PQueueSize,
+				but they are out of the merge: Peek and Dequeue skip them, and
+				return NULL / remove nothing when only they are left. The read
+				is retried on every Enqueue, Dequeue and Erase; once it works
+				they come back, possibly after bigger elements were dequeued.
+* RETURN		boolean => 1 a read failed since the last PQueueClear; 0 NO
+				FAILURE. Always 0 on the other engines.
+		
+* Time Complexity   O(1)
+*******************************************************************************/
+int PQueueError(const pqueue_ty *pqueue);
+
 /*******************************************************************************
 * DESCRIPTION	Remove all elements in pqueue.
 		
@@ -96,6 +246,104 @@ typedef int (*PQIsMatch)(const void *element_data, const void *param);
 *******************************************************************************/
 void *PQueueErase(pqueue_ty *pqueue, PQIsMatch match_func_p, void *cmp_param);
 
+/*******************************************************************************
+* DESCRIPTION	Remove every element that matches, in a single pass. Each one
+				is passed to out_func_p (may be NULL) with param.
+* RETURN		Number of removed elements.
+* IMPORTANT		out_func_p must not use pqueue.
+	
+* Time Complexity   O(pqueue_size) on PQ_ENGINE_LIST, PQ_ENGINE_HEAP and
+					PQ_ENGINE_SEQHEAP; O(pqueue_size * removed) on the others
+*******************************************************************************/
+size_t PQueueEraseIf(pqueue_ty *pqueue, PQIsMatch match_func_p, void *param,
+						PQReleaseFunc out_func_p);
+
+/*******************************************************************************
+* DESCRIPTION	Replace the parameter of the comparison function, and restore
+				the priority order of the elements already stored. The
+				elements are not copied or reallocated.
+* RETURN		status => 0 SUCCESS; 1 when the engine does not support it
+				(PQ_ENGINE_SEQHEAP, PQ_ENGINE_EXTERNAL).
+	
+* Time Complexity   O(pqueue_size) on the array engines; 
+					O(pqueue_size * log(sorted_runs)) on PQ_ENGINE_LIST
+*******************************************************************************/
+int PQueueSetCmpParam(pqueue_ty *pqueue, const void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in PQueueSetKeyIndex. Obtain the key of an element.
+*******************************************************************************/
+typedef const void *(*PQKeyFunc)(const void *data, void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Used in PQueueSetKeyIndex. Hash of a key; equal keys must have
+				equal hashes.
+*******************************************************************************/
+typedef size_t (*PQHashFunc)(const void *key, void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Keep a hash index from the key of each element to its place in
+				the engine, for PQueueEraseKey and PQueueContains.
+				match_func_p(element_data, key) tells if element_data has key.
+* RETURN		status => 0 SUCCESS; non-zero value on memory allocation
+				FAILURE or when the engine does not support it (only
+				PQ_ENGINE_LIST and PQ_ENGINE_HEAP do).
+* IMPORTANT		pqueue must be empty. While the index is kept, an element
+				(the same pointer) may be in pqueue only once. Dequeue does
+				not read the element, so it may be freed after Peek.
+	
+* Time Complexity   O(1)
+*******************************************************************************/
+int PQueueSetKeyIndex(pqueue_ty *pqueue, PQKeyFunc key_func_p, 
+						PQHashFunc hash_func_p, PQIsMatch match_func_p, 
+						void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Remove an element with key. When several have it, one of them.
+* RETURN		The element; NULL if key is not found.
+* IMPORTANT		Needs PQueueSetKeyIndex.
+	
+* Time Complexity   O(1) expected on PQ_ENGINE_LIST; 
+					O(log(pqueue_size)) on PQ_ENGINE_HEAP
+*******************************************************************************/
+void *PQueueEraseKey(pqueue_ty *pqueue, const void *key);
+
+/*******************************************************************************
+* DESCRIPTION	Checks if an element with key is in pqueue.
+* RETURN		boolean => 1 FOUND;	0 NOT_FOUND
+* IMPORTANT		Needs PQueueSetKeyIndex.
+	
+* Time Complexity   O(1) expected
+*******************************************************************************/
+int PQueueContains(const pqueue_ty *pqueue, const void *key);
+
+
+/*******************************************************************************
+* DESCRIPTION	Write a snapshot of pqueue to fd, in priority order. 
+				Format: magic, element count, then a 32 bit length prefixed
+				record per element (little endian).
+* RETURN		status => 0 SUCCESS; non-zero value on I/O or allocation FAILURE,
+				on a record of 4 GiB or more, or when serialize_func_p needs
+				more than it asked for once given the bigger buffer.
+* IMPORTANT		fd is written from its current offset and is not closed.
+	
+* Time Complexity   O(pqueue_size)
+*******************************************************************************/
+int PQueueSave(pqueue_ty *pqueue, int fd, PQSerializeFunc serialize_func_p, 
+				void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Rebuild pqueue from a snapshot written by PQueueSave, in a 
+				single streaming pass without comparing elements.
+* RETURN		status => 0 SUCCESS; non-zero value on I/O, format or 
+				allocation FAILURE. Elements loaded before a failure are kept.
+* IMPORTANT		pqueue must be empty and use the comparison of the snapshot.
+	
+* Time Complexity   O(pqueue_size)
+*******************************************************************************/
+int PQueueLoad(pqueue_ty *pqueue, int fd, PQDeserializeFunc deserialize_func_p, 
+				void *param);
+
 
 #endif /* __PQUEUE_H__ */
 
@@ -0,0 +1,83 @@
+/*******************************************************************************
+******************************* - QUANTILE - **********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of Running quantile (median) tracker
+*	AUTHOR 			Liad Raz
+*	FILES			quantile.c quantile_test.c quantile.h
+*
+*******************************************************************************/
+
+#ifndef __QUANTILE_H__
+#define __QUANTILE_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct quantile quantile_ty;
+typedef struct quantile_handle quantile_handle_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in Create
+* RETURN		0 SUCCESS; POSITIVE value obj1 > obj2; NEGATIVE value obj1 < obj2
+*******************************************************************************/
+typedef int (*QuantileCmpFunc)(const void *object1, const void *object2, const void *cmp_param);
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Creates a tracker of the q quantile (0 <= q <= 1; 0.5 is the
+				median). Of n elements, the one of rank floor(q * (n - 1))
+				(from 0, smallest first) is tracked - the lower median for
+				an even n.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated container.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+quantile_ty *QuantileCreate(double q, QuantileCmpFunc cmp_func_p, const void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the tracker and the handles; the elements are not freed.
+
+* Time Complexity 	O(n)
+*******************************************************************************/
+void QuantileDestroy(quantile_ty *tracker);
+
+/*******************************************************************************
+* DESCRIPTION	Add an element.
+* RETURN		Handle of the element, valid until it is removed;
+				NULL on memory allocation FAILURE.
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+quantile_handle_ty *QuantileInsert(quantile_ty *tracker, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Remove an element by its handle, e.g. when it leaves a window.
+* RETURN		The element.
+
+* Time Complexity 	O(log(n))
+*******************************************************************************/
+void *QuantileRemove(quantile_ty *tracker, quantile_handle_ty *handle);
+
+/*******************************************************************************
+* DESCRIPTION	Get the element at the quantile.
+* RETURN		NULL when tracker is empty.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void *QuantileGet(const quantile_ty *tracker);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t QuantileSize(const quantile_ty *tracker);
+
+
+#endif /* __QUANTILE_H__ */
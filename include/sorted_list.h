@@ -42,16 +42,45 @@ typedef int (*CmpFunc)(const void *object1, const void *object2, const void *cmp
 *******************************************************************************/
 sortl_ty *SortLCreate(CmpFunc p_cmp_func, const void *cmp_param);
 
+/*******************************************************************************
+* DESCRIPTION	Creates a sorted list of the n items, in any order, without
+				a search per element: a copy of items is merge sorted and
+				the nodes are linked in order. The items array is not changed.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT	 	User needs to free the allocated container.
+				Equal elements keep the order of items.
+
+* Time Complexity 	O(n * log(n))
+*******************************************************************************/
+sortl_ty *SortLCreateFromArray(CmpFunc cmp_func_p, const void *cmp_param, 
+								void **items, size_t n);
+
 
 /*******************************************************************************
-* DESCRIPTION	Add and sort a new element to a relevant position.
+* DESCRIPTION	Add and sort a new element to a relevant position. The search
+				starts at the last insertion (at the end before any; next to
+				it once it is removed), so elements arriving in about sorted
+				order cost O(1) each, and so does a new first element.
 * RETURN		On failure return iterator to end of range
 	
-* Time Complexity 	O(number_of_elements) 
+* Time Complexity 	O(distance from the last insertion); at most 
+					O(log(number_of_elements)) expected with the skip index
 *******************************************************************************/
 sortl_itr_ty SortLInsert(sortl_ty *list, void *data);
 
 
+/*******************************************************************************
+* DESCRIPTION	Add and sort a new element, searching from hint in the 
+				direction of data. hint may be any iterator of list, or its 
+				end.
+* RETURN		On failure return iterator to end of range
+	
+* Time Complexity 	O(distance from hint); at most O(log(number_of_elements))
+					expected with the skip index
+*******************************************************************************/
+sortl_itr_ty SortLInsertHint(sortl_ty *list, sortl_itr_ty hint, void *data);
+
+
 /*******************************************************************************
 * DESCRIPTION	Get data of a specific element.
 * IMPORTANT		Undefined behavior when iterator is out of list range.
@@ -129,23 +158,149 @@ int SortLIsSameIter(sortl_itr_ty iter1, sortl_itr_ty iter2);
 
 /*******************************************************************************
 * DESCRIPTION	Merge elements from donor list and sort them in dest.
+				The nodes move, donor is left empty; on ties dest elements
+				stay first. Long runs from one list are found by galloping.
 * IMPORTANT:	Undefined behavior
 *				- when lists are not exist.
+*				- when lists do not use the same order (dest's is used).
 *
-* Time Complexity 	O(n + m) 
+* Time Complexity 	O(n + m) steps; comparisons O(n + m), down to O(r log 
+					((n + m) / r)) for r interleaved runs
 *******************************************************************************/
 void SortLMerge(sortl_ty *dest, sortl_ty *donor);
 
 
+/*******************************************************************************
+* DESCRIPTION	Add an element at the end of the list without any comparison.
+				Used to rebuild a list from data which is already sorted.
+* RETURN		On failure return iterator to end of range
+* IMPORTANT:	Undefined behavior when data is smaller than the last element
+				(checked in debug mode).
+*
+* Time Complexity 	O(1) 
+*******************************************************************************/
+sortl_itr_ty SortLAppend(sortl_ty *list, void *data);
+
+
+/*******************************************************************************
+* DESCRIPTION	Add a batch of elements in one step. The items array is sorted 
+				in place and then merged into the list in a single pass.
+* RETURN		Number of elements added. Less than n on memory allocation 
+				failure; in that case items[ret..n) are the ones not added.
+* IMPORTANT:	Equal elements are placed after the ones already in the list.
+*
+* Time Complexity 	O(n * log(n) + number_of_elements); O(n + number_of_elements)
+					when items are already in order
+*******************************************************************************/
+size_t SortLInsertBatch(sortl_ty *list, void **items, size_t n);
+
+
+/*******************************************************************************
+* DESCRIPTION	As SortLInsertBatch, for items which are already in priority
+				order: they are merged into the list without sorting.
+* RETURN		Number of elements added. Less than n on memory allocation 
+				failure; in that case items[ret..n) are the ones not added.
+* IMPORTANT:	Undefined behavior when items are not in order (checked in
+				debug mode). Equal elements are placed after the ones already
+				in the list.
+*
+* Time Complexity 	O(n + number_of_elements)
+*******************************************************************************/
+size_t SortLInsertSorted(sortl_ty *list, void **items, size_t n);
+
+
+/*******************************************************************************
+* DESCRIPTION	Move the nodes of dlist, in any order, into list and sort them
+				in place by merging the sorted runs. dlist is left empty and
+				still belongs to the user. Iterators of dlist to the moved
+				elements are valid dlist iterators of the list.
+* IMPORTANT:	Equal elements keep their order; the ones already in the list
+				go first.
+*
+* Time Complexity 	O((n + m) * log(number_of_sorted_runs))
+*******************************************************************************/
+void SortLAdopt(sortl_ty *list, dlist_ty *dlist);
+
+
+/*******************************************************************************
+* DESCRIPTION	Replace the parameter of the comparison function and sort the
+				list again. Nodes are relinked, not reallocated: the elements
+				and the iterators to them stay valid.
+* IMPORTANT:	Equal elements keep their order.
+*
+* Time Complexity 	O(n * log(number_of_sorted_runs)); O(n) when still sorted
+*******************************************************************************/
+void SortLSetCmpParam(sortl_ty *list, const void *cmp_param);
+
+
+/*******************************************************************************
+* DESCRIPTION	Build (is_enabled) or free a skip index over the elements. With
+				it Insert, Find and Remove do not walk the list from its begin;
+				a quarter of the elements keep an extra tower of pointers.
+				Iterators are not affected.
+* RETURN		status => 0 SUCCESS; 1 on memory allocation FAILURE, the list
+				stays without index.
+* IMPORTANT:	Merge, InsertBatch and SetCmpParam rebuild the index: O(n).
+*
+* Time Complexity 	O(n) 
+*******************************************************************************/
+int SortLSetSkipIndex(sortl_ty *list, int is_enabled);
+
+
 /*******************************************************************************
 * DESCRIPTION	Match element's data in list with data provided by the user.
 * RETURN		Iterator to the first found; If not found iterator to the end.
 
-* Time Complexity 	O(n) 
+* Time Complexity 	O(log(n)) expected with the skip index; O(n) otherwise
 *******************************************************************************/
 sortl_itr_ty SortLFind(const sortl_ty *list, const void *data);
 
 
+/*******************************************************************************
+* DESCRIPTION	Find the first element which is not smaller than data.
+* RETURN		Iterator to it; the end when all the elements are smaller.
+
+* Time Complexity 	O(log(n)) expected with the skip index; O(n) otherwise
+*******************************************************************************/
+sortl_itr_ty SortLLowerBound(const sortl_ty *list, const void *data);
+
+
+/*******************************************************************************
+* DESCRIPTION	Find the first element which is bigger than data.
+* RETURN		Iterator to it; the end when no element is bigger.
+
+* Time Complexity 	O(log(n)) expected with the skip index; O(n) otherwise
+*******************************************************************************/
+sortl_itr_ty SortLUpperBound(const sortl_ty *list, const void *data);
+
+
+/*******************************************************************************
+* DESCRIPTION	Find the range [from, to) of the elements equal to data: the
+				lower and the upper bounds. Empty (from is to) when data is
+				not in list.
+
+* Time Complexity 	O(log(n) + equal elements) expected with the skip index;
+					O(n) otherwise
+*******************************************************************************/
+void SortLEqualRange(const sortl_ty *list, const void *data, 
+						sortl_itr_ty *from, sortl_itr_ty *to);
+
+
+/*******************************************************************************
+* DESCRIPTION	Move the elements [from, to) of list to the end of out_list.
+				The nodes are relinked, not copied.
+* IMPORTANT:	Undefined behavior 
+				- when out_list is not sorted by the same comparison, or has
+				an element bigger than the range (checked in debug mode).
+				- when from is after to.
+				Iterators to the moved elements are invalidated.
+*
+* Time Complexity 	O(1); O(log(n) + range) when a list has the skip index
+*******************************************************************************/
+void SortLExtractRange(sortl_ty *list, sortl_itr_ty from, sortl_itr_ty to, 
+						sortl_ty *out_list);
+
+
 /*******************************************************************************
 * DESCRIPTION	Checks the existence of elements in the sorted list.
 * RETURN 		boolean => 1 IS_EMPTY;	0 NOT_EMPTY
@@ -159,8 +314,11 @@ int SortLIsEmpty(const sortl_ty *list);
 * DESCRIPTION	Remove element from sort list and frees it from memory.
 * RETURN		An iterator to the following item which has been removed.
 * IMPORTANT		The original iterator will be invalidate.
+				With the skip index the element is compared to find its 
+				tower: it must still be valid.
 				
-* Time Complexity 	O(number_of_elements) 
+* Time Complexity 	O(log(number_of_elements)) expected with the skip index;
+					O(1) otherwise
 *******************************************************************************/
 sortl_itr_ty SortLRemove(sortl_itr_ty iter);
 
@@ -185,6 +343,7 @@ sortl_itr_ty SortLFindIf(sortl_itr_ty from, sortl_itr_ty to, IsMatchFunc is_matc
 struct sortl_itr 
 {
     dlist_itr_ty dlist_itr;
+    sortl_ty *sortl;
 };
 
 
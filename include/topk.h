@@ -0,0 +1,95 @@
+/*******************************************************************************
+********************************* - TOP K - ***********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of Streaming top-K accumulator
+*	AUTHOR 			Liad Raz
+*	FILES			topk.c topk_test.c topk.h
+*
+*******************************************************************************/
+
+#ifndef __TOPK_H__
+#define __TOPK_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct topk topk_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in Create
+* RETURN		0 SUCCESS; POSITIVE value obj1 > obj2; NEGATIVE value obj1 < obj2
+*******************************************************************************/
+typedef int (*TopKCmpFunc)(const void *object1, const void *object2, const void *cmp_param);
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Creates an accumulator of the k biggest items offered.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated container. All the memory is
+				allocated here; offers never allocate.
+
+* Time Complexity 	O(k)
+*******************************************************************************/
+topk_ty *TopKCreate(size_t k, TopKCmpFunc cmp_func_p, const void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the accumulator; the items are not freed.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void TopKDestroy(topk_ty *tk);
+
+/*******************************************************************************
+* DESCRIPTION	Offer an item. Once k items are kept, an item not bigger than
+				the smallest kept one (the threshold) is rejected with a single
+				comparison; a bigger one takes the place of the threshold.
+				Among equal items the earlier ones are kept.
+* RETURN		The item which is not kept: item itself, or the evicted one.
+				NULL when item is kept and nothing is evicted.
+
+* Time Complexity 	O(1) rejected; O(log(k)) kept
+*******************************************************************************/
+void *TopKOffer(topk_ty *tk, void *item);
+
+/*******************************************************************************
+* DESCRIPTION	Offer n items. Items are filtered against the current threshold
+				before the heap is touched.
+* RETURN		Number of items not kept (rejected or evicted); they are moved
+				to the start of items, so that user may free them.
+
+* Time Complexity 	O(n) rejected; O(log(k)) per kept item
+*******************************************************************************/
+size_t TopKOfferBatch(topk_ty *tk, void **items, size_t n);
+
+/*******************************************************************************
+* DESCRIPTION	Write the kept items into out, biggest first. The accumulator
+				is not changed.
+* RETURN		Number of items written (up to k).
+* IMPORTANT		out must hold k items.
+
+* Time Complexity 	O(k * log(k))
+*******************************************************************************/
+size_t TopKResult(topk_ty *tk, void **out);
+
+/*******************************************************************************
+* DESCRIPTION	Get the smallest kept item once k items are kept.
+* RETURN		NULL while fewer than k items are kept.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void *TopKThreshold(const topk_ty *tk);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of kept items.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t TopKSize(const topk_ty *tk);
+
+
+#endif /* __TOPK_H__ */
@@ -109,6 +109,16 @@
 						else 													\
 						{ RED; PRINT_STATUS_MSG(Not function_name); DEFAULT;}
 
+/* Prints the result of a test and counts it in failures when it failed */
+#define PRINT_TEST_RESULT(is_ok, test_name, failures)							\
+						do {													\
+						if (is_ok)												\
+						{ GREEN; printf("\t%s: SUCCESS\n", test_name); DEFAULT; }	\
+						else													\
+						{ RED; printf("\t%s: FAILED\n", test_name); DEFAULT;		\
+						++(failures); }											\
+						} while (0)
+
 
 /******************************************************************************/
 							/* Typedef */
@@ -0,0 +1,86 @@
+/*******************************************************************************
+************************ - WEIGHTED FAIR QUEUING - *****************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		API of Weighted fair queuing across tenants
+*	AUTHOR 			Liad Raz
+*	FILES			wfq.c wfq_test.c wfq.h
+*
+*******************************************************************************/
+
+#ifndef __WFQ_H__
+#define __WFQ_H__
+
+#include <stddef.h> 	/* size_t */
+
+#include "pqueue.h"
+
+/*******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct wfq wfq_ty;
+
+
+/*******************************************************************************
+**************************** Function declarations*****************************/
+
+/*******************************************************************************
+* DESCRIPTION	Creates a scheduler of num_tenants tenants (0 to num_tenants - 1),
+				each with a queue ordered by cmp_func_p and a weight of 1.
+				Tenants are served in proportion to their weights: each
+				element carries a cost, and the tenant whose next element
+				finishes first in virtual time is served next.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated container.
+
+* Time Complexity 	O(num_tenants)
+*******************************************************************************/
+wfq_ty *WFQCreate(size_t num_tenants, PQCmpFunc cmp_func_p, const void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the scheduler; the elements are not freed.
+
+* Time Complexity 	O(n)
+*******************************************************************************/
+void WFQDestroy(wfq_ty *wfq);
+
+/*******************************************************************************
+* DESCRIPTION	Set the weight of tenant (bigger than 0). Applies to the
+				elements served from now on.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+void WFQSetWeight(wfq_ty *wfq, size_t tenant, unsigned int weight);
+
+/*******************************************************************************
+* DESCRIPTION	Add an element of the given cost (e.g. its size) to tenant.
+				An idle tenant starts at the current virtual time, so it
+				neither lost nor saved any share while idle.
+				Any cost is accepted, but an element counts for at most
+				ULONG_MAX / 2 of virtual time (about 2^47 * weight cost
+				with a 64-bit long, 2^15 * weight with a 32-bit one);
+				costlier ones are served as if they were that cheap.
+* RETURN		status => 0 SUCCESS; non-zero value on memory allocation FAILURE
+
+* Time Complexity 	O(log(tenant size) + log(num_tenants))
+*******************************************************************************/
+int WFQEnqueue(wfq_ty *wfq, size_t tenant, void *data, unsigned long cost);
+
+/*******************************************************************************
+* DESCRIPTION	Remove the next element to serve.
+* RETURN		The element; NULL when no tenant has elements.
+				tenant_out (may be NULL) receives its tenant.
+
+* Time Complexity 	O(log(tenant size) + log(num_tenants))
+*******************************************************************************/
+void *WFQDequeue(wfq_ty *wfq, size_t *tenant_out);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements of all the tenants, or of one.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t WFQSize(const wfq_ty *wfq);
+size_t WFQTenantSize(const wfq_ty *wfq, size_t tenant);
+
+
+#endif /* __WFQ_H__ */
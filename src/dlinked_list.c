@@ -272,6 +272,8 @@ dlist_itr_ty DListFind(dlist_itr_ty from, dlist_itr_ty to, IsMatchFunc match_fun
 	}	
 
 	ret_itr.to_node = end_of_range;
+	DEBUG_MODE(ret_itr.dlist = to.dlist);
+	
 	return ret_itr;
 }
 
@@ -0,0 +1,314 @@
+/*******************************************************************************
+*************************** - EDF SCHEDULER - *********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of Earliest deadline first scheduler
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+#include <limits.h>			/* CHAR_BIT */
+
+#include "utilities.h"
+#include "pqueue.h"
+#include "edf.h"
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "EDF scheduler is not allocated");
+
+#define HALF_BITS (sizeof(unsigned long) * CHAR_BIT / 2)
+#define LOW_HALF_MASK ((1UL << HALF_BITS) - 1)
+
+/* Aging without touching the queue: the priority of a task at time t is
+	deadline - aging * (t - submitted). The term aging * t is the same for
+	every task, so the order is that of deadline + aging * submitted - a
+	key fixed at submission. The global offset aging * now enters the key
+	of each new task instead of being subtracted from all the old ones.
+	deadline * 100 + aging * now needs up to two words, so the key is kept
+	in two and never wraps around.									*/
+typedef struct edf_key
+{
+	unsigned long high;
+	unsigned long low;
+} edf_key_ty;
+
+struct edf_task
+{
+	void *data;
+	unsigned long deadline;
+	unsigned long budget;
+	edf_key_ty key;				/* in 1/100 units */
+	unsigned long seq;			/* submission order, for ties */
+};
+
+struct edf
+{
+	pqueue_ty *pqueue;
+	unsigned int aging_percent;
+	unsigned long next_seq;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int CmpTasksImp(const void *task1, const void *task2, const void *param);
+static int IsSameTaskImp(const void *element_data, const void *param);
+static const void *TaskKeyImp(const void *data, void *param);
+static size_t HashTaskImp(const void *key, void *param);
+static edf_key_ty MulWideImp(unsigned long a, unsigned long b);
+static edf_key_ty AddWideImp(edf_key_ty a, edf_key_ty b);
+
+/*******************************************************************************
+***************************** EDF Create **************************************/
+edf_ty *EDFCreate(unsigned int aging_percent)
+{
+	pq_config_ty config = {PQ_ENGINE_HEAP, NULL, 0, 0, NULL, NULL, NULL, NULL};
+	edf_ty *sched = NULL;
+
+	sched = (edf_ty *)malloc(sizeof(edf_ty));
+
+	if (NULL == sched)
+	{
+		return NULL;
+	}
+
+	sched->pqueue = PQueueCreateEx(CmpTasksImp, NULL, &config);
+
+	if (NULL == sched->pqueue)
+	{
+		free(sched);
+		return NULL;
+	}
+
+	/* the task is its own key - Cancel finds it without a scan */
+	if (0 != PQueueSetKeyIndex(sched->pqueue, TaskKeyImp, HashTaskImp, 
+								IsSameTaskImp, NULL))
+	{
+		PQueueDestroy(sched->pqueue);
+		free(sched);
+		return NULL;
+	}
+
+	sched->aging_percent = aging_percent;
+	sched->next_seq = 0;
+
+	return sched;
+}
+
+/*******************************************************************************
+***************************** EDF Destroy *************************************/
+void EDFDestroy(edf_ty *sched)
+{
+	edf_task_ty *task = NULL;
+
+	ASSERT_NOT_NULL_IMP(sched);
+
+	while (!PQueueIsEmpty(sched->pqueue))
+	{
+		task = (edf_task_ty *)PQueuePeek(sched->pqueue);
+		PQueueDequeue(sched->pqueue);
+		free(task);
+	}
+
+	PQueueDestroy(sched->pqueue);
+
+	DEBUG_MODE
+	(
+		sched->pqueue = INVALID_PTR;
+	)
+	free(sched);
+}
+
+/*******************************************************************************
+***************************** EDF Submit **************************************/
+edf_task_ty *EDFSubmit(edf_ty *sched, void *data, unsigned long deadline,
+						unsigned long budget, unsigned long now)
+{
+	edf_task_ty *task = NULL;
+
+	ASSERT_NOT_NULL_IMP(sched);
+
+	task = (edf_task_ty *)malloc(sizeof(edf_task_ty));
+
+	if (NULL == task)
+	{
+		return NULL;
+	}
+
+	task->data = data;
+	task->deadline = deadline;
+	task->budget = budget;
+	task->key = AddWideImp(MulWideImp(deadline, 100),
+						   MulWideImp(sched->aging_percent, now));
+	task->seq = sched->next_seq;
+
+	if (0 != PQueueEnqueue(sched->pqueue, task))
+	{
+		free(task);
+		return NULL;
+	}
+
+	++sched->next_seq;
+
+	return task;
+}
+
+/*******************************************************************************
+***************************** EDF Next ****************************************/
+edf_task_ty *EDFNext(const edf_ty *sched)
+{
+	ASSERT_NOT_NULL_IMP(sched);
+
+	return (edf_task_ty *)PQueuePeek(sched->pqueue);
+}
+
+/*******************************************************************************
+***************************** EDF Charge **************************************/
+void *EDFCharge(edf_ty *sched, unsigned long used)
+{
+	edf_task_ty *task = NULL;
+	void *data = NULL;
+
+	ASSERT_NOT_NULL_IMP(sched);
+	assert (!PQueueIsEmpty(sched->pqueue) && "EDFCharge: scheduler is empty");
+
+	/* the key does not depend on the budget - no reordering */
+	task = (edf_task_ty *)PQueuePeek(sched->pqueue);
+
+	if (used < task->budget)
+	{
+		task->budget -= used;
+		return NULL;
+	}
+
+	PQueueDequeue(sched->pqueue);
+	data = task->data;
+	free(task);
+
+	return data;
+}
+
+/*******************************************************************************
+***************************** EDF Cancel **************************************/
+void *EDFCancel(edf_ty *sched, edf_task_ty *task)
+{
+	void *data = NULL;
+
+	ASSERT_NOT_NULL_IMP(sched);
+	assert (NULL != task && "EDFCancel: task is invalid");
+
+	task = (edf_task_ty *)PQueueEraseKey(sched->pqueue, task);
+	assert (NULL != task && "EDFCancel: task is not scheduled");
+
+	data = task->data;
+	free(task);
+
+	return data;
+}
+
+/*******************************************************************************
+***************************** EDF Size ****************************************/
+size_t EDFSize(const edf_ty *sched)
+{
+	ASSERT_NOT_NULL_IMP(sched);
+
+	return PQueueSize(sched->pqueue);
+}
+
+/*******************************************************************************
+***************************** EDF Task Fields *********************************/
+void *EDFTaskData(const edf_task_ty *task)
+{
+	assert (NULL != task && "EDFTaskData: task is invalid");
+
+	return task->data;
+}
+
+unsigned long EDFTaskDeadline(const edf_task_ty *task)
+{
+	assert (NULL != task && "EDFTaskDeadline: task is invalid");
+
+	return task->deadline;
+}
+
+unsigned long EDFTaskBudget(const edf_task_ty *task)
+{
+	assert (NULL != task && "EDFTaskBudget: task is invalid");
+
+	return task->budget;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int CmpTasksImp(const void *task1, const void *task2, const void *param)
+{
+	const edf_task_ty *t1 = (const edf_task_ty *)task1;
+	const edf_task_ty *t2 = (const edf_task_ty *)task2;
+
+	UNUSED(param);
+
+	if (t1->key.high != t2->key.high)
+	{
+		return (t1->key.high > t2->key.high) ? 1 : -1;
+	}
+
+	if (t1->key.low != t2->key.low)
+	{
+		return (t1->key.low > t2->key.low) ? 1 : -1;
+	}
+
+	return (t1->seq > t2->seq) - (t1->seq < t2->seq);
+}
+
+static int IsSameTaskImp(const void *element_data, const void *param)
+{
+	return (element_data == param);
+}
+
+static const void *TaskKeyImp(const void *data, void *param)
+{
+	UNUSED(param);
+
+	return data;
+}
+
+static size_t HashTaskImp(const void *key, void *param)
+{
+	UNUSED(param);
+
+	return (size_t)key;
+}
+
+/* a * b in two words, by half word products */
+static edf_key_ty MulWideImp(unsigned long a, unsigned long b)
+{
+	edf_key_ty product = {0, 0};
+	unsigned long low_low = (a & LOW_HALF_MASK) * (b & LOW_HALF_MASK);
+	unsigned long low_high = (a & LOW_HALF_MASK) * (b >> HALF_BITS);
+	unsigned long high_low = (a >> HALF_BITS) * (b & LOW_HALF_MASK);
+	unsigned long middle = 0;
+
+	/* the carries into the high word */
+	middle = (low_low >> HALF_BITS) + (low_high & LOW_HALF_MASK) +
+			 (high_low & LOW_HALF_MASK);
+
+	product.low = (low_low & LOW_HALF_MASK) | (middle << HALF_BITS);
+	product.high = (a >> HALF_BITS) * (b >> HALF_BITS) +
+				   (low_high >> HALF_BITS) + (high_low >> HALF_BITS) +
+				   (middle >> HALF_BITS);
+
+	return product;
+}
+
+static edf_key_ty AddWideImp(edf_key_ty a, edf_key_ty b)
+{
+	edf_key_ty sum = {0, 0};
+
+	sum.low = a.low + b.low;
+	sum.high = a.high + b.high + (sum.low < a.low);
+
+	return sum;
+}
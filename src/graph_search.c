@@ -0,0 +1,457 @@
+/*******************************************************************************
+***************************** - GRAPH SEARCH - ********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of Shortest paths over a CSR graph
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+#include <limits.h>			/* CHAR_BIT */
+
+#include "utilities.h"
+#include "heap.h"
+#include "graph_search.h"
+
+#define RADIX_BUCKETS (sizeof(unsigned long) * CHAR_BIT + 1)
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Graph search is not allocated");
+
+/* The state of a node is valid only when its stamp is the epoch of the
+	run - a new run bumps the epoch instead of clearing every node.		*/
+typedef struct node_state
+{
+	unsigned long stamp;
+	unsigned long dist;
+	unsigned long key;			/* dist + heuristic */
+	size_t heap_index;
+	graph_node_ty pred;
+	graph_node_ty next;			/* in its radix bucket */
+	graph_node_ty prev;
+	unsigned char bucket;
+	unsigned char is_open;
+	unsigned char is_closed;
+} node_state_ty;
+
+struct graph_search
+{
+	csr_graph_ty graph;
+	graph_open_set_ty open_set;
+	node_state_ty *states;
+	unsigned long epoch;
+	heap_ty *heap;				/* GRAPH_OPEN_HEAP - of states */
+	graph_node_ty buckets[RADIX_BUCKETS];
+	unsigned long radix_last;
+	size_t open_count;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static node_state_ty *StateImp(graph_search_ty *search, graph_node_ty node);
+static void OpenImp(graph_search_ty *search, graph_node_ty node);
+static void DecreaseImp(graph_search_ty *search, graph_node_ty node);
+static graph_node_ty PopImp(graph_search_ty *search);
+static size_t BucketOfImp(unsigned long last, unsigned long key);
+static void BucketInsertImp(graph_search_ty *search, graph_node_ty node);
+static void BucketRemoveImp(graph_search_ty *search, graph_node_ty node);
+static int CmpKeysImp(const void *state1, const void *state2, const void *param);
+static void MoveStateImp(void *state, size_t index, void *param);
+
+/*******************************************************************************
+***************************** GraphSearch Create ******************************/
+graph_search_ty *GraphSearchCreate(const csr_graph_ty *graph, graph_open_set_ty open_set)
+{
+	graph_search_ty *search = NULL;
+	size_t i = 0;
+
+	assert (NULL != graph && "GraphSearchCreate: graph is invalid");
+	assert (GRAPH_NO_NODE > graph->num_nodes && "GraphSearchCreate: too many nodes");
+
+	search = (graph_search_ty *)malloc(sizeof(graph_search_ty));
+
+	if (NULL == search)
+	{
+		return NULL;
+	}
+
+	search->graph = *graph;
+	search->open_set = open_set;
+	search->epoch = 0;
+	search->open_count = 0;
+	search->heap = NULL;
+	search->states = (node_state_ty *)malloc(graph->num_nodes * sizeof(node_state_ty) + 1);
+
+	/* a run never allocates - the heap holds every node at most once */
+	if (NULL != search->states && GRAPH_OPEN_HEAP == open_set)
+	{
+		search->heap = HeapCreate(CmpKeysImp, NULL);
+
+		if (NULL != search->heap && 0 != HeapReserve(search->heap, graph->num_nodes))
+		{
+			HeapDestroy(search->heap);
+			search->heap = NULL;
+		}
+	}
+
+	if (NULL == search->states || (GRAPH_OPEN_HEAP == open_set && NULL == search->heap))
+	{
+		free(search->states);
+		free(search);
+		return NULL;
+	}
+
+	if (NULL != search->heap)
+	{
+		HeapSetMoveFunc(search->heap, MoveStateImp, NULL);
+	}
+
+	for (i = 0; i < graph->num_nodes; ++i)
+	{
+		search->states[i].stamp = 0;
+	}
+
+	return search;
+}
+
+/*******************************************************************************
+***************************** GraphSearch Destroy *****************************/
+void GraphSearchDestroy(graph_search_ty *search)
+{
+	ASSERT_NOT_NULL_IMP(search);
+
+	if (NULL != search->heap)
+	{
+		HeapDestroy(search->heap);
+	}
+
+	free(search->states);
+
+	DEBUG_MODE
+	(
+		search->states = INVALID_PTR;
+		search->heap = INVALID_PTR;
+	)
+	free(search);
+}
+
+/*******************************************************************************
+***************************** GraphSearch Run *********************************/
+unsigned long GraphSearchRun(graph_search_ty *search, graph_node_ty source,
+								graph_node_ty target,
+								GraphHeuristicFunc heuristic_func_p, void *param)
+{
+	const csr_graph_ty *graph = NULL;
+	node_state_ty *from = NULL;
+	node_state_ty *to = NULL;
+	unsigned long dist = 0;
+	graph_node_ty u = 0;
+	graph_node_ty v = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(search);
+	assert (source < search->graph.num_nodes && "GraphSearchRun: source is out of range");
+
+	graph = &search->graph;
+
+	/* a wrapped epoch could match an old stamp */
+	++search->epoch;
+
+	if (0 == search->epoch)
+	{
+		for (i = 0; i < graph->num_nodes; ++i)
+		{
+			search->states[i].stamp = 0;
+		}
+
+		search->epoch = 1;
+	}
+
+	if (NULL != search->heap)
+	{
+		HeapClear(search->heap);
+	}
+
+	for (i = 0; i < RADIX_BUCKETS; ++i)
+	{
+		search->buckets[i] = GRAPH_NO_NODE;
+	}
+
+	search->radix_last = 0;
+	search->open_count = 0;
+
+	from = StateImp(search, source);
+	from->dist = 0;
+	from->key = (NULL == heuristic_func_p) ? 0 : heuristic_func_p(source, target, param);
+	OpenImp(search, source);
+
+	while (0 < search->open_count)
+	{
+		u = PopImp(search);
+		from = &search->states[u];
+		from->is_closed = 1;
+
+		if (u == target)
+		{
+			return from->dist;
+		}
+
+		for (i = graph->offsets[u]; i < graph->offsets[u + 1]; ++i)
+		{
+			v = graph->targets[i];
+			to = StateImp(search, v);
+			dist = from->dist + graph->weights[i];
+
+			/* a consistent heuristic never reopens a closed node */
+			if (to->is_closed || dist >= to->dist)
+			{
+				continue;
+			}
+
+			to->key = dist + ((NULL == heuristic_func_p) ? 0 :
+										heuristic_func_p(v, target, param));
+			to->dist = dist;
+			to->pred = u;
+
+			if (to->is_open)
+			{
+				DecreaseImp(search, v);
+			}
+			else
+			{
+				OpenImp(search, v);
+			}
+		}
+	}
+
+	return GRAPH_INFINITY;
+}
+
+/*******************************************************************************
+***************************** GraphSearch Distance ****************************/
+unsigned long GraphSearchDistance(const graph_search_ty *search, graph_node_ty node)
+{
+	ASSERT_NOT_NULL_IMP(search);
+	assert (node < search->graph.num_nodes && "GraphSearchDistance: node is out of range");
+
+	return (search->epoch == search->states[node].stamp) ?
+			search->states[node].dist : GRAPH_INFINITY;
+}
+
+/*******************************************************************************
+***************************** GraphSearch Predecessor *************************/
+graph_node_ty GraphSearchPredecessor(const graph_search_ty *search, graph_node_ty node)
+{
+	ASSERT_NOT_NULL_IMP(search);
+	assert (node < search->graph.num_nodes && "GraphSearchPredecessor: node is out of range");
+
+	return (search->epoch == search->states[node].stamp) ?
+			search->states[node].pred : GRAPH_NO_NODE;
+}
+
+/*******************************************************************************
+***************************** GraphSearch Path ********************************/
+size_t GraphSearchPath(const graph_search_ty *search, graph_node_ty node,
+						graph_node_ty *out, size_t max_len)
+{
+	graph_node_ty walk = node;
+	size_t len = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(search);
+
+	if (GRAPH_INFINITY == GraphSearchDistance(search, node))
+	{
+		return 0;
+	}
+
+	for (walk = node; GRAPH_NO_NODE != walk; walk = search->states[walk].pred)
+	{
+		++len;
+	}
+
+	if (len <= max_len)
+	{
+		for (i = len, walk = node; 0 < i; --i, walk = search->states[walk].pred)
+		{
+			out[i - 1] = walk;
+		}
+	}
+
+	return len;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+
+/* the state of node, reset on its first touch in this run */
+static node_state_ty *StateImp(graph_search_ty *search, graph_node_ty node)
+{
+	node_state_ty *state = &search->states[node];
+
+	if (search->epoch != state->stamp)
+	{
+		state->stamp = search->epoch;
+		state->dist = GRAPH_INFINITY;
+		state->pred = GRAPH_NO_NODE;
+		state->is_open = 0;
+		state->is_closed = 0;
+	}
+
+	return state;
+}
+
+static void OpenImp(graph_search_ty *search, graph_node_ty node)
+{
+	search->states[node].is_open = 1;
+	++search->open_count;
+
+	if (NULL != search->heap)
+	{
+		/* reserved for every node - does not fail */
+		HeapPush(search->heap, &search->states[node]);
+	}
+	else
+	{
+		BucketInsertImp(search, node);
+	}
+}
+
+static void DecreaseImp(graph_search_ty *search, graph_node_ty node)
+{
+	if (NULL != search->heap)
+	{
+		HeapUpdateAt(search->heap, search->states[node].heap_index);
+	}
+	else
+	{
+		BucketRemoveImp(search, node);
+		BucketInsertImp(search, node);
+	}
+}
+
+static graph_node_ty PopImp(graph_search_ty *search)
+{
+	graph_node_ty node = 0;
+	graph_node_ty next = 0;
+	unsigned long min = 0;
+	size_t b = 0;
+
+	--search->open_count;
+
+	if (NULL != search->heap)
+	{
+		node = (graph_node_ty)((node_state_ty *)HeapPop(search->heap) - search->states);
+		search->states[node].is_open = 0;
+
+		return node;
+	}
+
+	/* bucket 0 holds keys equal to the last minimum; otherwise the first
+		bucket is redistributed around its minimum, all into lower buckets */
+	if (GRAPH_NO_NODE == search->buckets[0])
+	{
+		for (b = 1; GRAPH_NO_NODE == search->buckets[b]; ++b)
+		{
+			/* empty */
+		}
+
+		min = GRAPH_INFINITY;
+
+		for (node = search->buckets[b]; GRAPH_NO_NODE != node; node = search->states[node].next)
+		{
+			min = (search->states[node].key < min) ? search->states[node].key : min;
+		}
+
+		search->radix_last = min;
+		node = search->buckets[b];
+		search->buckets[b] = GRAPH_NO_NODE;
+
+		for (; GRAPH_NO_NODE != node; node = next)
+		{
+			next = search->states[node].next;
+			BucketInsertImp(search, node);
+		}
+	}
+
+	node = search->buckets[0];
+	BucketRemoveImp(search, node);
+	search->states[node].is_open = 0;
+
+	return node;
+}
+
+/* 0 for the last minimum itself, else 1 + the highest differing bit */
+static size_t BucketOfImp(unsigned long last, unsigned long key)
+{
+	unsigned long diff = key ^ last;
+	size_t b = 0;
+
+	while (0 != diff)
+	{
+		diff >>= 1;
+		++b;
+	}
+
+	return b;
+}
+
+static void BucketInsertImp(graph_search_ty *search, graph_node_ty node)
+{
+	node_state_ty *state = &search->states[node];
+	size_t b = 0;
+
+	assert (state->key >= search->radix_last && "GraphSearchRun: keys are not monotone");
+
+	b = BucketOfImp(search->radix_last, state->key);
+	state->bucket = (unsigned char)b;
+	state->prev = GRAPH_NO_NODE;
+	state->next = search->buckets[b];
+
+	if (GRAPH_NO_NODE != state->next)
+	{
+		search->states[state->next].prev = node;
+	}
+
+	search->buckets[b] = node;
+}
+
+static void BucketRemoveImp(graph_search_ty *search, graph_node_ty node)
+{
+	node_state_ty *state = &search->states[node];
+
+	if (GRAPH_NO_NODE != state->prev)
+	{
+		search->states[state->prev].next = state->next;
+	}
+	else
+	{
+		search->buckets[state->bucket] = state->next;
+	}
+
+	if (GRAPH_NO_NODE != state->next)
+	{
+		search->states[state->next].prev = state->prev;
+	}
+}
+
+static int CmpKeysImp(const void *state1, const void *state2, const void *param)
+{
+	unsigned long key1 = ((const node_state_ty *)state1)->key;
+	unsigned long key2 = ((const node_state_ty *)state2)->key;
+
+	UNUSED(param);
+
+	return (key1 > key2) - (key1 < key2);
+}
+
+static void MoveStateImp(void *state, size_t index, void *param)
+{
+	UNUSED(param);
+
+	((node_state_ty *)state)->heap_index = index;
+}
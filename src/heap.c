@@ -0,0 +1,440 @@
+/*******************************************************************************
+********************************* - HEAP - ************************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of Binary heap
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free, realloc */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "heap.h"
+
+#define HEAP_INIT_CAPACITY 16
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Heap is not allocated");
+
+struct heap
+{
+	void **items;
+	size_t size;
+	size_t capacity;
+	HeapCmpFunc cmp_func;
+	const void *cmp_param;
+	HeapMoveFunc move_func;
+	void *move_param;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int ReserveImp(heap_ty *heap, size_t capacity);
+static void PlaceImp(heap_ty *heap, void *data, size_t index);
+static void SiftUpImp(heap_ty *heap, size_t index);
+static void SiftDownImp(heap_ty *heap, size_t index);
+static void HeapifyImp(heap_ty *heap);
+
+/*******************************************************************************
+***************************** Heap Create *************************************/
+heap_ty *HeapCreate(HeapCmpFunc cmp_func_p, const void *cmp_param)
+{
+	heap_ty *heap = NULL;
+
+	assert (NULL != cmp_func_p && "HeapCreate: Function pointer is invalid");
+
+	heap = (heap_ty *)malloc(sizeof(heap_ty));
+
+	if (NULL == heap)
+	{
+		return NULL;
+	}
+
+	heap->items = (void **)malloc(HEAP_INIT_CAPACITY * sizeof(void *));
+
+	if (NULL == heap->items)
+	{
+		free(heap);
+		return NULL;
+	}
+
+	heap->size = 0;
+	heap->capacity = HEAP_INIT_CAPACITY;
+	heap->cmp_func = cmp_func_p;
+	heap->cmp_param = cmp_param;
+	heap->move_func = NULL;
+	heap->move_param = NULL;
+
+	return heap;
+}
+
+/*******************************************************************************
+***************************** Heap Destroy ************************************/
+void HeapDestroy(heap_ty *heap)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	free(heap->items);
+
+	DEBUG_MODE
+	(
+		heap->items = INVALID_PTR;
+	)
+	free(heap);
+}
+
+/*******************************************************************************
+***************************** Heap SetMoveFunc ********************************/
+void HeapSetMoveFunc(heap_ty *heap, HeapMoveFunc move_func_p, void *move_param)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	heap->move_func = move_func_p;
+	heap->move_param = move_param;
+}
+
+/*******************************************************************************
+***************************** Heap Push ***************************************/
+int HeapPush(heap_ty *heap, void *data)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	if (heap->size == heap->capacity && 0 != ReserveImp(heap, 2 * heap->capacity))
+	{
+		return 1;
+	}
+
+	heap->items[heap->size] = data;
+	++heap->size;
+	SiftUpImp(heap, heap->size - 1);
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** Heap PushBatch **********************************/
+size_t HeapPushBatch(heap_ty *heap, void **items, size_t n)
+{
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(heap);
+
+	if (heap->size + n > heap->capacity &&
+		0 != ReserveImp(heap, 2 * (heap->size + n)))
+	{
+		return 0;
+	}
+
+	/* sifting up each costs more than rebuilding once */
+	if (n < heap->size / 4)
+	{
+		for (i = 0; i < n; ++i)
+		{
+			heap->items[heap->size] = items[i];
+			++heap->size;
+			SiftUpImp(heap, heap->size - 1);
+		}
+
+		return n;
+	}
+
+	for (i = 0; i < n; ++i)
+	{
+		heap->items[heap->size] = items[i];
+		++heap->size;
+	}
+
+	HeapifyImp(heap);
+
+	return n;
+}
+
+/*******************************************************************************
+***************************** Heap Pop ****************************************/
+void *HeapPop(heap_ty *heap)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	if (0 == heap->size)
+	{
+		return NULL;
+	}
+
+	return HeapRemoveAt(heap, 0);
+}
+
+/*******************************************************************************
+***************************** Heap ReplaceTop *********************************/
+void *HeapReplaceTop(heap_ty *heap, void *data)
+{
+	void *replaced = NULL;
+
+	ASSERT_NOT_NULL_IMP(heap);
+	assert (0 < heap->size && "HeapReplaceTop: heap is empty");
+
+	replaced = heap->items[0];
+	heap->items[0] = data;
+	SiftDownImp(heap, 0);
+
+	return replaced;
+}
+
+/*******************************************************************************
+***************************** Heap Peek ***************************************/
+void *HeapPeek(const heap_ty *heap)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	return (0 == heap->size) ? NULL : heap->items[0];
+}
+
+/*******************************************************************************
+***************************** Heap Get ****************************************/
+void *HeapGet(const heap_ty *heap, size_t index)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+	assert (index < heap->size && "HeapGet: index is out of range");
+
+	return heap->items[index];
+}
+
+/*******************************************************************************
+***************************** Heap RemoveAt ***********************************/
+void *HeapRemoveAt(heap_ty *heap, size_t index)
+{
+	void *removed = NULL;
+
+	ASSERT_NOT_NULL_IMP(heap);
+	assert (index < heap->size && "HeapRemoveAt: index is out of range");
+
+	removed = heap->items[index];
+	--heap->size;
+
+	/* the last element takes its place, then moves up or down */
+	if (index < heap->size)
+	{
+		PlaceImp(heap, heap->items[heap->size], index);
+		HeapUpdateAt(heap, index);
+	}
+
+	return removed;
+}
+
+/*******************************************************************************
+***************************** Heap UpdateAt ***********************************/
+void HeapUpdateAt(heap_ty *heap, size_t index)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+	assert (index < heap->size && "HeapUpdateAt: index is out of range");
+
+	if (0 < index && 0 > heap->cmp_func(heap->items[index],
+										heap->items[(index - 1) / 2],
+										heap->cmp_param))
+	{
+		SiftUpImp(heap, index);
+	}
+	else
+	{
+		SiftDownImp(heap, index);
+	}
+}
+
+/*******************************************************************************
+***************************** Heap FindIf *************************************/
+size_t HeapFindIf(const heap_ty *heap, HeapIsMatch match_func_p, const void *param)
+{
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(heap);
+	assert (NULL != match_func_p && "HeapFindIf: Function pointer is invalid");
+
+	while (i < heap->size && !match_func_p(heap->items[i], param))
+	{
+		++i;
+	}
+
+	return i;
+}
+
+/*******************************************************************************
+***************************** Heap RemoveIf ***********************************/
+size_t HeapRemoveIf(heap_ty *heap, HeapIsMatch match_func_p, const void *match_param,
+					HeapRemoveFunc remove_func_p, void *remove_param)
+{
+	size_t kept = 0;
+	size_t removed = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(heap);
+	assert (NULL != match_func_p && "HeapRemoveIf: Function pointer is invalid");
+
+	/* keep the others in array order */
+	for (i = 0; i < heap->size; ++i)
+	{
+		if (!match_func_p(heap->items[i], match_param))
+		{
+			heap->items[kept] = heap->items[i];
+			++kept;
+		}
+		else if (NULL != remove_func_p)
+		{
+			remove_func_p(heap->items[i], remove_param);
+		}
+	}
+
+	removed = heap->size - kept;
+	heap->size = kept;
+
+	if (0 < removed)
+	{
+		HeapifyImp(heap);
+	}
+
+	return removed;
+}
+
+/*******************************************************************************
+***************************** Heap SetCmpParam ********************************/
+void HeapSetCmpParam(heap_ty *heap, const void *cmp_param)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	heap->cmp_param = cmp_param;
+	HeapifyImp(heap);
+}
+
+/*******************************************************************************
+***************************** Heap Size ***************************************/
+size_t HeapSize(const heap_ty *heap)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	return heap->size;
+}
+
+/*******************************************************************************
+***************************** Heap IsEmpty ************************************/
+int HeapIsEmpty(const heap_ty *heap)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	return (0 == heap->size);
+}
+
+/*******************************************************************************
+***************************** Heap Reserve ************************************/
+int HeapReserve(heap_ty *heap, size_t capacity)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	return (capacity <= heap->capacity) ? 0 : ReserveImp(heap, capacity);
+}
+
+/*******************************************************************************
+***************************** Heap Clear **************************************/
+void HeapClear(heap_ty *heap)
+{
+	ASSERT_NOT_NULL_IMP(heap);
+
+	heap->size = 0;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int ReserveImp(heap_ty *heap, size_t capacity)
+{
+	void **bigger = (void **)realloc(heap->items, capacity * sizeof(void *));
+
+	if (NULL == bigger)
+	{
+		return 1;
+	}
+
+	heap->items = bigger;
+	heap->capacity = capacity;
+
+	return 0;
+}
+
+static void PlaceImp(heap_ty *heap, void *data, size_t index)
+{
+	heap->items[index] = data;
+
+	if (NULL != heap->move_func)
+	{
+		heap->move_func(data, index, heap->move_param);
+	}
+}
+
+/* move the element at index up through a hole */
+static void SiftUpImp(heap_ty *heap, size_t index)
+{
+	void *moving = heap->items[index];
+	size_t parent = 0;
+
+	while (0 < index)
+	{
+		parent = (index - 1) / 2;
+
+		if (0 <= heap->cmp_func(moving, heap->items[parent], heap->cmp_param))
+		{
+			break;
+		}
+
+		PlaceImp(heap, heap->items[parent], index);
+		index = parent;
+	}
+
+	PlaceImp(heap, moving, index);
+}
+
+static void SiftDownImp(heap_ty *heap, size_t index)
+{
+	void *moving = heap->items[index];
+	size_t size = heap->size;
+	size_t child = 0;
+
+	while ((child = 2 * index + 1) < size)
+	{
+		if (child + 1 < size &&
+			0 > heap->cmp_func(heap->items[child + 1], heap->items[child],
+							   heap->cmp_param))
+		{
+			++child;
+		}
+
+		if (0 >= heap->cmp_func(moving, heap->items[child], heap->cmp_param))
+		{
+			break;
+		}
+
+		PlaceImp(heap, heap->items[child], index);
+		index = child;
+	}
+
+	PlaceImp(heap, moving, index);
+}
+
+/* bottom up; every element is reported at least once */
+static void HeapifyImp(heap_ty *heap)
+{
+	size_t i = heap->size / 2;
+
+	while (0 < i)
+	{
+		--i;
+		SiftDownImp(heap, i);
+	}
+
+	if (NULL != heap->move_func)
+	{
+		for (i = heap->size / 2; i < heap->size; ++i)
+		{
+			heap->move_func(heap->items[i], i, heap->move_param);
+		}
+	}
+}
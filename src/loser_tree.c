@@ -0,0 +1,218 @@
+/*******************************************************************************
+****************************** - LOSER TREE - *********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of Tournament (loser) tree
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "loser_tree.h"
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Loser tree is not allocated");
+
+/* Sources are the leaves of a complete tree of size leaves (a power of 2,
+	leaf i is node size + i). Every inner node keeps the source which lost
+	the match played there; the overall winner is kept aside. Replaying a
+	leaf compares it only with the losers on its way to the root.		*/
+struct loser_tree
+{
+	size_t num_sources;
+	size_t size;
+	size_t *losers;			/* losers[1..size), losers[0] is the winner */
+	void **keys;			/* one per leaf, padding leaves stay NULL */
+	LTCmpFunc cmp_func;
+	const void *cmp_param;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int IsBeforeImp(const loser_tree_ty *tree, size_t source1, size_t source2);
+static size_t PlayImp(loser_tree_ty *tree, size_t node);
+
+/*******************************************************************************
+***************************** LoserTree Create ********************************/
+loser_tree_ty *LoserTreeCreate(size_t num_sources, LTCmpFunc cmp_func_p,
+								const void *cmp_param)
+{
+	loser_tree_ty *tree = NULL;
+	size_t i = 0;
+
+	assert (NULL != cmp_func_p && "LoserTreeCreate: Function pointer is invalid");
+
+	tree = (loser_tree_ty *)malloc(sizeof(loser_tree_ty));
+
+	if (NULL == tree)
+	{
+		return NULL;
+	}
+
+	tree->num_sources = num_sources;
+	tree->cmp_func = cmp_func_p;
+	tree->cmp_param = cmp_param;
+
+	for (tree->size = 1; tree->size < num_sources; tree->size *= 2)
+	{
+		/* empty */
+	}
+
+	tree->losers = (size_t *)malloc(tree->size * sizeof(size_t));
+	tree->keys = (void **)malloc(tree->size * sizeof(void *));
+
+	if (NULL == tree->losers || NULL == tree->keys)
+	{
+		free(tree->losers);
+		free(tree->keys);
+		free(tree);
+		return NULL;
+	}
+
+	for (i = 0; i < tree->size; ++i)
+	{
+		tree->keys[i] = NULL;
+		tree->losers[i] = 0;
+	}
+
+	return tree;
+}
+
+/*******************************************************************************
+***************************** LoserTree Destroy *******************************/
+void LoserTreeDestroy(loser_tree_ty *tree)
+{
+	ASSERT_NOT_NULL_IMP(tree);
+
+	free(tree->losers);
+	free(tree->keys);
+
+	DEBUG_MODE
+	(
+		tree->losers = INVALID_PTR;
+		tree->keys = INVALID_PTR;
+	)
+	free(tree);
+}
+
+/*******************************************************************************
+***************************** LoserTree Set ***********************************/
+void LoserTreeSet(loser_tree_ty *tree, size_t source, void *key)
+{
+	ASSERT_NOT_NULL_IMP(tree);
+	assert (source < tree->num_sources && "LoserTreeSet: source is out of range");
+
+	tree->keys[source] = key;
+}
+
+/*******************************************************************************
+***************************** LoserTree Build *********************************/
+void LoserTreeBuild(loser_tree_ty *tree)
+{
+	ASSERT_NOT_NULL_IMP(tree);
+
+	tree->losers[0] = (1 == tree->size) ? 0 : PlayImp(tree, 1);
+}
+
+/*******************************************************************************
+***************************** LoserTree Top ***********************************/
+void *LoserTreeTop(const loser_tree_ty *tree)
+{
+	ASSERT_NOT_NULL_IMP(tree);
+
+	return tree->keys[tree->losers[0]];
+}
+
+/*******************************************************************************
+***************************** LoserTree Winner ********************************/
+size_t LoserTreeWinner(const loser_tree_ty *tree)
+{
+	ASSERT_NOT_NULL_IMP(tree);
+
+	return tree->losers[0];
+}
+
+/*******************************************************************************
+***************************** LoserTree Replay ********************************/
+void LoserTreeReplay(loser_tree_ty *tree, void *key)
+{
+	size_t winner = 0;
+	size_t node = 0;
+	size_t tmp = 0;
+
+	ASSERT_NOT_NULL_IMP(tree);
+
+	winner = tree->losers[0];
+	tree->keys[winner] = key;
+
+	/* the winner of each match goes up, the loser stays */
+	for (node = (tree->size + winner) / 2; 0 < node; node /= 2)
+	{
+		if (IsBeforeImp(tree, tree->losers[node], winner))
+		{
+			tmp = tree->losers[node];
+			tree->losers[node] = winner;
+			winner = tmp;
+		}
+	}
+
+	tree->losers[0] = winner;
+}
+
+/*******************************************************************************
+***************************** LoserTree NumSources ****************************/
+size_t LoserTreeNumSources(const loser_tree_ty *tree)
+{
+	ASSERT_NOT_NULL_IMP(tree);
+
+	return tree->num_sources;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+
+/* exhausted sources lose; equal keys go to the lower source (stable) */
+static int IsBeforeImp(const loser_tree_ty *tree, size_t source1, size_t source2)
+{
+	const void *key1 = tree->keys[source1];
+	const void *key2 = tree->keys[source2];
+	int cmp = 0;
+
+	if (NULL == key1 || NULL == key2)
+	{
+		return (NULL != key1) || (NULL == key2 && source1 < source2);
+	}
+
+	cmp = tree->cmp_func(key1, key2, tree->cmp_param);
+
+	return (0 > cmp) || (0 == cmp && source1 < source2);
+}
+
+/* play the subtree of node; returns its winner and keeps the losers */
+static size_t PlayImp(loser_tree_ty *tree, size_t node)
+{
+	size_t left = 0;
+	size_t right = 0;
+
+	if (node >= tree->size)
+	{
+		return node - tree->size;
+	}
+
+	left = PlayImp(tree, 2 * node);
+	right = PlayImp(tree, 2 * node + 1);
+
+	if (IsBeforeImp(tree, right, left))
+	{
+		tree->losers[node] = left;
+		return right;
+	}
+
+	tree->losers[node] = right;
+	return left;
+}
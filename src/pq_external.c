@@ -0,0 +1,960 @@
+/*******************************************************************************
+************************ - EXTERNAL MEMORY PRIORITY QUEUE - ********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Disk spilling engine of pqueue (PQ_ENGINE_EXTERNAL)
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L		/* mkstemp, fdopen */
+
+#include <stdlib.h>			/* malloc, free, realloc, mkstemp */
+#include <assert.h>			/* assert */
+#include <string.h>			/* strlen, strcpy, strcat */
+#include <stdio.h>			/* FILE, fdopen, tmpfile, fread, fwrite */
+#include <unistd.h>			/* close, unlink */
+
+#include "utilities.h"
+#include "pq_engine.h"
+
+#define EXT_LEVEL_WIDTH 16			/* runs per level */
+#define EXT_MAX_LEVELS 8
+#define EXT_MAX_RUNS (EXT_LEVEL_WIDTH * EXT_MAX_LEVELS)
+#define EXT_IO_BUFFER_SIZE 65536
+#define EXT_RECORD_INIT_SIZE 256
+#define EXT_RUN_TEMPLATE "/pqrunXXXXXX"
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "External pqueue is not allocated");
+
+/* A run is a temporary file of records in priority order:
+	+--------+-------+--------+-------+-----+
+	| size_t | bytes | size_t | bytes | ... |
+	+--------+-------+--------+-------+-----+
+	Only its first element (head) is in memory.
+	A spill makes a run of level 0. A full level is merged into one run of
+	the next, as the groups of the sequence heap, so a run of level l holds
+	about capacity * EXT_LEVEL_WIDTH^l records and every record is written
+	once per level. The last level is merged into itself.		*/
+typedef struct ext_run
+{
+	FILE *file;
+	void *head;
+	size_t remaining;		/* records after head */
+	size_t level;
+	long pos;				/* offset of the record after head */
+	long saved_pos;			/* state before a merge, to undo it */
+	void *saved_head;
+	size_t saved_remaining;
+} ext_run_ty;
+
+typedef struct ext_engine
+{
+	void **heap;
+	size_t heap_size;
+	size_t capacity;
+	ext_run_ty *runs[EXT_MAX_RUNS];		/* heap by head */
+	size_t num_runs;
+	ext_run_ty *stalled[EXT_MAX_RUNS];	/* no head: the next read failed */
+	size_t num_stalled;
+	size_t level_runs[EXT_MAX_LEVELS];	/* in runs and stalled */
+	size_t count;
+	int is_failed;			/* a read failed since the last Clear */
+	int is_top_in_heap;		/* else it is the head of runs[0] */
+	unsigned char *record;
+	size_t record_size;
+	char *dir;
+	PQCmpFunc cmp_func;
+	const void *cmp_param;
+	PQSerializeFunc serialize_func;
+	PQDeserializeFunc deserialize_func;
+	PQReleaseFunc release_func;
+	void *io_param;
+} ext_engine_ty;
+
+typedef int (*ext_cmp_ty)(const ext_engine_ty *ext, const void *obj1,
+						  const void *obj2);
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int SpillImp(ext_engine_ty *ext);
+static int MakeRoomImp(ext_engine_ty *ext, size_t level);
+static int MergeLevelImp(ext_engine_ty *ext, size_t level, size_t to);
+static void UndoMergeImp(ext_engine_ty *ext, ext_run_ty **runs, size_t num_runs);
+static void RemoveRunImp(ext_engine_ty *ext, size_t index);
+static ext_run_ty *CreateRunImp(ext_engine_ty *ext);
+static void CloseRunImp(ext_engine_ty *ext, ext_run_ty *run);
+static void AdvanceRunImp(ext_engine_ty *ext);
+static void StallRunImp(ext_engine_ty *ext, size_t index);
+static void RetryRunsImp(ext_engine_ty *ext);
+static int ReadHeadImp(ext_engine_ty *ext, ext_run_ty *run);
+static int WriteRecordImp(ext_engine_ty *ext, FILE *file, const void *data);
+static void ReleaseImp(ext_engine_ty *ext, void *data);
+static void UpdateTopImp(ext_engine_ty *ext);
+static int CmpDataImp(const ext_engine_ty *ext, const void *obj1, const void *obj2);
+static int CmpRunsImp(const ext_engine_ty *ext, const void *obj1, const void *obj2);
+static void SiftUpImp(const ext_engine_ty *ext, void **heap, size_t index,
+					  ext_cmp_ty cmp_func);
+static void SiftDownImp(const ext_engine_ty *ext, void **heap, size_t size,
+						size_t index, ext_cmp_ty cmp_func);
+static void HeapifyImp(const ext_engine_ty *ext, void **heap, size_t size,
+					   ext_cmp_ty cmp_func);
+static void RemoveAtImp(const ext_engine_ty *ext, void **heap, size_t *size,
+						size_t index, ext_cmp_ty cmp_func);
+
+static void DestroyImp(void *engine);
+static int EnqueueImp(void *engine, void *data);
+static void DequeueImp(void *engine);
+static void *PeekImp(const void *engine);
+static int IsEmptyImp(const void *engine);
+static size_t SizeImp(const void *engine);
+static void ClearImp(void *engine);
+static void *EraseImp(void *engine, PQIsMatch match_func, void *param);
+static int ErrorImp(const void *engine);
+
+const pq_engine_ops_ty pq_external_engine_ops =
+{
+	DestroyImp,
+	EnqueueImp,
+	NULL,
+	NULL,
+	DequeueImp,
+	PeekImp,
+	IsEmptyImp,
+	SizeImp,
+	ClearImp,
+	EraseImp,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	ErrorImp
+};
+
+
+/*******************************************************************************
+***************************** PQExternalEngine Create *************************/
+void *PQExternalEngineCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+								const pq_config_ty *config)
+{
+	ext_engine_ty *ext = NULL;
+	size_t i = 0;
+
+	assert (NULL != config && "PQExternalEngineCreate: config is invalid");
+	assert (NULL != config->serialize_func_p &&
+			NULL != config->deserialize_func_p &&
+			"PQExternalEngineCreate: Function pointer is invalid");
+
+	ext = (ext_engine_ty *)malloc(sizeof(ext_engine_ty));
+
+	if (NULL == ext)
+	{
+		return NULL;
+	}
+
+	ext->capacity = (0 == config->capacity) ? 1 : config->capacity;
+	ext->heap_size = 0;
+	ext->num_runs = 0;
+	ext->num_stalled = 0;
+	ext->count = 0;
+	ext->is_failed = 0;
+
+	for (i = 0; i < EXT_MAX_LEVELS; ++i)
+	{
+		ext->level_runs[i] = 0;
+	}
+
+	ext->is_top_in_heap = 1;
+	ext->record_size = EXT_RECORD_INIT_SIZE;
+	ext->cmp_func = cmp_func_p;
+	ext->cmp_param = cmp_param;
+	ext->serialize_func = config->serialize_func_p;
+	ext->deserialize_func = config->deserialize_func_p;
+	ext->release_func = config->release_func_p;
+	ext->io_param = config->io_param;
+	ext->dir = NULL;
+
+	ext->heap = (void **)malloc(ext->capacity * sizeof(void *));
+	ext->record = (unsigned char *)malloc(ext->record_size);
+
+	if (NULL != config->path)
+	{
+		ext->dir = (char *)malloc(strlen(config->path) + 1);
+
+		if (NULL != ext->dir)
+		{
+			strcpy(ext->dir, config->path);
+		}
+	}
+
+	if (NULL == ext->heap || NULL == ext->record ||
+		(NULL != config->path && NULL == ext->dir))
+	{
+		DestroyImp(ext);
+		return NULL;
+	}
+
+	return ext;
+}
+
+
+/*******************************************************************************
+***************************** Engine Operations *******************************/
+static void DestroyImp(void *engine)
+{
+	ext_engine_ty *ext = (ext_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(ext);
+
+	if (NULL != ext->heap)
+	{
+		ClearImp(ext);
+	}
+
+	free(ext->heap);
+	free(ext->record);
+	free(ext->dir);
+
+	DEBUG_MODE
+	(
+		ext->heap = INVALID_PTR;
+		ext->record = INVALID_PTR;
+		ext->dir = INVALID_PTR;
+	)
+	free(ext);
+}
+
+static int EnqueueImp(void *engine, void *data)
+{
+	ext_engine_ty *ext = (ext_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(ext);
+
+	RetryRunsImp(ext);
+
+	/* memory is full - write it out as a sorted run */
+	if (ext->heap_size == ext->capacity && 0 != SpillImp(ext))
+	{
+		return 1;
+	}
+
+	ext->heap[ext->heap_size] = data;
+	SiftUpImp(ext, ext->heap, ext->heap_size, CmpDataImp);
+	++ext->heap_size;
+	++ext->count;
+	UpdateTopImp(ext);
+
+	return 0;
+}
+
+static void DequeueImp(void *engine)
+{
+	ext_engine_ty *ext = (ext_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(ext);
+	assert (0 < ext->count && "PQueueDequeue: pqueue is empty");
+
+	/* only stalled runs are left - there was no top */
+	if (0 == ext->heap_size && 0 == ext->num_runs)
+	{
+		RetryRunsImp(ext);
+
+		return;
+	}
+
+	/* the top may be freed by now - it is not compared again */
+	if (ext->is_top_in_heap)
+	{
+		RemoveAtImp(ext, ext->heap, &ext->heap_size, 0, CmpDataImp);
+	}
+	else
+	{
+		AdvanceRunImp(ext);
+	}
+
+	--ext->count;
+	RetryRunsImp(ext);
+	UpdateTopImp(ext);
+}
+
+static void *PeekImp(const void *engine)
+{
+	const ext_engine_ty *ext = (const ext_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(ext);
+
+	if (ext->is_top_in_heap)
+	{
+		return (0 == ext->heap_size) ? NULL : ext->heap[0];
+	}
+
+	return ext->runs[0]->head;
+}
+
+static int IsEmptyImp(const void *engine)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return (0 == SizeImp(engine));
+}
+
+static size_t SizeImp(const void *engine)
+{
+	const ext_engine_ty *ext = (const ext_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(ext);
+
+	return ext->count;
+}
+
+static void ClearImp(void *engine)
+{
+	ext_engine_ty *ext = (ext_engine_ty *)engine;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(ext);
+
+	while (0 < ext->heap_size)
+	{
+		--ext->heap_size;
+		ReleaseImp(ext, ext->heap[ext->heap_size]);
+	}
+
+	/* the records in the files go away with them */
+	while (0 < ext->num_runs)
+	{
+		--ext->num_runs;
+		ReleaseImp(ext, ext->runs[ext->num_runs]->head);
+		CloseRunImp(ext, ext->runs[ext->num_runs]);
+	}
+
+	while (0 < ext->num_stalled)
+	{
+		--ext->num_stalled;
+		CloseRunImp(ext, ext->stalled[ext->num_stalled]);
+	}
+
+	for (i = 0; i < EXT_MAX_LEVELS; ++i)
+	{
+		ext->level_runs[i] = 0;
+	}
+
+	ext->count = 0;
+	ext->is_failed = 0;
+	ext->is_top_in_heap = 1;
+}
+
+static void *EraseImp(void *engine, PQIsMatch match_func, void *param)
+{
+	ext_engine_ty *ext = (ext_engine_ty *)engine;
+	void *ret_data = NULL;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(ext);
+
+	RetryRunsImp(ext);
+
+	for (i = 0; i < ext->heap_size; ++i)
+	{
+		if (match_func(ext->heap[i], param))
+		{
+			ret_data = ext->heap[i];
+			RemoveAtImp(ext, ext->heap, &ext->heap_size, i, CmpDataImp);
+			--ext->count;
+			UpdateTopImp(ext);
+
+			return ret_data;
+		}
+	}
+
+	/* the heads of the runs are in memory as well */
+	for (i = 0; i < ext->num_runs; ++i)
+	{
+		if (match_func(ext->runs[i]->head, param))
+		{
+			ext_run_ty *run = ext->runs[i];
+
+			ret_data = run->head;
+
+			/* the next record of a run is not smaller */
+			if (0 != ReadHeadImp(ext, run))
+			{
+				StallRunImp(ext, i);
+			}
+			else if (NULL == run->head)
+			{
+				RemoveRunImp(ext, i);
+			}
+			else
+			{
+				SiftDownImp(ext, (void **)ext->runs, ext->num_runs, i, CmpRunsImp);
+			}
+
+			--ext->count;
+			UpdateTopImp(ext);
+
+			return ret_data;
+		}
+	}
+
+	return NULL;
+}
+
+static int ErrorImp(const void *engine)
+{
+	const ext_engine_ty *ext = (const ext_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(ext);
+
+	return ext->is_failed;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+
+/* heap sort the memory into a new run; the memory is kept on failure */
+static int SpillImp(ext_engine_ty *ext)
+{
+	ext_run_ty *run = NULL;
+	size_t size = ext->heap_size;
+	size_t i = 0;
+	int status = 0;
+
+	if (0 != MakeRoomImp(ext, 0))
+	{
+		return 1;
+	}
+
+	run = CreateRunImp(ext);
+
+	if (NULL == run)
+	{
+		return 1;
+	}
+
+	/* the heap ends in descending order */
+	while (1 < size)
+	{
+		void *top = ext->heap[0];
+
+		RemoveAtImp(ext, ext->heap, &size, 0, CmpDataImp);
+		ext->heap[size] = top;
+	}
+
+	for (i = ext->heap_size; 0 == status && 0 < i; --i)
+	{
+		status = WriteRecordImp(ext, run->file, ext->heap[i - 1]);
+	}
+
+	run->remaining = ext->heap_size;
+	run->pos = 0;
+	status = status || (0 != fflush(run->file)) ||
+			 (0 != fseek(run->file, 0, SEEK_SET)) || ReadHeadImp(ext, run);
+
+	if (0 != status)
+	{
+		ReleaseImp(ext, run->head);
+		CloseRunImp(ext, run);
+		HeapifyImp(ext, ext->heap, ext->heap_size, CmpDataImp);
+
+		return 1;
+	}
+
+	for (i = 0; i < ext->heap_size; ++i)
+	{
+		ReleaseImp(ext, ext->heap[i]);
+	}
+
+	ext->heap_size = 0;
+
+	run->level = 0;
+	++ext->level_runs[0];
+	ext->runs[ext->num_runs] = run;
+	SiftUpImp(ext, (void **)ext->runs, ext->num_runs, CmpRunsImp);
+	++ext->num_runs;
+
+	return 0;
+}
+
+/* a full level moves up as one run, after room is made above it */
+static int MakeRoomImp(ext_engine_ty *ext, size_t level)
+{
+	if (EXT_LEVEL_WIDTH > ext->level_runs[level])
+	{
+		return 0;
+	}
+
+	if (level + 1 == EXT_MAX_LEVELS)
+	{
+		return MergeLevelImp(ext, level, level);
+	}
+
+	return MakeRoomImp(ext, level + 1) || MergeLevelImp(ext, level, level + 1);
+}
+
+/* k-way merge of the runs of level into one run of level to; undone on
+	failure */
+static int MergeLevelImp(ext_engine_ty *ext, size_t level, size_t to)
+{
+	ext_run_ty *merged = NULL;
+	ext_run_ty *old_runs[EXT_LEVEL_WIDTH] = {NULL};
+	void *heap[EXT_LEVEL_WIDTH] = {NULL};
+	size_t num_runs = 0;
+	size_t size = 0;
+	size_t written = 0;
+	int status = 0;
+	size_t i = 0;
+	size_t j = 0;
+
+	for (i = 0; i < ext->num_runs; ++i)
+	{
+		ext_run_ty *run = ext->runs[i];
+
+		if (level == run->level)
+		{
+			old_runs[num_runs] = run;
+			heap[num_runs] = run;
+			++num_runs;
+			run->saved_pos = run->pos;
+			run->saved_head = run->head;
+			run->saved_remaining = run->remaining;
+		}
+	}
+
+	/* the level is full of stalled runs */
+	if (0 == num_runs)
+	{
+		return 1;
+	}
+
+	merged = CreateRunImp(ext);
+
+	if (NULL == merged)
+	{
+		UndoMergeImp(ext, old_runs, num_runs);
+		return 1;
+	}
+
+	/* merged on a heap of their own; ext->runs is rebuilt at the end */
+	size = num_runs;
+	HeapifyImp(ext, heap, size, CmpRunsImp);
+
+	while (0 == status && 0 < size)
+	{
+		ext_run_ty *run = (ext_run_ty *)heap[0];
+		void *head = run->head;
+
+		status = WriteRecordImp(ext, merged->file, head);
+		++written;
+
+		/* the first heads are released only once the merge is done */
+		if (head != run->saved_head)
+		{
+			ReleaseImp(ext, head);
+		}
+
+		status = status || ReadHeadImp(ext, run);
+
+		if (NULL == run->head)
+		{
+			RemoveAtImp(ext, heap, &size, 0, CmpRunsImp);
+		}
+		else
+		{
+			SiftDownImp(ext, heap, size, 0, CmpRunsImp);
+		}
+	}
+
+	merged->remaining = written;
+	merged->pos = 0;
+	status = status || (0 != fflush(merged->file)) ||
+			 (0 != fseek(merged->file, 0, SEEK_SET)) || ReadHeadImp(ext, merged);
+
+	if (0 != status)
+	{
+		ReleaseImp(ext, merged->head);
+		CloseRunImp(ext, merged);
+		UndoMergeImp(ext, old_runs, num_runs);
+
+		return 1;
+	}
+
+	for (i = 0, j = 0; i < ext->num_runs; ++i)
+	{
+		if (level != ext->runs[i]->level)
+		{
+			ext->runs[j] = ext->runs[i];
+			++j;
+		}
+	}
+
+	for (i = 0; i < num_runs; ++i)
+	{
+		ReleaseImp(ext, old_runs[i]->saved_head);
+		CloseRunImp(ext, old_runs[i]);
+	}
+
+	merged->level = to;
+	ext->level_runs[level] -= num_runs;
+	++ext->level_runs[to];
+	ext->runs[j] = merged;
+	ext->num_runs = j + 1;
+	HeapifyImp(ext, (void **)ext->runs, ext->num_runs, CmpRunsImp);
+
+	return 0;
+}
+
+/* put every run back at its position from before the merge */
+static void UndoMergeImp(ext_engine_ty *ext, ext_run_ty **runs, size_t num_runs)
+{
+	size_t i = 0;
+
+	for (i = 0; i < num_runs; ++i)
+	{
+		ext_run_ty *run = runs[i];
+
+		if (run->head != run->saved_head)
+		{
+			ReleaseImp(ext, run->head);
+		}
+
+		fseek(run->file, run->saved_pos, SEEK_SET);
+		run->pos = run->saved_pos;
+		run->head = run->saved_head;
+		run->remaining = run->saved_remaining;
+	}
+}
+
+/* the run at index is over */
+static void RemoveRunImp(ext_engine_ty *ext, size_t index)
+{
+	ext_run_ty *run = ext->runs[index];
+
+	--ext->level_runs[run->level];
+	RemoveAtImp(ext, (void **)ext->runs, &ext->num_runs, index, CmpRunsImp);
+	CloseRunImp(ext, run);
+}
+
+/* an unlinked temporary file - removed by the system when closed */
+static ext_run_ty *CreateRunImp(ext_engine_ty *ext)
+{
+	ext_run_ty *run = (ext_run_ty *)malloc(sizeof(ext_run_ty));
+	char *path = NULL;
+	int fd = -1;
+
+	if (NULL == run)
+	{
+		return NULL;
+	}
+
+	run->head = NULL;
+	run->remaining = 0;
+	run->file = NULL;
+
+	if (NULL == ext->dir)
+	{
+		run->file = tmpfile();
+	}
+	else
+	{
+		path = (char *)malloc(strlen(ext->dir) + strlen(EXT_RUN_TEMPLATE) + 1);
+
+		if (NULL != path)
+		{
+			strcpy(path, ext->dir);
+			strcat(path, EXT_RUN_TEMPLATE);
+			fd = mkstemp(path);
+		}
+
+		if (-1 != fd)
+		{
+			unlink(path);
+			run->file = fdopen(fd, "w+b");
+
+			if (NULL == run->file)
+			{
+				close(fd);
+			}
+		}
+
+		free(path);
+	}
+
+	/* records are read and written sequentially in big blocks */
+	if (NULL == run->file ||
+		0 != setvbuf(run->file, NULL, _IOFBF, EXT_IO_BUFFER_SIZE))
+	{
+		CloseRunImp(ext, run);
+		return NULL;
+	}
+
+	return run;
+}
+
+static void CloseRunImp(ext_engine_ty *ext, ext_run_ty *run)
+{
+	UNUSED(ext);
+
+	if (NULL != run->file)
+	{
+		fclose(run->file);
+	}
+
+	DEBUG_MODE
+	(
+		run->file = INVALID_PTR;
+		run->head = INVALID_PTR;
+	)
+	free(run);
+}
+
+/* the head of the first run was dequeued */
+static void AdvanceRunImp(ext_engine_ty *ext)
+{
+	ext_run_ty *run = ext->runs[0];
+
+	if (0 != ReadHeadImp(ext, run))
+	{
+		StallRunImp(ext, 0);
+	}
+	else if (NULL == run->head)
+	{
+		RemoveRunImp(ext, 0);
+	}
+	else
+	{
+		SiftDownImp(ext, (void **)ext->runs, ext->num_runs, 0, CmpRunsImp);
+	}
+}
+
+/* the run at index cannot be read now: it leaves the merge, with its
+	records still counted, until a retry reads its head */
+static void StallRunImp(ext_engine_ty *ext, size_t index)
+{
+	ext_run_ty *run = ext->runs[index];
+
+	RemoveAtImp(ext, (void **)ext->runs, &ext->num_runs, index, CmpRunsImp);
+	ext->stalled[ext->num_stalled] = run;
+	++ext->num_stalled;
+	ext->is_failed = 1;
+}
+
+/* stalled runs whose head can be read now join the merge again */
+static void RetryRunsImp(ext_engine_ty *ext)
+{
+	size_t i = 0;
+
+	if (0 == ext->num_stalled)
+	{
+		return;
+	}
+
+	while (i < ext->num_stalled)
+	{
+		ext_run_ty *run = ext->stalled[i];
+
+		if (0 == fseek(run->file, run->pos, SEEK_SET) &&
+			0 == ReadHeadImp(ext, run))
+		{
+			--ext->num_stalled;
+			ext->stalled[i] = ext->stalled[ext->num_stalled];
+			ext->runs[ext->num_runs] = run;
+			SiftUpImp(ext, (void **)ext->runs, ext->num_runs, CmpRunsImp);
+			++ext->num_runs;
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	UpdateTopImp(ext);
+}
+
+/* head becomes the next record; NULL when the run is over. On failure
+	head is NULL and the record is still counted in remaining; the file
+	position is undefined until it is set back to pos. */
+static int ReadHeadImp(ext_engine_ty *ext, ext_run_ty *run)
+{
+	unsigned char *bigger = NULL;
+	size_t size = 0;
+
+	run->head = NULL;
+
+	if (0 == run->remaining)
+	{
+		return 0;
+	}
+
+	if (1 != fread(&size, sizeof(size), 1, run->file))
+	{
+		return 1;
+	}
+
+	if (size > ext->record_size)
+	{
+		bigger = (unsigned char *)realloc(ext->record, size);
+
+		if (NULL == bigger)
+		{
+			return 1;
+		}
+
+		ext->record = bigger;
+		ext->record_size = size;
+	}
+
+	if (0 < size && 1 != fread(ext->record, size, 1, run->file))
+	{
+		return 1;
+	}
+
+	run->head = ext->deserialize_func(ext->record, size, ext->io_param);
+
+	if (NULL == run->head)
+	{
+		return 1;
+	}
+
+	--run->remaining;
+	run->pos += (long)(sizeof(size) + size);
+
+	return 0;
+}
+
+static int WriteRecordImp(ext_engine_ty *ext, FILE *file, const void *data)
+{
+	unsigned char *bigger = NULL;
+	size_t needed = 0;
+
+	needed = ext->serialize_func(data, ext->record, ext->record_size, ext->io_param);
+
+	/* grow the record buffer and serialize again */
+	if (needed > ext->record_size)
+	{
+		bigger = (unsigned char *)realloc(ext->record, needed);
+
+		if (NULL == bigger)
+		{
+			return 1;
+		}
+
+		ext->record = bigger;
+		ext->record_size = needed;
+		needed = ext->serialize_func(data, ext->record, ext->record_size,
+									 ext->io_param);
+	}
+
+	if (1 != fwrite(&needed, sizeof(needed), 1, file) ||
+		(0 < needed && 1 != fwrite(ext->record, needed, 1, file)))
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+static void ReleaseImp(ext_engine_ty *ext, void *data)
+{
+	if (NULL != data && NULL != ext->release_func)
+	{
+		ext->release_func(data, ext->io_param);
+	}
+}
+
+/* the top is the smaller of the heap top and the first run head */
+static void UpdateTopImp(ext_engine_ty *ext)
+{
+	ext->is_top_in_heap = (0 == ext->num_runs) ||
+						  (0 < ext->heap_size &&
+						   0 >= CmpDataImp(ext, ext->heap[0], ext->runs[0]->head));
+}
+
+static int CmpDataImp(const ext_engine_ty *ext, const void *obj1, const void *obj2)
+{
+	return ext->cmp_func(obj1, obj2, ext->cmp_param);
+}
+
+static int CmpRunsImp(const ext_engine_ty *ext, const void *obj1, const void *obj2)
+{
+	return ext->cmp_func(((const ext_run_ty *)obj1)->head,
+						 ((const ext_run_ty *)obj2)->head, ext->cmp_param);
+}
+
+static void SiftUpImp(const ext_engine_ty *ext, void **heap, size_t index,
+					  ext_cmp_ty cmp_func)
+{
+	void *moving = heap[index];
+	size_t parent = 0;
+
+	while (0 < index)
+	{
+		parent = (index - 1) / 2;
+
+		if (0 <= cmp_func(ext, moving, heap[parent]))
+		{
+			break;
+		}
+
+		heap[index] = heap[parent];
+		index = parent;
+	}
+
+	heap[index] = moving;
+}
+
+static void SiftDownImp(const ext_engine_ty *ext, void **heap, size_t size,
+						size_t index, ext_cmp_ty cmp_func)
+{
+	void *moving = heap[index];
+	size_t child = 0;
+
+	while ((child = 2 * index + 1) < size)
+	{
+		if (child + 1 < size && 0 > cmp_func(ext, heap[child + 1], heap[child]))
+		{
+			++child;
+		}
+
+		if (0 >= cmp_func(ext, moving, heap[child]))
+		{
+			break;
+		}
+
+		heap[index] = heap[child];
+		index = child;
+	}
+
+	heap[index] = moving;
+}
+
+static void HeapifyImp(const ext_engine_ty *ext, void **heap, size_t size,
+					   ext_cmp_ty cmp_func)
+{
+	size_t i = size / 2;
+
+	while (0 < i)
+	{
+		--i;
+		SiftDownImp(ext, heap, size, i, cmp_func);
+	}
+}
+
+/* the last element takes the place of index, then moves up or down */
+static void RemoveAtImp(const ext_engine_ty *ext, void **heap, size_t *size,
+						size_t index, ext_cmp_ty cmp_func)
+{
+	--*size;
+
+	if (index < *size)
+	{
+		heap[index] = heap[*size];
+		SiftUpImp(ext, heap, index, cmp_func);
+		SiftDownImp(ext, heap, *size, index, cmp_func);
+	}
+}
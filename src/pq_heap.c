@@ -0,0 +1,223 @@
+/*******************************************************************************
+*************************** - HEAP PRIORITY QUEUE - ****************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Binary heap engine of pqueue (PQ_ENGINE_HEAP)
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "heap.h"
+#include "pq_engine.h"
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Heap pqueue is not allocated");
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static void DestroyImp(void *engine);
+static int EnqueueImp(void *engine, void *data);
+static size_t EnqueueBatchImp(void *engine, void **items, size_t n);
+static void DequeueImp(void *engine);
+static void *PeekImp(const void *engine);
+static int IsEmptyImp(const void *engine);
+static size_t SizeImp(const void *engine);
+static void ClearImp(void *engine);
+static void *EraseImp(void *engine, PQIsMatch match_func, void *param);
+static int ForEachImp(void *engine, PQVisitFunc visit_func, void *param);
+static void TrackImp(void *engine, pq_tracker_ty *tracker);
+static void *EraseAtImp(void *engine, const pq_handle_ty *handle);
+static size_t EraseIfImp(void *engine, PQIsMatch match_func, void *match_param,
+							PQReleaseFunc out_func, void *out_param);
+static void SetCmpParamImp(void *engine, const void *cmp_param);
+static void MoveImp(void *data, size_t index, void *param);
+
+/* a sorted array is a heap - append is a plain push */
+const pq_engine_ops_ty pq_heap_engine_ops =
+{
+	DestroyImp,
+	EnqueueImp,
+	EnqueueBatchImp,
+	NULL,
+	DequeueImp,
+	PeekImp,
+	IsEmptyImp,
+	SizeImp,
+	ClearImp,
+	EraseImp,
+	ForEachImp,
+	EnqueueImp,
+	TrackImp,
+	EraseAtImp,
+	EraseIfImp,
+	SetCmpParamImp,
+	NULL
+};
+
+
+/*******************************************************************************
+***************************** PQHeapEngine Create *****************************/
+void *PQHeapEngineCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config)
+{
+	UNUSED(config);
+
+	return HeapCreate(cmp_func_p, cmp_param);
+}
+
+/*******************************************************************************
+***************************** Engine Operations *******************************/
+static void DestroyImp(void *engine)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	HeapDestroy((heap_ty *)engine);
+}
+
+static int EnqueueImp(void *engine, void *data)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return HeapPush((heap_ty *)engine, data);
+}
+
+static size_t EnqueueBatchImp(void *engine, void **items, size_t n)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return HeapPushBatch((heap_ty *)engine, items, n);
+}
+
+static void DequeueImp(void *engine)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	HeapPop((heap_ty *)engine);
+}
+
+static void *PeekImp(const void *engine)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return HeapPeek((const heap_ty *)engine);
+}
+
+static int IsEmptyImp(const void *engine)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return HeapIsEmpty((const heap_ty *)engine);
+}
+
+static size_t SizeImp(const void *engine)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return HeapSize((const heap_ty *)engine);
+}
+
+static void ClearImp(void *engine)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	HeapClear((heap_ty *)engine);
+}
+
+static void *EraseImp(void *engine, PQIsMatch match_func, void *param)
+{
+	heap_ty *heap = (heap_ty *)engine;
+	size_t index = 0;
+
+	ASSERT_NOT_NULL_IMP(heap);
+
+	index = HeapFindIf(heap, match_func, param);
+
+	return (index == HeapSize(heap)) ? NULL : HeapRemoveAt(heap, index);
+}
+
+/* pop everything in order, then push it back - a sorted array is a heap */
+static int ForEachImp(void *engine, PQVisitFunc visit_func, void *param)
+{
+	heap_ty *heap = (heap_ty *)engine;
+	size_t size = 0;
+	void **sorted = NULL;
+	size_t i = 0;
+	int status = 0;
+
+	ASSERT_NOT_NULL_IMP(heap);
+
+	size = HeapSize(heap);
+	sorted = (void **)malloc(size * sizeof(void *) + 1);
+
+	if (NULL == sorted)
+	{
+		return 1;
+	}
+
+	for (i = 0; i < size; ++i)
+	{
+		sorted[i] = HeapPop(heap);
+	}
+
+	for (i = 0; 0 == status && i < size; ++i)
+	{
+		status = visit_func(sorted[i], param);
+	}
+
+	/* no reallocation - the memory of the heap is kept */
+	HeapPushBatch(heap, sorted, size);
+	free(sorted);
+
+	return status;
+}
+
+static void TrackImp(void *engine, pq_tracker_ty *tracker)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	if (NULL == tracker)
+	{
+		HeapSetMoveFunc((heap_ty *)engine, NULL, NULL);
+		return;
+	}
+
+	HeapSetMoveFunc((heap_ty *)engine, MoveImp, tracker);
+}
+
+static void *EraseAtImp(void *engine, const pq_handle_ty *handle)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return HeapRemoveAt((heap_ty *)engine, handle->index);
+}
+
+static size_t EraseIfImp(void *engine, PQIsMatch match_func, void *match_param,
+							PQReleaseFunc out_func, void *out_param)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return HeapRemoveIf((heap_ty *)engine, match_func, match_param, out_func, 
+						out_param);
+}
+
+/* heapify again; the tracked indexes follow the moves */
+static void SetCmpParamImp(void *engine, const void *cmp_param)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	HeapSetCmpParam((heap_ty *)engine, cmp_param);
+}
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static void MoveImp(void *data, size_t index, void *param)
+{
+	pq_tracker_ty *tracker = (pq_tracker_ty *)param;
+
+	tracker->handle_func_p(data, tracker->param)->index = index;
+}
@@ -0,0 +1,247 @@
+/*******************************************************************************
+**************************** - PQ INGEST BUFFER - ******************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of a lock-free MPSC staging ring
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free*/
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "pq_ingest.h"
+
+#define CACHE_LINE 64
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Ingest ring is not allocated");
+
+/* Every cell carries a sequence number (bounded queue by D. Vyukov):
+	seq == pos		=> the cell is free for the producer claiming pos
+	seq == pos + 1	=> the cell holds the element published at pos		*/
+typedef struct ingest_cell
+{
+	size_t seq;
+	void *data;
+} ingest_cell_ty;
+
+struct pq_ingest
+{
+	ingest_cell_ty *cells;
+	size_t mask;
+	pqueue_ty *pqueue;
+	void **batch;
+	size_t pending;
+
+	/* producers and consumer positions live on separate cache lines */
+	char pad1[CACHE_LINE];
+	size_t enqueue_pos;
+	char pad2[CACHE_LINE];
+	size_t dequeue_pos;
+	char pad3[CACHE_LINE];
+};
+
+
+/*******************************************************************************
+***************************** PQIngest Create *********************************/
+pq_ingest_ty *PQIngestCreate(pqueue_ty *pqueue, size_t capacity)
+{
+	pq_ingest_ty *ingest = NULL;
+	size_t size = 2;
+	size_t i = 0;
+
+	assert (NULL != pqueue && "PQIngestCreate: pqueue is invalid");
+
+	while (size < capacity)
+	{
+		size *= 2;
+	}
+
+	ingest = (pq_ingest_ty *)malloc(sizeof(pq_ingest_ty));
+
+	if (NULL == ingest)
+	{
+		return NULL;
+	}
+
+	ingest->cells = (ingest_cell_ty *)malloc(size * sizeof(ingest_cell_ty));
+	ingest->batch = (void **)malloc(size * sizeof(void *));
+
+	if (NULL == ingest->cells || NULL == ingest->batch)
+	{
+		free(ingest->cells);
+		free(ingest->batch);
+		free(ingest);
+		return NULL;
+	}
+
+	for (i = 0; i < size; ++i)
+	{
+		ingest->cells[i].seq = i;
+		ingest->cells[i].data = NULL;
+	}
+
+	ingest->mask = size - 1;
+	ingest->pqueue = pqueue;
+	ingest->pending = 0;
+	ingest->enqueue_pos = 0;
+	ingest->dequeue_pos = 0;
+
+	return ingest;
+}
+
+/*******************************************************************************
+***************************** PQIngest Destroy ********************************/
+void PQIngestDestroy(pq_ingest_ty *ingest)
+{
+	ASSERT_NOT_NULL_IMP(ingest);
+
+	free(ingest->cells);
+	free(ingest->batch);
+
+	DEBUG_MODE
+	(
+		ingest->cells = INVALID_PTR;
+		ingest->batch = INVALID_PTR;
+		ingest->pqueue = INVALID_PTR;
+	)
+	free(ingest);
+}
+
+/*******************************************************************************
+***************************** PQIngest Push ***********************************/
+int PQIngestPush(pq_ingest_ty *ingest, void *data)
+{
+	ingest_cell_ty *cell = NULL;
+	size_t pos = 0;
+	size_t seq = 0;
+	long diff = 0;
+
+	ASSERT_NOT_NULL_IMP(ingest);
+
+	pos = __atomic_load_n(&ingest->enqueue_pos, __ATOMIC_RELAXED);
+
+	for (;;)
+	{
+		cell = &ingest->cells[pos & ingest->mask];
+		seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+		diff = (long)seq - (long)pos;
+
+		if (0 == diff)
+		{
+			/* the cell is free; try to claim pos. On failure pos is reloaded */
+			if (__atomic_compare_exchange_n(&ingest->enqueue_pos, &pos, pos + 1,
+							1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				break;
+			}
+		}
+		else if (0 > diff)
+		{
+			/* the consumer did not release this cell yet - ring is full */
+			return 1;
+		}
+		else
+		{
+			/* another producer claimed pos */
+			pos = __atomic_load_n(&ingest->enqueue_pos, __ATOMIC_RELAXED);
+		}
+	}
+
+	cell->data = data;
+
+	/* publish the element to the consumer */
+	__atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** PQIngest Drain **********************************/
+int PQIngestDrain(pq_ingest_ty *ingest)
+{
+	ingest_cell_ty *cell = NULL;
+	size_t pos = 0;
+	size_t merged = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(ingest);
+
+	pos = ingest->dequeue_pos;
+
+	/* collect every published element, batch has room for a full ring */
+	while (ingest->pending <= ingest->mask)
+	{
+		cell = &ingest->cells[pos & ingest->mask];
+
+		if (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) != pos + 1)
+		{
+			break;
+		}
+
+		ingest->batch[ingest->pending++] = cell->data;
+
+		/* release the cell for the producers of the next lap */
+		__atomic_store_n(&cell->seq, pos + ingest->mask + 1, __ATOMIC_RELEASE);
+		++pos;
+	}
+
+	ingest->dequeue_pos = pos;
+
+	if (0 == ingest->pending)
+	{
+		return 0;
+	}
+
+	merged = PQueueEnqueueBatch(ingest->pqueue, ingest->batch, ingest->pending);
+
+	/* keep the elements which were not merged for the next drain */
+	for (i = merged; i < ingest->pending; ++i)
+	{
+		ingest->batch[i - merged] = ingest->batch[i];
+	}
+
+	ingest->pending -= merged;
+
+	return (0 != ingest->pending);
+}
+
+/*******************************************************************************
+***************************** PQIngest Peek ***********************************/
+void *PQIngestPeek(pq_ingest_ty *ingest)
+{
+	ASSERT_NOT_NULL_IMP(ingest);
+
+	PQIngestDrain(ingest);
+
+	if (PQueueIsEmpty(ingest->pqueue))
+	{
+		return NULL;
+	}
+
+	return PQueuePeek(ingest->pqueue);
+}
+
+/*******************************************************************************
+***************************** PQIngest Dequeue ********************************/
+void PQIngestDequeue(pq_ingest_ty *ingest)
+{
+	ASSERT_NOT_NULL_IMP(ingest);
+
+	PQIngestDrain(ingest);
+
+	PQueueDequeue(ingest->pqueue);
+}
+
+/*******************************************************************************
+***************************** PQIngest IsEmpty ********************************/
+int PQIngestIsEmpty(pq_ingest_ty *ingest)
+{
+	ASSERT_NOT_NULL_IMP(ingest);
+
+	PQIngestDrain(ingest);
+
+	return (PQueueIsEmpty(ingest->pqueue) && 0 == ingest->pending);
+}
@@ -0,0 +1,275 @@
+/*******************************************************************************
+************************ - LAZY DELETION PRIORITY QUEUE - **********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of Priority queue with cancel by handle
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "pq_lazy.h"
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Lazy pqueue is not allocated");
+
+/* The engine holds entries; a cancelled entry keeps its place and only its
+	flag changes. Dead entries leave the engine one by one at the top, or
+	all together in a compaction once they are too many, so a cancel costs
+	O(1) and the engine never removes from the middle.					*/
+struct pq_lazy_handle
+{
+	void *data;
+	int is_dead;
+};
+
+struct pq_lazy
+{
+	pqueue_ty *pqueue;
+	size_t size;				/* alive */
+	size_t dead;
+	unsigned int compact_percent;
+	PQCmpFunc cmp_func;
+	const void *cmp_param;
+	PQReleaseFunc release_func;
+	void *release_param;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int CmpEntriesImp(const void *entry1, const void *entry2, const void *param);
+static void DropTopImp(pq_lazy_ty *lazy);
+static void CompactImp(pq_lazy_ty *lazy);
+static int IsDeadImp(const void *entry, const void *param);
+static void ReleaseEntryImp(void *entry, void *param);
+static void ReleaseImp(pq_lazy_ty *lazy, pq_lazy_handle_ty *entry);
+
+/*******************************************************************************
+***************************** PQLazy Create ***********************************/
+pq_lazy_ty *PQLazyCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config, unsigned int compact_percent,
+							PQReleaseFunc release_func_p, void *release_param)
+{
+	pq_lazy_ty *lazy = NULL;
+
+	assert (NULL != cmp_func_p && "PQLazyCreate: Function pointer is invalid");
+	assert (0 < compact_percent && 100 >= compact_percent &&
+			"PQLazyCreate: compact_percent is out of range");
+	assert ((NULL == config || PQ_ENGINE_LIST == config->engine ||
+			 PQ_ENGINE_HEAP == config->engine ||
+			 PQ_ENGINE_SEQHEAP == config->engine) &&
+			"PQLazyCreate: engine does not keep pointers");
+
+	lazy = (pq_lazy_ty *)malloc(sizeof(pq_lazy_ty));
+
+	if (NULL == lazy)
+	{
+		return NULL;
+	}
+
+	lazy->size = 0;
+	lazy->dead = 0;
+	lazy->compact_percent = compact_percent;
+	lazy->cmp_func = cmp_func_p;
+	lazy->cmp_param = cmp_param;
+	lazy->release_func = release_func_p;
+	lazy->release_param = release_param;
+	lazy->pqueue = PQueueCreateEx(CmpEntriesImp, lazy, config);
+
+	if (NULL == lazy->pqueue)
+	{
+		free(lazy);
+		return NULL;
+	}
+
+	return lazy;
+}
+
+/*******************************************************************************
+***************************** PQLazy Destroy **********************************/
+void PQLazyDestroy(pq_lazy_ty *lazy)
+{
+	pq_lazy_handle_ty *entry = NULL;
+
+	ASSERT_NOT_NULL_IMP(lazy);
+
+	while (!PQueueIsEmpty(lazy->pqueue))
+	{
+		entry = (pq_lazy_handle_ty *)PQueuePeek(lazy->pqueue);
+		PQueueDequeue(lazy->pqueue);
+		ReleaseImp(lazy, entry);
+	}
+
+	PQueueDestroy(lazy->pqueue);
+
+	DEBUG_MODE
+	(
+		lazy->pqueue = INVALID_PTR;
+	)
+	free(lazy);
+}
+
+/*******************************************************************************
+***************************** PQLazy Enqueue **********************************/
+pq_lazy_handle_ty *PQLazyEnqueue(pq_lazy_ty *lazy, void *data)
+{
+	pq_lazy_handle_ty *entry = NULL;
+
+	ASSERT_NOT_NULL_IMP(lazy);
+
+	entry = (pq_lazy_handle_ty *)malloc(sizeof(pq_lazy_handle_ty));
+
+	if (NULL == entry)
+	{
+		return NULL;
+	}
+
+	entry->data = data;
+	entry->is_dead = 0;
+
+	if (0 != PQueueEnqueue(lazy->pqueue, entry))
+	{
+		free(entry);
+		return NULL;
+	}
+
+	++lazy->size;
+
+	return entry;
+}
+
+/*******************************************************************************
+***************************** PQLazy Cancel ***********************************/
+void PQLazyCancel(pq_lazy_ty *lazy, pq_lazy_handle_ty *handle)
+{
+	ASSERT_NOT_NULL_IMP(lazy);
+	assert (NULL != handle && !handle->is_dead &&
+			"PQLazyCancel: handle is invalid");
+
+	handle->is_dead = 1;
+	--lazy->size;
+	++lazy->dead;
+
+	if (100 * lazy->dead > lazy->compact_percent * (lazy->size + lazy->dead))
+	{
+		CompactImp(lazy);
+	}
+}
+
+/*******************************************************************************
+***************************** PQLazy Peek *************************************/
+void *PQLazyPeek(pq_lazy_ty *lazy)
+{
+	pq_lazy_handle_ty *top = NULL;
+
+	ASSERT_NOT_NULL_IMP(lazy);
+
+	while (!PQueueIsEmpty(lazy->pqueue))
+	{
+		top = (pq_lazy_handle_ty *)PQueuePeek(lazy->pqueue);
+
+		if (!top->is_dead)
+		{
+			return top->data;
+		}
+
+		DropTopImp(lazy);
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+***************************** PQLazy Dequeue **********************************/
+void *PQLazyDequeue(pq_lazy_ty *lazy)
+{
+	pq_lazy_handle_ty *top = NULL;
+	void *data = NULL;
+
+	ASSERT_NOT_NULL_IMP(lazy);
+
+	if (NULL == PQLazyPeek(lazy))
+	{
+		return NULL;
+	}
+
+	top = (pq_lazy_handle_ty *)PQueuePeek(lazy->pqueue);
+	PQueueDequeue(lazy->pqueue);
+	data = top->data;
+	free(top);
+	--lazy->size;
+
+	return data;
+}
+
+/*******************************************************************************
+***************************** PQLazy Size *************************************/
+size_t PQLazySize(const pq_lazy_ty *lazy)
+{
+	ASSERT_NOT_NULL_IMP(lazy);
+
+	return lazy->size;
+}
+
+/*******************************************************************************
+***************************** PQLazy IsEmpty **********************************/
+int PQLazyIsEmpty(const pq_lazy_ty *lazy)
+{
+	ASSERT_NOT_NULL_IMP(lazy);
+
+	return (0 == lazy->size);
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int CmpEntriesImp(const void *entry1, const void *entry2, const void *param)
+{
+	const pq_lazy_ty *lazy = (const pq_lazy_ty *)param;
+
+	return lazy->cmp_func(((const pq_lazy_handle_ty *)entry1)->data,
+						  ((const pq_lazy_handle_ty *)entry2)->data,
+						  lazy->cmp_param);
+}
+
+static void DropTopImp(pq_lazy_ty *lazy)
+{
+	pq_lazy_handle_ty *top = (pq_lazy_handle_ty *)PQueuePeek(lazy->pqueue);
+
+	PQueueDequeue(lazy->pqueue);
+	--lazy->dead;
+	ReleaseImp(lazy, top);
+}
+
+/* one pass over the engine, which is rebuilt once */
+static void CompactImp(pq_lazy_ty *lazy)
+{
+	PQueueEraseIf(lazy->pqueue, IsDeadImp, lazy, ReleaseEntryImp);
+	lazy->dead = 0;
+}
+
+static int IsDeadImp(const void *entry, const void *param)
+{
+	UNUSED(param);
+
+	return ((const pq_lazy_handle_ty *)entry)->is_dead;
+}
+
+static void ReleaseEntryImp(void *entry, void *param)
+{
+	ReleaseImp((pq_lazy_ty *)param, (pq_lazy_handle_ty *)entry);
+}
+
+static void ReleaseImp(pq_lazy_ty *lazy, pq_lazy_handle_ty *entry)
+{
+	if (NULL != lazy->release_func)
+	{
+		lazy->release_func(entry->data, lazy->release_param);
+	}
+
+	free(entry);
+}
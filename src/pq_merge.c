@@ -0,0 +1,113 @@
+/*******************************************************************************
+************************** - K-WAY MERGE OF STREAMS - **************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of merging sorted streams
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "loser_tree.h"
+#include "pq_merge.h"
+
+#define MERGE_BATCH 64				/* records pulled per stream at once */
+
+typedef struct cursor
+{
+	void **batch;
+	size_t pos;
+	size_t len;
+} cursor_ty;
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static void *NextImp(const pq_stream_ty *stream, cursor_ty *cursor);
+
+/*******************************************************************************
+***************************** PQMergeStreams **********************************/
+int PQMergeStreams(const pq_stream_ty *streams, size_t num_streams,
+					PQCmpFunc cmp_func_p, const void *cmp_param,
+					PQEmitFunc emit_func_p, void *emit_param)
+{
+	loser_tree_ty *tree = NULL;
+	cursor_ty *cursors = NULL;
+	void **batches = NULL;
+	void *top = NULL;
+	size_t s = 0;
+	int status = 0;
+
+	assert ((NULL != streams || 0 == num_streams) && 
+			"PQMergeStreams: streams is invalid");
+	assert (NULL != cmp_func_p && "PQMergeStreams: Function pointer is invalid");
+	assert (NULL != emit_func_p && "PQMergeStreams: Function pointer is invalid");
+
+	tree = LoserTreeCreate(num_streams, cmp_func_p, cmp_param);
+	cursors = (cursor_ty *)malloc(num_streams * sizeof(cursor_ty) + 1);
+	batches = (void **)malloc(num_streams * MERGE_BATCH * sizeof(void *) + 1);
+
+	if (NULL == tree || NULL == cursors || NULL == batches)
+	{
+		if (NULL != tree)
+		{
+			LoserTreeDestroy(tree);
+		}
+
+		free(cursors);
+		free(batches);
+
+		return 1;
+	}
+
+	for (s = 0; s < num_streams; ++s)
+	{
+		cursors[s].batch = batches + s * MERGE_BATCH;
+		cursors[s].pos = 0;
+		cursors[s].len = 0;
+		LoserTreeSet(tree, s, NextImp(&streams[s], &cursors[s]));
+	}
+
+	LoserTreeBuild(tree);
+
+	/* the emitted record is not compared again - emit may free it */
+	while (0 == status && NULL != (top = LoserTreeTop(tree)))
+	{
+		s = LoserTreeWinner(tree);
+		++cursors[s].pos;
+
+		status = emit_func_p(top, emit_param);
+
+		/* a stopped merge does not pull again */
+		if (0 == status)
+		{
+			LoserTreeReplay(tree, NextImp(&streams[s], &cursors[s]));
+		}
+	}
+
+	LoserTreeDestroy(tree);
+	free(cursors);
+	free(batches);
+
+	return status;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+
+/* the head of the stream, pulling the next batch when needed; NULL at end */
+static void *NextImp(const pq_stream_ty *stream, cursor_ty *cursor)
+{
+	if (cursor->pos == cursor->len)
+	{
+		cursor->pos = 0;
+		cursor->len = stream->pull_func_p(cursor->batch, MERGE_BATCH,
+											stream->stream_param);
+	}
+
+	return (cursor->pos < cursor->len) ? cursor->batch[cursor->pos] : NULL;
+}
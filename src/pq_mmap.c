@@ -0,0 +1,517 @@
+/*******************************************************************************
+************************ - MEMORY MAPPED PRIORITY QUEUE - **********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Persistent array heap engine of pqueue (PQ_ENGINE_MMAP)
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L		/* pread, pwrite, ftruncate, msync */
+
+#include <stdlib.h>			/* malloc, free*/
+#include <assert.h>			/* assert */
+#include <string.h>			/* memcpy */
+#include <fcntl.h>			/* open */
+#include <unistd.h>			/* close, pread, pwrite, ftruncate */
+#include <sys/mman.h>		/* mmap, munmap, msync */
+#include <sys/stat.h>		/* fstat */
+
+#include "utilities.h"
+#include "pq_engine.h"
+
+#define MMAP_MAGIC "PQMH"
+#define MMAP_MAGIC_SIZE 4
+#define MMAP_HEADER_SIZE 64
+#define MMAP_INIT_CAPACITY 64
+
+#define ELEMENT_IMP(engine, heap, index)							\
+		((heap) + (index) * (engine)->header->elem_size)
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Mapped pqueue is not allocated");
+
+/* The file holds no pointers, only the heap array of the elements themselves,
+	so it is usable right after it is mapped - at any address.
+
+	+--------+----------------+-----------+-----------+-----+
+	| header | (up to 64 B)   | element 0 | element 1 | ... |
+	+--------+----------------+-----------+-----------+-----+		*/
+typedef struct mmap_header
+{
+	char magic[MMAP_MAGIC_SIZE];
+	size_t header_size;
+	size_t elem_size;
+	size_t capacity;
+	size_t count;
+} mmap_header_ty;
+
+typedef struct mmap_engine
+{
+	int fd;
+	size_t map_size;
+	mmap_header_ty *header;
+	char *heap;
+	char *hole;			/* element being sifted */
+	char *erased;		/* returned by erase */
+	PQCmpFunc cmp_func;
+	const void *cmp_param;
+} mmap_engine_ty;
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int FormatImp(int fd, const pq_config_ty *config);
+static int MapImp(mmap_engine_ty *mmap_engine, size_t map_size);
+static int GrowImp(mmap_engine_ty *mmap_engine);
+static void SiftUpImp(mmap_engine_ty *mmap_engine, char *heap, size_t index);
+static void SiftDownImp(mmap_engine_ty *mmap_engine, char *heap, size_t count,
+						size_t index);
+static void PopImp(mmap_engine_ty *mmap_engine, char *heap, size_t count);
+
+static void DestroyImp(void *engine);
+static int EnqueueImp(void *engine, void *data);
+static void DequeueImp(void *engine);
+static void *PeekImp(const void *engine);
+static int IsEmptyImp(const void *engine);
+static size_t SizeImp(const void *engine);
+static void ClearImp(void *engine);
+static void *EraseImp(void *engine, PQIsMatch match_func, void *param);
+static int ForEachImp(void *engine, PQVisitFunc visit_func, void *param);
+static void SetCmpParamImp(void *engine, const void *cmp_param);
+
+const pq_engine_ops_ty pq_mmap_engine_ops =
+{
+	DestroyImp,
+	EnqueueImp,
+	NULL,
+	NULL,
+	DequeueImp,
+	PeekImp,
+	IsEmptyImp,
+	SizeImp,
+	ClearImp,
+	EraseImp,
+	ForEachImp,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	SetCmpParamImp,
+	NULL
+};
+
+
+/*******************************************************************************
+***************************** PQMmapEngine Create *****************************/
+void *PQMmapEngineCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config)
+{
+	mmap_engine_ty *mmap_engine = NULL;
+	mmap_header_ty header;
+	struct stat st;
+	size_t elem_size = 0;
+
+	assert (NULL != config && NULL != config->path &&
+			"PQMmapEngineCreate: path is invalid");
+
+	mmap_engine = (mmap_engine_ty *)malloc(sizeof(mmap_engine_ty));
+
+	if (NULL == mmap_engine)
+	{
+		return NULL;
+	}
+
+	mmap_engine->cmp_func = cmp_func_p;
+	mmap_engine->cmp_param = cmp_param;
+	mmap_engine->header = NULL;
+	mmap_engine->hole = NULL;
+	mmap_engine->erased = NULL;
+	mmap_engine->fd = open(config->path, O_RDWR | O_CREAT, 0644);
+
+	if (-1 == mmap_engine->fd)
+	{
+		free(mmap_engine);
+		return NULL;
+	}
+
+	/* a new file gets an empty heap */
+	if (0 != fstat(mmap_engine->fd, &st) ||
+		(0 == st.st_size && 0 != FormatImp(mmap_engine->fd, config)) ||
+		(ssize_t)sizeof(header) != pread(mmap_engine->fd, &header, sizeof(header), 0))
+	{
+		DestroyImp(mmap_engine);
+		return NULL;
+	}
+
+	elem_size = (0 == config->elem_size) ? header.elem_size : config->elem_size;
+
+	/* reject a foreign file instead of reading garbage as elements */
+	if (0 != memcmp(header.magic, MMAP_MAGIC, MMAP_MAGIC_SIZE) ||
+		MMAP_HEADER_SIZE != header.header_size ||
+		0 == header.elem_size || elem_size != header.elem_size ||
+		header.count > header.capacity ||
+		0 != MapImp(mmap_engine, MMAP_HEADER_SIZE +
+								 header.capacity * header.elem_size))
+	{
+		DestroyImp(mmap_engine);
+		return NULL;
+	}
+
+	mmap_engine->hole = (char *)malloc(elem_size);
+	mmap_engine->erased = (char *)malloc(elem_size);
+
+	if (NULL == mmap_engine->hole || NULL == mmap_engine->erased)
+	{
+		DestroyImp(mmap_engine);
+		return NULL;
+	}
+
+	return mmap_engine;
+}
+
+
+/*******************************************************************************
+***************************** Engine Operations *******************************/
+static void DestroyImp(void *engine)
+{
+	mmap_engine_ty *mmap_engine = (mmap_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(mmap_engine);
+
+	/* the file is kept for the next open */
+	if (NULL != mmap_engine->header)
+	{
+		msync(mmap_engine->header, mmap_engine->map_size, MS_SYNC);
+		munmap(mmap_engine->header, mmap_engine->map_size);
+	}
+
+	close(mmap_engine->fd);
+	free(mmap_engine->hole);
+	free(mmap_engine->erased);
+
+	DEBUG_MODE
+	(
+		mmap_engine->header = INVALID_PTR;
+		mmap_engine->heap = INVALID_PTR;
+		mmap_engine->hole = INVALID_PTR;
+		mmap_engine->erased = INVALID_PTR;
+	)
+	free(mmap_engine);
+}
+
+static int EnqueueImp(void *engine, void *data)
+{
+	mmap_engine_ty *mmap_engine = (mmap_engine_ty *)engine;
+	mmap_header_ty *header = NULL;
+
+	ASSERT_NOT_NULL_IMP(mmap_engine);
+
+	if (mmap_engine->header->count == mmap_engine->header->capacity &&
+		0 != GrowImp(mmap_engine))
+	{
+		return 1;
+	}
+
+	header = mmap_engine->header;
+
+	memcpy(mmap_engine->hole, data, header->elem_size);
+	SiftUpImp(mmap_engine, mmap_engine->heap, header->count);
+	++header->count;
+
+	return 0;
+}
+
+static void DequeueImp(void *engine)
+{
+	mmap_engine_ty *mmap_engine = (mmap_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(mmap_engine);
+	assert (0 < mmap_engine->header->count && "PQueueDequeue: pqueue is empty");
+
+	PopImp(mmap_engine, mmap_engine->heap, mmap_engine->header->count);
+	--mmap_engine->header->count;
+}
+
+static void *PeekImp(const void *engine)
+{
+	const mmap_engine_ty *mmap_engine = (const mmap_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(mmap_engine);
+
+	return (0 == mmap_engine->header->count) ? NULL : mmap_engine->heap;
+}
+
+static int IsEmptyImp(const void *engine)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return (0 == SizeImp(engine));
+}
+
+static size_t SizeImp(const void *engine)
+{
+	const mmap_engine_ty *mmap_engine = (const mmap_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(mmap_engine);
+
+	return mmap_engine->header->count;
+}
+
+static void ClearImp(void *engine)
+{
+	mmap_engine_ty *mmap_engine = (mmap_engine_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(mmap_engine);
+
+	mmap_engine->header->count = 0;
+}
+
+static void *EraseImp(void *engine, PQIsMatch match_func, void *param)
+{
+	mmap_engine_ty *mmap_engine = (mmap_engine_ty *)engine;
+	char *heap = NULL;
+	size_t elem_size = 0;
+	size_t last = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(mmap_engine);
+
+	heap = mmap_engine->heap;
+	elem_size = mmap_engine->header->elem_size;
+
+	for (i = 0; i < mmap_engine->header->count; ++i)
+	{
+		if (match_func(ELEMENT_IMP(mmap_engine, heap, i), param))
+		{
+			break;
+		}
+	}
+
+	if (i == mmap_engine->header->count)
+	{
+		return NULL;
+	}
+
+	memcpy(mmap_engine->erased, ELEMENT_IMP(mmap_engine, heap, i), elem_size);
+
+	/* the last element takes its place, then moves up or down */
+	last = --mmap_engine->header->count;
+
+	if (i < last)
+	{
+		memcpy(mmap_engine->hole, ELEMENT_IMP(mmap_engine, heap, last), elem_size);
+		SiftUpImp(mmap_engine, heap, i);
+		memcpy(mmap_engine->hole, ELEMENT_IMP(mmap_engine, heap, i), elem_size);
+		SiftDownImp(mmap_engine, heap, last, i);
+	}
+
+	return mmap_engine->erased;
+}
+
+/* the heap is ordered only partially - pop from a private copy */
+static int ForEachImp(void *engine, PQVisitFunc visit_func, void *param)
+{
+	mmap_engine_ty *mmap_engine = (mmap_engine_ty *)engine;
+	size_t elem_size = 0;
+	size_t count = 0;
+	char *heap = NULL;
+	int status = 0;
+
+	ASSERT_NOT_NULL_IMP(mmap_engine);
+
+	elem_size = mmap_engine->header->elem_size;
+	count = mmap_engine->header->count;
+	heap = (char *)malloc(count * elem_size + 1);
+
+	if (NULL == heap)
+	{
+		return 1;
+	}
+
+	memcpy(heap, mmap_engine->heap, count * elem_size);
+
+	for (; 0 == status && 0 < count; --count)
+	{
+		memcpy(mmap_engine->erased, heap, elem_size);
+		PopImp(mmap_engine, heap, count);
+		status = visit_func(mmap_engine->erased, param);
+	}
+
+	free(heap);
+
+	return status;
+}
+
+/* bottom up heapify in the file */
+static void SetCmpParamImp(void *engine, const void *cmp_param)
+{
+	mmap_engine_ty *mmap_engine = (mmap_engine_ty *)engine;
+	size_t count = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(mmap_engine);
+
+	mmap_engine->cmp_param = cmp_param;
+	count = mmap_engine->header->count;
+	i = count / 2;
+
+	while (0 < i)
+	{
+		--i;
+		memcpy(mmap_engine->hole, ELEMENT_IMP(mmap_engine, mmap_engine->heap, i),
+			   mmap_engine->header->elem_size);
+		SiftDownImp(mmap_engine, mmap_engine->heap, count, i);
+	}
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int FormatImp(int fd, const pq_config_ty *config)
+{
+	mmap_header_ty header;
+	size_t capacity = config->capacity;
+
+	if (0 == config->elem_size)
+	{
+		return 1;
+	}
+
+	capacity = (0 == capacity) ? MMAP_INIT_CAPACITY : capacity;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MMAP_MAGIC, MMAP_MAGIC_SIZE);
+	header.header_size = MMAP_HEADER_SIZE;
+	header.elem_size = config->elem_size;
+	header.capacity = capacity;
+	header.count = 0;
+
+	if (0 != ftruncate(fd, (off_t)(MMAP_HEADER_SIZE + capacity * config->elem_size)) ||
+		(ssize_t)sizeof(header) != pwrite(fd, &header, sizeof(header), 0))
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+static int MapImp(mmap_engine_ty *mmap_engine, size_t map_size)
+{
+	struct stat st;
+	void *map = NULL;
+
+	/* a truncated file would fault on access */
+	if (0 != fstat(mmap_engine->fd, &st) || (size_t)st.st_size < map_size)
+	{
+		return 1;
+	}
+
+	map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+			   mmap_engine->fd, 0);
+
+	if (MAP_FAILED == map)
+	{
+		return 1;
+	}
+
+	mmap_engine->header = (mmap_header_ty *)map;
+	mmap_engine->heap = (char *)map + MMAP_HEADER_SIZE;
+	mmap_engine->map_size = map_size;
+
+	return 0;
+}
+
+/* double the file and map it again */
+static int GrowImp(mmap_engine_ty *mmap_engine)
+{
+	size_t capacity = mmap_engine->header->capacity * 2;
+	size_t map_size = MMAP_HEADER_SIZE + capacity * mmap_engine->header->elem_size;
+	mmap_header_ty *old_header = mmap_engine->header;
+	size_t old_size = mmap_engine->map_size;
+
+	if (0 != ftruncate(mmap_engine->fd, (off_t)map_size))
+	{
+		return 1;
+	}
+
+	/* the old mapping stays valid until the new one exists */
+	if (0 != MapImp(mmap_engine, map_size))
+	{
+		ftruncate(mmap_engine->fd, (off_t)old_size);
+		return 1;
+	}
+
+	munmap(old_header, old_size);
+	mmap_engine->header->capacity = capacity;
+
+	return 0;
+}
+
+/* place hole at index, moving bigger parents down */
+static void SiftUpImp(mmap_engine_ty *mmap_engine, char *heap, size_t index)
+{
+	size_t elem_size = mmap_engine->header->elem_size;
+	size_t parent = 0;
+
+	while (0 < index)
+	{
+		parent = (index - 1) / 2;
+
+		if (0 <= mmap_engine->cmp_func(mmap_engine->hole,
+									   ELEMENT_IMP(mmap_engine, heap, parent),
+									   mmap_engine->cmp_param))
+		{
+			break;
+		}
+
+		memcpy(ELEMENT_IMP(mmap_engine, heap, index),
+			   ELEMENT_IMP(mmap_engine, heap, parent), elem_size);
+		index = parent;
+	}
+
+	memcpy(ELEMENT_IMP(mmap_engine, heap, index), mmap_engine->hole, elem_size);
+}
+
+/* place hole at index of a heap of count elements, moving smaller children up */
+static void SiftDownImp(mmap_engine_ty *mmap_engine, char *heap, size_t count,
+						size_t index)
+{
+	size_t elem_size = mmap_engine->header->elem_size;
+	size_t child = 0;
+
+	while ((child = 2 * index + 1) < count)
+	{
+		if (child + 1 < count &&
+			0 > mmap_engine->cmp_func(ELEMENT_IMP(mmap_engine, heap, child + 1),
+									  ELEMENT_IMP(mmap_engine, heap, child),
+									  mmap_engine->cmp_param))
+		{
+			++child;
+		}
+
+		if (0 >= mmap_engine->cmp_func(mmap_engine->hole,
+									   ELEMENT_IMP(mmap_engine, heap, child),
+									   mmap_engine->cmp_param))
+		{
+			break;
+		}
+
+		memcpy(ELEMENT_IMP(mmap_engine, heap, index),
+			   ELEMENT_IMP(mmap_engine, heap, child), elem_size);
+		index = child;
+	}
+
+	memcpy(ELEMENT_IMP(mmap_engine, heap, index), mmap_engine->hole, elem_size);
+}
+
+/* remove the root of a heap of count elements */
+static void PopImp(mmap_engine_ty *mmap_engine, char *heap, size_t count)
+{
+	if (1 < count)
+	{
+		memcpy(mmap_engine->hole, ELEMENT_IMP(mmap_engine, heap, count - 1),
+			   mmap_engine->header->elem_size);
+		SiftDownImp(mmap_engine, heap, count - 1, 0);
+	}
+}
@@ -0,0 +1,769 @@
+/*******************************************************************************
+************************* - SEQUENCE HEAP PRIORITY QUEUE - *********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Sequence heap engine of pqueue (PQ_ENGINE_SEQHEAP)
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+#include <string.h>			/* memmove */
+
+#include "utilities.h"
+#include "heap.h"
+#include "loser_tree.h"
+#include "pq_engine.h"
+
+#define SEQ_INSERT_SIZE 256			/* insertion heap and group buffers */
+#define SEQ_GROUP_WIDTH 16			/* sequences per group */
+#define SEQ_MAX_GROUPS 8
+#define SEQ_FROM_INSERT SEQ_MAX_GROUPS		/* top is in the insertion heap */
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Sequence heap is not allocated");
+
+/* After Sanders, "Fast priority queues for cached memory".
+	New elements go to a small insertion heap. A full insertion heap is
+	sorted into a sequence of group 0; a full group is merged into one
+	sequence of the next group, so group g holds sequences of about
+	SEQ_INSERT_SIZE * SEQ_GROUP_WIDTH^g elements. Each group merges its
+	sequences through a loser tree into a small sorted buffer, and a top
+	loser tree picks the smallest buffer head. All the work is sequential
+	scans over arrays, with a few hot cache lines per level.			*/
+typedef struct seq
+{
+	void **items;			/* NULL - free slot */
+	size_t pos;
+	size_t len;
+} seq_ty;
+
+typedef struct group
+{
+	seq_ty seqs[SEQ_GROUP_WIDTH];
+	loser_tree_ty *tree;	/* by the heads of seqs */
+	void **buffer;			/* sorted, not bigger than any sequence element */
+	size_t buf_pos;
+	size_t buf_len;
+	size_t count;			/* buffer and sequences */
+} group_ty;
+
+typedef struct seqheap
+{
+	heap_ty *insert;
+	group_ty groups[SEQ_MAX_GROUPS];
+	loser_tree_ty *top;		/* by the heads of the buffers */
+	size_t top_source;		/* group of the top, or SEQ_FROM_INSERT */
+	size_t count;
+	PQCmpFunc cmp_func;
+	const void *cmp_param;
+} seqheap_ty;
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int FlushInsertImp(seqheap_ty *seqheap);
+static int AddSequenceImp(seqheap_ty *seqheap, size_t g, void **items, size_t len);
+static void **MergeGroupImp(seqheap_ty *seqheap, size_t g);
+static void SetSequenceImp(group_ty *group, size_t slot, void **items, size_t len);
+static size_t FreeSlotImp(group_ty *group);
+static void ReloadGroupImp(seqheap_ty *seqheap, size_t g);
+static void RefillImp(group_ty *group);
+static void *HeadImp(const group_ty *group);
+static void UpdateTopImp(seqheap_ty *seqheap);
+static void ReleaseGroupImp(group_ty *group);
+static int RemoveIfImp(void **items, size_t *len, size_t pos,
+						PQIsMatch match_func, void *param, void **removed);
+static size_t FilterImp(void **items, size_t *len, size_t pos, 
+						PQIsMatch match_func, void *match_param,
+						PQReleaseFunc out_func, void *out_param);
+
+static void DestroyImp(void *engine);
+static int EnqueueImp(void *engine, void *data);
+static void DequeueImp(void *engine);
+static void *PeekImp(const void *engine);
+static int IsEmptyImp(const void *engine);
+static size_t SizeImp(const void *engine);
+static void ClearImp(void *engine);
+static void *EraseImp(void *engine, PQIsMatch match_func, void *param);
+static int ForEachImp(void *engine, PQVisitFunc visit_func, void *param);
+static size_t EraseIfImp(void *engine, PQIsMatch match_func, void *match_param,
+							PQReleaseFunc out_func, void *out_param);
+
+const pq_engine_ops_ty pq_seqheap_engine_ops =
+{
+	DestroyImp,
+	EnqueueImp,
+	NULL,
+	NULL,
+	DequeueImp,
+	PeekImp,
+	IsEmptyImp,
+	SizeImp,
+	ClearImp,
+	EraseImp,
+	ForEachImp,
+	EnqueueImp,
+	NULL,
+	NULL,
+	EraseIfImp,
+	NULL,
+	NULL
+};
+
+
+/*******************************************************************************
+***************************** PQSeqHeapEngine Create **************************/
+void *PQSeqHeapEngineCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config)
+{
+	seqheap_ty *seqheap = NULL;
+	int status = 0;
+	size_t g = 0;
+	size_t i = 0;
+
+	UNUSED(config);
+
+	seqheap = (seqheap_ty *)malloc(sizeof(seqheap_ty));
+
+	if (NULL == seqheap)
+	{
+		return NULL;
+	}
+
+	seqheap->top_source = SEQ_FROM_INSERT;
+	seqheap->count = 0;
+	seqheap->cmp_func = cmp_func_p;
+	seqheap->cmp_param = cmp_param;
+	seqheap->insert = HeapCreate(cmp_func_p, cmp_param);
+	seqheap->top = LoserTreeCreate(SEQ_MAX_GROUPS, cmp_func_p, cmp_param);
+	status = (NULL == seqheap->insert || NULL == seqheap->top);
+
+	for (g = 0; g < SEQ_MAX_GROUPS; ++g)
+	{
+		group_ty *group = &seqheap->groups[g];
+
+		for (i = 0; i < SEQ_GROUP_WIDTH; ++i)
+		{
+			group->seqs[i].items = NULL;
+		}
+
+		group->buf_pos = 0;
+		group->buf_len = 0;
+		group->count = 0;
+		group->tree = LoserTreeCreate(SEQ_GROUP_WIDTH, cmp_func_p, cmp_param);
+		group->buffer = (void **)malloc(SEQ_INSERT_SIZE * sizeof(void *));
+		status = status || (NULL == group->tree || NULL == group->buffer);
+	}
+
+	if (0 != status)
+	{
+		DestroyImp(seqheap);
+		return NULL;
+	}
+
+	return seqheap;
+}
+
+
+/*******************************************************************************
+***************************** Engine Operations *******************************/
+static void DestroyImp(void *engine)
+{
+	seqheap_ty *seqheap = (seqheap_ty *)engine;
+	size_t g = 0;
+
+	ASSERT_NOT_NULL_IMP(seqheap);
+
+	for (g = 0; g < SEQ_MAX_GROUPS; ++g)
+	{
+		group_ty *group = &seqheap->groups[g];
+
+		ReleaseGroupImp(group);
+
+		if (NULL != group->tree)
+		{
+			LoserTreeDestroy(group->tree);
+		}
+
+		free(group->buffer);
+	}
+
+	if (NULL != seqheap->insert)
+	{
+		HeapDestroy(seqheap->insert);
+	}
+
+	if (NULL != seqheap->top)
+	{
+		LoserTreeDestroy(seqheap->top);
+	}
+
+	DEBUG_MODE
+	(
+		seqheap->insert = INVALID_PTR;
+		seqheap->top = INVALID_PTR;
+	)
+	free(seqheap);
+}
+
+static int EnqueueImp(void *engine, void *data)
+{
+	seqheap_ty *seqheap = (seqheap_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(seqheap);
+
+	if (SEQ_INSERT_SIZE == HeapSize(seqheap->insert) &&
+		0 != FlushInsertImp(seqheap))
+	{
+		return 1;
+	}
+
+	if (0 != HeapPush(seqheap->insert, data))
+	{
+		return 1;
+	}
+
+	++seqheap->count;
+	UpdateTopImp(seqheap);
+
+	return 0;
+}
+
+static void DequeueImp(void *engine)
+{
+	seqheap_ty *seqheap = (seqheap_ty *)engine;
+	group_ty *group = NULL;
+
+	ASSERT_NOT_NULL_IMP(seqheap);
+	assert (0 < seqheap->count && "PQueueDequeue: pqueue is empty");
+
+	/* the top may be freed by now - it is not compared again */
+	if (SEQ_FROM_INSERT == seqheap->top_source)
+	{
+		HeapPop(seqheap->insert);
+	}
+	else
+	{
+		group = &seqheap->groups[seqheap->top_source];
+
+		++group->buf_pos;
+		--group->count;
+
+		if (group->buf_pos == group->buf_len)
+		{
+			RefillImp(group);
+		}
+
+		LoserTreeReplay(seqheap->top, HeadImp(group));
+	}
+
+	--seqheap->count;
+	UpdateTopImp(seqheap);
+}
+
+static void *PeekImp(const void *engine)
+{
+	const seqheap_ty *seqheap = (const seqheap_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(seqheap);
+
+	if (SEQ_FROM_INSERT == seqheap->top_source)
+	{
+		return HeapPeek(seqheap->insert);
+	}
+
+	return HeadImp(&seqheap->groups[seqheap->top_source]);
+}
+
+static int IsEmptyImp(const void *engine)
+{
+	ASSERT_NOT_NULL_IMP(engine);
+
+	return (0 == SizeImp(engine));
+}
+
+static size_t SizeImp(const void *engine)
+{
+	const seqheap_ty *seqheap = (const seqheap_ty *)engine;
+
+	ASSERT_NOT_NULL_IMP(seqheap);
+
+	return seqheap->count;
+}
+
+static void ClearImp(void *engine)
+{
+	seqheap_ty *seqheap = (seqheap_ty *)engine;
+	size_t g = 0;
+
+	ASSERT_NOT_NULL_IMP(seqheap);
+
+	HeapClear(seqheap->insert);
+
+	for (g = 0; g < SEQ_MAX_GROUPS; ++g)
+	{
+		ReleaseGroupImp(&seqheap->groups[g]);
+		ReloadGroupImp(seqheap, g);
+	}
+
+	seqheap->count = 0;
+	seqheap->top_source = SEQ_FROM_INSERT;
+}
+
+static void *EraseImp(void *engine, PQIsMatch match_func, void *param)
+{
+	seqheap_ty *seqheap = (seqheap_ty *)engine;
+	void *removed = NULL;
+	size_t index = 0;
+	size_t g = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(seqheap);
+
+	index = HeapFindIf(seqheap->insert, match_func, param);
+
+	if (index < HeapSize(seqheap->insert))
+	{
+		removed = HeapRemoveAt(seqheap->insert, index);
+	}
+
+	/* removing from a sorted array keeps it sorted */
+	for (g = 0; NULL == removed && g < SEQ_MAX_GROUPS; ++g)
+	{
+		group_ty *group = &seqheap->groups[g];
+
+		if (RemoveIfImp(group->buffer, &group->buf_len, group->buf_pos,
+						match_func, param, &removed))
+		{
+			--group->count;
+			ReloadGroupImp(seqheap, g);
+		}
+
+		for (i = 0; NULL == removed && i < SEQ_GROUP_WIDTH; ++i)
+		{
+			seq_ty *seq = &group->seqs[i];
+
+			if (NULL != seq->items &&
+				RemoveIfImp(seq->items, &seq->len, seq->pos, match_func,
+							param, &removed))
+			{
+				--group->count;
+
+				if (seq->pos == seq->len)
+				{
+					SetSequenceImp(group, i, NULL, 0);
+				}
+
+				ReloadGroupImp(seqheap, g);
+			}
+		}
+	}
+
+	if (NULL != removed)
+	{
+		--seqheap->count;
+		UpdateTopImp(seqheap);
+	}
+
+	return removed;
+}
+
+/* filtering a sorted array keeps it sorted - one reload per group */
+static size_t EraseIfImp(void *engine, PQIsMatch match_func, void *match_param,
+							PQReleaseFunc out_func, void *out_param)
+{
+	seqheap_ty *seqheap = (seqheap_ty *)engine;
+	size_t removed = 0;
+	size_t in_group = 0;
+	size_t g = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(seqheap);
+
+	removed = HeapRemoveIf(seqheap->insert, match_func, match_param, out_func, 
+							out_param);
+
+	for (g = 0; g < SEQ_MAX_GROUPS; ++g)
+	{
+		group_ty *group = &seqheap->groups[g];
+
+		in_group = FilterImp(group->buffer, &group->buf_len, group->buf_pos,
+							 match_func, match_param, out_func, out_param);
+
+		for (i = 0; i < SEQ_GROUP_WIDTH; ++i)
+		{
+			seq_ty *seq = &group->seqs[i];
+
+			if (NULL == seq->items)
+			{
+				continue;
+			}
+
+			in_group += FilterImp(seq->items, &seq->len, seq->pos, match_func,
+								  match_param, out_func, out_param);
+
+			if (seq->pos == seq->len)
+			{
+				SetSequenceImp(group, i, NULL, 0);
+			}
+		}
+
+		if (0 < in_group)
+		{
+			group->count -= in_group;
+			removed += in_group;
+			ReloadGroupImp(seqheap, g);
+		}
+	}
+
+	seqheap->count -= removed;
+	UpdateTopImp(seqheap);
+
+	return removed;
+}
+
+/* dequeue everything in order, then keep it as one sorted sequence */
+static int ForEachImp(void *engine, PQVisitFunc visit_func, void *param)
+{
+	seqheap_ty *seqheap = (seqheap_ty *)engine;
+	size_t count = 0;
+	void **sorted = NULL;
+	size_t i = 0;
+	int status = 0;
+
+	ASSERT_NOT_NULL_IMP(seqheap);
+
+	count = seqheap->count;
+	sorted = (void **)malloc(count * sizeof(void *) + 1);
+
+	if (NULL == sorted)
+	{
+		return 1;
+	}
+
+	for (i = 0; i < count; ++i)
+	{
+		sorted[i] = PeekImp(seqheap);
+		DequeueImp(seqheap);
+	}
+
+	for (i = 0; 0 == status && i < count; ++i)
+	{
+		status = visit_func(sorted[i], param);
+	}
+
+	/* every group is empty - no merge, no allocation */
+	if (0 < count)
+	{
+		SetSequenceImp(&seqheap->groups[SEQ_MAX_GROUPS - 1], 0, sorted, count);
+		seqheap->groups[SEQ_MAX_GROUPS - 1].count = count;
+		ReloadGroupImp(seqheap, SEQ_MAX_GROUPS - 1);
+		seqheap->count = count;
+		UpdateTopImp(seqheap);
+	}
+	else
+	{
+		free(sorted);
+	}
+
+	return status;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+
+/* sort the insertion heap into a new sequence of group 0 */
+static int FlushInsertImp(seqheap_ty *seqheap)
+{
+	size_t len = HeapSize(seqheap->insert);
+	void **items = (void **)malloc(len * sizeof(void *));
+	size_t i = 0;
+
+	if (NULL == items)
+	{
+		return 1;
+	}
+
+	for (i = 0; i < len; ++i)
+	{
+		items[i] = HeapPop(seqheap->insert);
+	}
+
+	if (0 != AddSequenceImp(seqheap, 0, items, len))
+	{
+		/* a sorted array is a heap - nothing to allocate */
+		HeapPushBatch(seqheap->insert, items, len);
+		free(items);
+
+		return 1;
+	}
+
+	return 0;
+}
+
+/* takes items on success */
+static int AddSequenceImp(seqheap_ty *seqheap, size_t g, void **items, size_t len)
+{
+	group_ty *group = &seqheap->groups[g];
+	void **merged = NULL;
+	size_t merged_len = 0;
+	size_t slot = FreeSlotImp(group);
+	size_t rest = 0;
+	size_t i = 0;
+	size_t j = 0;
+	size_t k = 0;
+
+	/* a full group moves up as one sequence; kept in place if it cannot */
+	if (SEQ_GROUP_WIDTH == slot)
+	{
+		merged_len = group->count;
+		merged = MergeGroupImp(seqheap, g);
+
+		if (NULL == merged)
+		{
+			return 1;
+		}
+
+		if (g + 1 == SEQ_MAX_GROUPS ||
+			0 != AddSequenceImp(seqheap, g + 1, merged, merged_len))
+		{
+			SetSequenceImp(group, 0, merged, merged_len);
+			group->count = merged_len;
+		}
+
+		slot = FreeSlotImp(group);
+	}
+
+	/* the buffer must not hold anything bigger than the new elements */
+	rest = group->buf_len - group->buf_pos;
+	merged = (void **)malloc((len + rest) * sizeof(void *));
+
+	if (NULL == merged)
+	{
+		ReloadGroupImp(seqheap, g);
+		return 1;
+	}
+
+	for (i = group->buf_pos, j = 0, k = 0; i < group->buf_len || j < len; ++k)
+	{
+		if (j == len || (i < group->buf_len &&
+			0 >= seqheap->cmp_func(group->buffer[i], items[j], seqheap->cmp_param)))
+		{
+			merged[k] = group->buffer[i++];
+		}
+		else
+		{
+			merged[k] = items[j++];
+		}
+	}
+
+	free(items);
+	group->buf_pos = 0;
+	group->buf_len = 0;
+	group->count += len;
+
+	SetSequenceImp(group, slot, merged, len + rest);
+	ReloadGroupImp(seqheap, g);
+
+	return 0;
+}
+
+/* all the elements of group g as one array; the group is left empty */
+static void **MergeGroupImp(seqheap_ty *seqheap, size_t g)
+{
+	group_ty *group = &seqheap->groups[g];
+	void **merged = (void **)malloc(group->count * sizeof(void *) + 1);
+	size_t k = 0;
+
+	if (NULL == merged)
+	{
+		return NULL;
+	}
+
+	/* the buffer is first, then the merge of the sequences */
+	while (group->buf_pos < group->buf_len)
+	{
+		merged[k++] = group->buffer[group->buf_pos++];
+	}
+
+	while (NULL != LoserTreeTop(group->tree))
+	{
+		size_t s = LoserTreeWinner(group->tree);
+		seq_ty *seq = &group->seqs[s];
+
+		merged[k++] = seq->items[seq->pos++];
+		LoserTreeReplay(group->tree, (seq->pos < seq->len) ? seq->items[seq->pos] : NULL);
+	}
+
+	ReleaseGroupImp(group);
+	LoserTreeSet(seqheap->top, g, NULL);
+
+	return merged;
+}
+
+/* items NULL frees the slot */
+static void SetSequenceImp(group_ty *group, size_t slot, void **items, size_t len)
+{
+	seq_ty *seq = &group->seqs[slot];
+
+	free(seq->items);
+	seq->items = items;
+	seq->pos = 0;
+	seq->len = len;
+}
+
+static size_t FreeSlotImp(group_ty *group)
+{
+	size_t i = 0;
+
+	while (i < SEQ_GROUP_WIDTH && NULL != group->seqs[i].items)
+	{
+		++i;
+	}
+
+	return i;
+}
+
+/* after the sequences of group g changed: its tree, buffer and top key */
+static void ReloadGroupImp(seqheap_ty *seqheap, size_t g)
+{
+	group_ty *group = &seqheap->groups[g];
+	seq_ty *seq = NULL;
+	size_t i = 0;
+
+	for (i = 0; i < SEQ_GROUP_WIDTH; ++i)
+	{
+		seq = &group->seqs[i];
+		LoserTreeSet(group->tree, i, (NULL == seq->items) ? NULL : seq->items[seq->pos]);
+	}
+
+	LoserTreeBuild(group->tree);
+
+	if (group->buf_pos == group->buf_len)
+	{
+		RefillImp(group);
+	}
+
+	LoserTreeSet(seqheap->top, g, HeadImp(group));
+	LoserTreeBuild(seqheap->top);
+}
+
+/* merge the next elements of the sequences into the empty buffer */
+static void RefillImp(group_ty *group)
+{
+	seq_ty *seq = NULL;
+	size_t s = 0;
+
+	group->buf_pos = 0;
+	group->buf_len = 0;
+
+	while (SEQ_INSERT_SIZE > group->buf_len && NULL != LoserTreeTop(group->tree))
+	{
+		s = LoserTreeWinner(group->tree);
+		seq = &group->seqs[s];
+
+		group->buffer[group->buf_len++] = seq->items[seq->pos++];
+
+		if (seq->pos == seq->len)
+		{
+			free(seq->items);
+			seq->items = NULL;
+			LoserTreeReplay(group->tree, NULL);
+		}
+		else
+		{
+			LoserTreeReplay(group->tree, seq->items[seq->pos]);
+		}
+	}
+}
+
+static void *HeadImp(const group_ty *group)
+{
+	return (group->buf_pos < group->buf_len) ? group->buffer[group->buf_pos] : NULL;
+}
+
+/* the smaller of the insertion heap top and the top tree winner */
+static void UpdateTopImp(seqheap_ty *seqheap)
+{
+	void *insert_top = HeapPeek(seqheap->insert);
+	void *group_top = LoserTreeTop(seqheap->top);
+
+	seqheap->top_source = SEQ_FROM_INSERT;
+
+	if (NULL != group_top && (NULL == insert_top ||
+		0 < seqheap->cmp_func(insert_top, group_top, seqheap->cmp_param)))
+	{
+		seqheap->top_source = LoserTreeWinner(seqheap->top);
+	}
+}
+
+static void ReleaseGroupImp(group_ty *group)
+{
+	size_t i = 0;
+
+	for (i = 0; i < SEQ_GROUP_WIDTH; ++i)
+	{
+		free(group->seqs[i].items);
+		group->seqs[i].items = NULL;
+		group->seqs[i].pos = 0;
+		group->seqs[i].len = 0;
+	}
+
+	group->buf_pos = 0;
+	group->buf_len = 0;
+	group->count = 0;
+}
+
+/* remove the first match in items[pos, len) */
+static int RemoveIfImp(void **items, size_t *len, size_t pos,
+						PQIsMatch match_func, void *param, void **removed)
+{
+	size_t i = pos;
+
+	while (i < *len && !match_func(items[i], param))
+	{
+		++i;
+	}
+
+	if (i == *len)
+	{
+		return 0;
+	}
+
+	*removed = items[i];
+	memmove(items + i, items + i + 1, (*len - i - 1) * sizeof(void *));
+	--*len;
+
+	return 1;
+}
+
+/* keep the elements of items[pos, len) that do not match, in order */
+static size_t FilterImp(void **items, size_t *len, size_t pos, 
+						PQIsMatch match_func, void *match_param,
+						PQReleaseFunc out_func, void *out_param)
+{
+	size_t kept = pos;
+	size_t removed = 0;
+	size_t i = 0;
+
+	for (i = pos; i < *len; ++i)
+	{
+		if (match_func(items[i], match_param))
+		{
+			out_func(items[i], out_param);
+		}
+		else
+		{
+			items[kept] = items[i];
+			++kept;
+		}
+	}
+
+	removed = *len - kept;
+	*len = kept;
+
+	return removed;
+}
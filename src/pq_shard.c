@@ -0,0 +1,402 @@
+/*******************************************************************************
+*************************** - SHARDED PRIORITY QUEUE - *************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of a NUMA aware sharded priority queue
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _GNU_SOURCE			/* syscall, SYS_getcpu */
+
+#include <stdlib.h>			/* malloc, free, posix_memalign */
+#include <assert.h>			/* assert */
+#include <limits.h>			/* LONG_MAX */
+#include <stdio.h>			/* fopen, fgets */
+#include <ctype.h>			/* isdigit */
+#include <pthread.h>		/* pthread_mutex_t */
+#include <unistd.h>			/* syscall */
+#include <sys/syscall.h>	/* SYS_getcpu */
+
+#include "utilities.h"
+#include "pqueue.h"
+#include "pq_shard.h"
+
+#define CACHE_LINE 64
+#define EMPTY_KEY LONG_MAX
+#define MAX_DETECTED_NODES 1024
+#define NODES_PATH "/sys/devices/system/node/possible"
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Sharded pqueue is not allocated");
+
+typedef struct shard
+{
+	pthread_mutex_t lock;
+	pqueue_ty *pqueue;
+
+	/* key of the top element, EMPTY_KEY when empty. Written under lock,
+		read by other nodes without it */
+	long top_key;
+	int is_empty;
+} shard_ty;
+
+struct pq_shard
+{
+	shard_ty **shards;
+	size_t num_nodes;
+	PQShardKeyFunc key_func;
+	const void *key_param;
+	PQShardNodeFunc current_node;
+	void *node_param;
+	long threshold;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int ShardCmpImp(const void *data1, const void *data2, const void *param);
+static void PublishTopImp(pq_shard_ty *pq_shard, shard_ty *shard);
+static void *TakeTopImp(pq_shard_ty *pq_shard, shard_ty *shard);
+static void DestroyShardsImp(pq_shard_ty *pq_shard, size_t count);
+static size_t DetectNumNodesImp(void);
+static size_t DetectCurrentNodeImp(void *node_param);
+
+/*******************************************************************************
+***************************** PQShard Create **********************************/
+pq_shard_ty *PQShardCreate(PQShardKeyFunc key_func, const void *key_param,
+							const pq_shard_topology_ty *topology, long threshold)
+{
+	pq_shard_ty *pq_shard = NULL;
+	shard_ty *shard = NULL;
+	size_t i = 0;
+
+	assert (NULL != key_func && "PQShardCreate: Function pointer is invalid");
+	assert (0 <= threshold && "PQShardCreate: threshold is negative");
+
+	pq_shard = (pq_shard_ty *)malloc(sizeof(pq_shard_ty));
+
+	if (NULL == pq_shard)
+	{
+		return NULL;
+	}
+
+	pq_shard->key_func = key_func;
+	pq_shard->key_param = key_param;
+	pq_shard->threshold = threshold;
+
+	if (NULL == topology)
+	{
+		pq_shard->num_nodes = DetectNumNodesImp();
+		pq_shard->current_node = DetectCurrentNodeImp;
+		pq_shard->node_param = pq_shard;
+	}
+	else
+	{
+		assert (0 < topology->num_nodes && NULL != topology->current_node);
+
+		pq_shard->num_nodes = topology->num_nodes;
+		pq_shard->current_node = topology->current_node;
+		pq_shard->node_param = topology->node_param;
+	}
+
+	pq_shard->shards = (shard_ty **)malloc(pq_shard->num_nodes * sizeof(shard_ty *));
+
+	if (NULL == pq_shard->shards)
+	{
+		free(pq_shard);
+		return NULL;
+	}
+
+	for (i = 0; i < pq_shard->num_nodes; ++i)
+	{
+		/* every shard on its own cache lines, no false sharing between nodes */
+		if (0 != posix_memalign((void **)&shard, CACHE_LINE,
+								sizeof(shard_ty) + CACHE_LINE))
+		{
+			DestroyShardsImp(pq_shard, i);
+			return NULL;
+		}
+
+		shard->pqueue = PQueueCreate(ShardCmpImp, pq_shard);
+
+		if (NULL == shard->pqueue)
+		{
+			free(shard);
+			DestroyShardsImp(pq_shard, i);
+			return NULL;
+		}
+
+		pthread_mutex_init(&shard->lock, NULL);
+		shard->top_key = EMPTY_KEY;
+		shard->is_empty = 1;
+
+		pq_shard->shards[i] = shard;
+	}
+
+	return pq_shard;
+}
+
+/*******************************************************************************
+***************************** PQShard Destroy *********************************/
+void PQShardDestroy(pq_shard_ty *pq_shard)
+{
+	ASSERT_NOT_NULL_IMP(pq_shard);
+
+	DestroyShardsImp(pq_shard, pq_shard->num_nodes);
+}
+
+/*******************************************************************************
+***************************** PQShard Enqueue *********************************/
+int PQShardEnqueue(pq_shard_ty *pq_shard, void *data)
+{
+	shard_ty *local = NULL;
+	int status = 0;
+
+	ASSERT_NOT_NULL_IMP(pq_shard);
+
+	local = pq_shard->shards[pq_shard->current_node(pq_shard->node_param)];
+
+	pthread_mutex_lock(&local->lock);
+
+	status = PQueueEnqueue(local->pqueue, data);
+
+	if (0 == status)
+	{
+		PublishTopImp(pq_shard, local);
+	}
+
+	pthread_mutex_unlock(&local->lock);
+
+	return status;
+}
+
+/*******************************************************************************
+***************************** PQShard Dequeue *********************************/
+void *PQShardDequeue(pq_shard_ty *pq_shard)
+{
+	shard_ty *local = NULL;
+	shard_ty *remote = NULL;
+	size_t local_node = 0;
+	long local_key = 0;
+	long remote_key = 0;
+	long best_key = 0;
+	int is_local_empty = 0;
+	size_t i = 0;
+	void *data = NULL;
+
+	ASSERT_NOT_NULL_IMP(pq_shard);
+
+	local_node = pq_shard->current_node(pq_shard->node_param);
+	assert (local_node < pq_shard->num_nodes);
+	local = pq_shard->shards[local_node];
+
+	for (;;)
+	{
+		pthread_mutex_lock(&local->lock);
+
+		is_local_empty = local->is_empty;
+		local_key = local->top_key;
+
+		/* look for a remote top which is ahead by more than the threshold.
+			Only the published keys are read, remote shards are not locked */
+		remote = NULL;
+		best_key = EMPTY_KEY;
+
+		for (i = 0; i < pq_shard->num_nodes; ++i)
+		{
+			if (i == local_node ||
+				__atomic_load_n(&pq_shard->shards[i]->is_empty, __ATOMIC_ACQUIRE))
+			{
+				continue;
+			}
+
+			remote_key = __atomic_load_n(&pq_shard->shards[i]->top_key,
+										 __ATOMIC_RELAXED);
+
+			if (!is_local_empty && !(remote_key < local_key &&
+				(unsigned long)local_key - (unsigned long)remote_key >
+				(unsigned long)pq_shard->threshold))
+			{
+				continue;
+			}
+
+			if (NULL == remote || remote_key < best_key)
+			{
+				remote = pq_shard->shards[i];
+				best_key = remote_key;
+			}
+		}
+
+		if (NULL == remote)
+		{
+			data = is_local_empty ? NULL : TakeTopImp(pq_shard, local);
+			pthread_mutex_unlock(&local->lock);
+
+			return data;
+		}
+
+		/* never hold two shard locks together */
+		pthread_mutex_unlock(&local->lock);
+
+		pthread_mutex_lock(&remote->lock);
+		data = remote->is_empty ? NULL : TakeTopImp(pq_shard, remote);
+		pthread_mutex_unlock(&remote->lock);
+
+		if (NULL != data)
+		{
+			return data;
+		}
+
+		/* the remote shard was emptied meanwhile - look again */
+	}
+}
+
+/*******************************************************************************
+***************************** PQShard Size ************************************/
+size_t PQShardSize(pq_shard_ty *pq_shard)
+{
+	size_t size = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(pq_shard);
+
+	for (i = 0; i < pq_shard->num_nodes; ++i)
+	{
+		pthread_mutex_lock(&pq_shard->shards[i]->lock);
+		size += PQueueSize(pq_shard->shards[i]->pqueue);
+		pthread_mutex_unlock(&pq_shard->shards[i]->lock);
+	}
+
+	return size;
+}
+
+/*******************************************************************************
+***************************** PQShard NumNodes ********************************/
+size_t PQShardNumNodes(const pq_shard_ty *pq_shard)
+{
+	ASSERT_NOT_NULL_IMP(pq_shard);
+
+	return pq_shard->num_nodes;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int ShardCmpImp(const void *data1, const void *data2, const void *param)
+{
+	const pq_shard_ty *pq_shard = (const pq_shard_ty *)param;
+	long key1 = pq_shard->key_func(data1, pq_shard->key_param);
+	long key2 = pq_shard->key_func(data2, pq_shard->key_param);
+
+	return ((key1 > key2) - (key1 < key2));
+}
+
+/* called with the shard lock held */
+static void PublishTopImp(pq_shard_ty *pq_shard, shard_ty *shard)
+{
+	if (PQueueIsEmpty(shard->pqueue))
+	{
+		__atomic_store_n(&shard->is_empty, 1, __ATOMIC_RELEASE);
+		__atomic_store_n(&shard->top_key, EMPTY_KEY, __ATOMIC_RELAXED);
+	}
+	else
+	{
+		__atomic_store_n(&shard->top_key,
+				pq_shard->key_func(PQueuePeek(shard->pqueue), pq_shard->key_param),
+				__ATOMIC_RELAXED);
+		__atomic_store_n(&shard->is_empty, 0, __ATOMIC_RELEASE);
+	}
+}
+
+/* called with the shard lock held, shard is not empty */
+static void *TakeTopImp(pq_shard_ty *pq_shard, shard_ty *shard)
+{
+	void *data = PQueuePeek(shard->pqueue);
+
+	PQueueDequeue(shard->pqueue);
+	PublishTopImp(pq_shard, shard);
+
+	return data;
+}
+
+static void DestroyShardsImp(pq_shard_ty *pq_shard, size_t count)
+{
+	size_t i = 0;
+
+	for (i = 0; i < count; ++i)
+	{
+		PQueueDestroy(pq_shard->shards[i]->pqueue);
+		pthread_mutex_destroy(&pq_shard->shards[i]->lock);
+		free(pq_shard->shards[i]);
+	}
+
+	free(pq_shard->shards);
+
+	DEBUG_MODE
+	(
+		pq_shard->shards = INVALID_PTR;
+	)
+	free(pq_shard);
+}
+
+/* node ids may be sparse ("0,2", "0-3,8-11"): one shard per id up to the
+	highest, the ones of missing nodes stay empty */
+static size_t DetectNumNodesImp(void)
+{
+	char line[256] = {0};
+	size_t max_id = 0;
+	size_t id = 0;
+	FILE *file = fopen(NODES_PATH, "r");
+	char *runner = line;
+
+	/* no sysfs - one node machine */
+	if (NULL == file)
+	{
+		return 1;
+	}
+
+	if (NULL == fgets(line, sizeof(line), file))
+	{
+		line[0] = '\0';
+	}
+
+	fclose(file);
+
+	while ('\0' != *runner)
+	{
+		if (!isdigit((unsigned char)*runner))
+		{
+			++runner;
+			continue;
+		}
+
+		for (id = 0; isdigit((unsigned char)*runner); ++runner)
+		{
+			id = id * 10 + (size_t)(*runner - '0');
+
+			if (MAX_DETECTED_NODES <= id)
+			{
+				id = MAX_DETECTED_NODES - 1;
+			}
+		}
+
+		max_id = (id > max_id) ? id : max_id;
+	}
+
+	return max_id + 1;
+}
+
+static size_t DetectCurrentNodeImp(void *node_param)
+{
+	pq_shard_ty *pq_shard = (pq_shard_ty *)node_param;
+	unsigned cpu = 0;
+	unsigned node = 0;
+
+	if (0 != syscall(SYS_getcpu, &cpu, &node, NULL))
+	{
+		return 0;
+	}
+
+	return (node < pq_shard->num_nodes) ? node : 0;
+}
@@ -0,0 +1,452 @@
+/*******************************************************************************
+************************* - SHARED MEMORY PRIORITY QUEUE - *********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of an inter-process priority queue
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L		/* robust process-shared mutex */
+
+#include <stdlib.h>			/* malloc, free*/
+#include <assert.h>			/* assert */
+#include <string.h>			/* memcpy */
+#include <errno.h>			/* EOWNERDEAD */
+#include <pthread.h>		/* pthread_mutex_t */
+
+#include "utilities.h"
+#include "pq_shm.h"
+
+#define SHM_MAGIC 0x5051534DUL		/* "PQSM" */
+#define SHM_ALIGN 64
+#define ROUND_UP(size, align) 	(((size) + (align) - 1) / (align) * (align))
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Shared pqueue is not attached");
+
+/* Nothing inside the region holds a pointer, every reference is an offset
+	from the region base, so each process may map it at another address.
+
+	+--------+------------------------+--------+--------+-----+
+	| header | heap (slot offsets)    | slot 0 | slot 1 | ... |
+	+--------+------------------------+--------+--------+-----+		*/
+typedef struct shm_header
+{
+	unsigned long magic;
+	size_t capacity;
+	size_t elem_size;
+	size_t slot_size;
+	size_t heap_offset;
+	size_t slots_offset;
+	size_t count;
+	size_t free_head;		/* 0 when there are no free slots */
+	pthread_mutex_t lock;
+} shm_header_ty;
+
+/* the payload follows the slot header */
+typedef struct shm_slot
+{
+	size_t in_use;
+	size_t next_free;
+} shm_slot_ty;
+
+struct pq_shm
+{
+	char *base;
+	shm_header_ty *header;
+	size_t *heap;
+	PQCmpFunc cmp_func;
+	const void *cmp_param;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int LockImp(pq_shm_ty *pq_shm);
+static void UnlockImp(pq_shm_ty *pq_shm);
+static void RecoverImp(pq_shm_ty *pq_shm);
+static shm_slot_ty *SlotImp(pq_shm_ty *pq_shm, size_t offset);
+static void *PayloadImp(pq_shm_ty *pq_shm, size_t offset);
+static int IsBeforeImp(pq_shm_ty *pq_shm, size_t offset1, size_t offset2);
+static void SiftUpImp(pq_shm_ty *pq_shm, size_t index);
+static void SiftDownImp(pq_shm_ty *pq_shm, size_t index);
+
+/*******************************************************************************
+***************************** PQShm RegionSize ********************************/
+size_t PQShmRegionSize(size_t capacity, size_t elem_size)
+{
+	size_t slot_size = ROUND_UP(sizeof(shm_slot_ty) + elem_size, sizeof(shm_slot_ty));
+
+	return ROUND_UP(sizeof(shm_header_ty), SHM_ALIGN) +
+		   ROUND_UP(capacity * sizeof(size_t), SHM_ALIGN) +
+		   capacity * slot_size;
+}
+
+/*******************************************************************************
+***************************** PQShm Format ************************************/
+int PQShmFormat(void *region, size_t region_size, size_t capacity, size_t elem_size)
+{
+	shm_header_ty *header = (shm_header_ty *)region;
+	pthread_mutexattr_t attr;
+	shm_slot_ty *slot = NULL;
+	size_t offset = 0;
+	size_t i = 0;
+	int status = 0;
+
+	assert (NULL != region && "PQShmFormat: region is invalid");
+	assert (0 < capacity && 0 < elem_size);
+
+	if (region_size < PQShmRegionSize(capacity, elem_size))
+	{
+		return 1;
+	}
+
+	header->capacity = capacity;
+	header->elem_size = elem_size;
+	header->slot_size = ROUND_UP(sizeof(shm_slot_ty) + elem_size, sizeof(shm_slot_ty));
+	header->heap_offset = ROUND_UP(sizeof(shm_header_ty), SHM_ALIGN);
+	header->slots_offset = header->heap_offset +
+							ROUND_UP(capacity * sizeof(size_t), SHM_ALIGN);
+	header->count = 0;
+
+	/* chain all the slots into the free list, the last one ends it */
+	header->free_head = header->slots_offset;
+
+	for (i = 0; i < capacity; ++i)
+	{
+		offset = header->slots_offset + i * header->slot_size;
+		slot = (shm_slot_ty *)((char *)region + offset);
+
+		slot->in_use = 0;
+		slot->next_free = (i + 1 < capacity) ? offset + header->slot_size : 0;
+	}
+
+	/* a lock held by a process which died is handed over to the next one */
+	status |= pthread_mutexattr_init(&attr);
+	status |= pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	status |= pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+	status |= pthread_mutex_init(&header->lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	if (0 != status)
+	{
+		return 1;
+	}
+
+	/* publish last; the release store orders every field above before the
+		magic, for a process which attaches on another CPU */
+	__atomic_store_n(&header->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** PQShm Attach ************************************/
+pq_shm_ty *PQShmAttach(void *region, PQCmpFunc cmp_func_p, const void *cmp_param)
+{
+	pq_shm_ty *pq_shm = NULL;
+	shm_header_ty *header = (shm_header_ty *)region;
+
+	assert (NULL != region && "PQShmAttach: region is invalid");
+	assert (NULL != cmp_func_p && "PQShmAttach: Function pointer is invalid");
+
+	/* pairs with the release store in PQShmFormat */
+	if (SHM_MAGIC != __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE))
+	{
+		return NULL;
+	}
+
+	pq_shm = (pq_shm_ty *)malloc(sizeof(pq_shm_ty));
+
+	if (NULL == pq_shm)
+	{
+		return NULL;
+	}
+
+	pq_shm->base = (char *)region;
+	pq_shm->header = header;
+	pq_shm->heap = (size_t *)(pq_shm->base + header->heap_offset);
+	pq_shm->cmp_func = cmp_func_p;
+	pq_shm->cmp_param = cmp_param;
+
+	return pq_shm;
+}
+
+/*******************************************************************************
+***************************** PQShm Detach ************************************/
+void PQShmDetach(pq_shm_ty *pq_shm)
+{
+	ASSERT_NOT_NULL_IMP(pq_shm);
+
+	DEBUG_MODE
+	(
+		pq_shm->base = INVALID_PTR;
+		pq_shm->header = INVALID_PTR;
+		pq_shm->heap = INVALID_PTR;
+	)
+	free(pq_shm);
+}
+
+/*******************************************************************************
+***************************** PQShm Enqueue ***********************************/
+int PQShmEnqueue(pq_shm_ty *pq_shm, const void *data)
+{
+	shm_header_ty *header = NULL;
+	shm_slot_ty *slot = NULL;
+	size_t offset = 0;
+
+	ASSERT_NOT_NULL_IMP(pq_shm);
+	assert (NULL != data);
+
+	header = pq_shm->header;
+
+	if (0 != LockImp(pq_shm))
+	{
+		return 1;
+	}
+
+	if (0 == header->free_head)
+	{
+		UnlockImp(pq_shm);
+		return 1;
+	}
+
+	offset = header->free_head;
+	slot = SlotImp(pq_shm, offset);
+	header->free_head = slot->next_free;
+
+	memcpy(PayloadImp(pq_shm, offset), data, header->elem_size);
+
+	/* from here on a recovery will find the element */
+	slot->in_use = 1;
+
+	pq_shm->heap[header->count] = offset;
+	++header->count;
+	SiftUpImp(pq_shm, header->count - 1);
+
+	UnlockImp(pq_shm);
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** PQShm Dequeue ***********************************/
+int PQShmDequeue(pq_shm_ty *pq_shm, void *out)
+{
+	shm_header_ty *header = NULL;
+	shm_slot_ty *slot = NULL;
+	size_t offset = 0;
+
+	ASSERT_NOT_NULL_IMP(pq_shm);
+
+	header = pq_shm->header;
+
+	if (0 != LockImp(pq_shm))
+	{
+		return 1;
+	}
+
+	if (0 == header->count)
+	{
+		UnlockImp(pq_shm);
+		return 1;
+	}
+
+	offset = pq_shm->heap[0];
+
+	if (NULL != out)
+	{
+		memcpy(out, PayloadImp(pq_shm, offset), header->elem_size);
+	}
+
+	--header->count;
+	pq_shm->heap[0] = pq_shm->heap[header->count];
+	SiftDownImp(pq_shm, 0);
+
+	/* release the slot last; until then a recovery keeps the element */
+	slot = SlotImp(pq_shm, offset);
+	slot->in_use = 0;
+	slot->next_free = header->free_head;
+	header->free_head = offset;
+
+	UnlockImp(pq_shm);
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** PQShm Peek **************************************/
+int PQShmPeek(pq_shm_ty *pq_shm, void *out)
+{
+	int status = 0;
+
+	ASSERT_NOT_NULL_IMP(pq_shm);
+	assert (NULL != out);
+
+	if (0 != LockImp(pq_shm))
+	{
+		return 1;
+	}
+
+	if (0 == pq_shm->header->count)
+	{
+		status = 1;
+	}
+	else
+	{
+		memcpy(out, PayloadImp(pq_shm, pq_shm->heap[0]), pq_shm->header->elem_size);
+	}
+
+	UnlockImp(pq_shm);
+
+	return status;
+}
+
+/*******************************************************************************
+***************************** PQShm Size **************************************/
+size_t PQShmSize(pq_shm_ty *pq_shm)
+{
+	size_t count = 0;
+
+	ASSERT_NOT_NULL_IMP(pq_shm);
+
+	if (0 != LockImp(pq_shm))
+	{
+		return 0;
+	}
+
+	count = pq_shm->header->count;
+
+	UnlockImp(pq_shm);
+
+	return count;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int LockImp(pq_shm_ty *pq_shm)
+{
+	int status = pthread_mutex_lock(&pq_shm->header->lock);
+
+	/* the previous owner died while holding the lock */
+	if (EOWNERDEAD == status)
+	{
+		RecoverImp(pq_shm);
+		status = pthread_mutex_consistent(&pq_shm->header->lock);
+	}
+
+	return status;
+}
+
+static void UnlockImp(pq_shm_ty *pq_shm)
+{
+	pthread_mutex_unlock(&pq_shm->header->lock);
+}
+
+/* Rebuild the free list and the heap from the in_use flags of the slots;
+	they are the only state which is always consistent */
+static void RecoverImp(pq_shm_ty *pq_shm)
+{
+	shm_header_ty *header = pq_shm->header;
+	shm_slot_ty *slot = NULL;
+	size_t offset = 0;
+	size_t i = 0;
+
+	header->count = 0;
+	header->free_head = 0;
+
+	for (i = header->capacity; 0 < i; --i)
+	{
+		offset = header->slots_offset + (i - 1) * header->slot_size;
+		slot = SlotImp(pq_shm, offset);
+
+		if (slot->in_use)
+		{
+			pq_shm->heap[header->count++] = offset;
+		}
+		else
+		{
+			slot->next_free = header->free_head;
+			header->free_head = offset;
+		}
+	}
+
+	/* heapify */
+	for (i = header->count / 2; 0 < i; --i)
+	{
+		SiftDownImp(pq_shm, i - 1);
+	}
+}
+
+static shm_slot_ty *SlotImp(pq_shm_ty *pq_shm, size_t offset)
+{
+	return (shm_slot_ty *)(pq_shm->base + offset);
+}
+
+static void *PayloadImp(pq_shm_ty *pq_shm, size_t offset)
+{
+	return pq_shm->base + offset + sizeof(shm_slot_ty);
+}
+
+static int IsBeforeImp(pq_shm_ty *pq_shm, size_t offset1, size_t offset2)
+{
+	return (0 > pq_shm->cmp_func(PayloadImp(pq_shm, offset1),
+								 PayloadImp(pq_shm, offset2), pq_shm->cmp_param));
+}
+
+static void SiftUpImp(pq_shm_ty *pq_shm, size_t index)
+{
+	size_t *heap = pq_shm->heap;
+	size_t offset = heap[index];
+	size_t parent = 0;
+
+	while (0 < index)
+	{
+		parent = (index - 1) / 2;
+
+		if (!IsBeforeImp(pq_shm, offset, heap[parent]))
+		{
+			break;
+		}
+
+		heap[index] = heap[parent];
+		index = parent;
+	}
+
+	heap[index] = offset;
+}
+
+static void SiftDownImp(pq_shm_ty *pq_shm, size_t index)
+{
+	size_t *heap = pq_shm->heap;
+	size_t count = pq_shm->header->count;
+	size_t offset = 0;
+	size_t child = 0;
+
+	if (index >= count)
+	{
+		return;
+	}
+
+	offset = heap[index];
+
+	while ((child = 2 * index + 1) < count)
+	{
+		if (child + 1 < count && IsBeforeImp(pq_shm, heap[child + 1], heap[child]))
+		{
+			++child;
+		}
+
+		if (!IsBeforeImp(pq_shm, heap[child], offset))
+		{
+			break;
+		}
+
+		heap[index] = heap[child];
+		index = child;
+	}
+
+	heap[index] = offset;
+}
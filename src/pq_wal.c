@@ -0,0 +1,843 @@
+/*******************************************************************************
+************************** - DURABLE PRIORITY QUEUE - **************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of a write-ahead log for a priority queue
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L		/* fsync, fdatasync, ftruncate */
+
+#include <stdlib.h>			/* malloc, free, realloc */
+#include <assert.h>			/* assert */
+#include <string.h>			/* memcpy, memcmp, strlen, strcpy, strcat */
+#include <stdio.h>			/* FILE, fopen, fread, rename */
+#include <errno.h>			/* errno, EINTR */
+#include <fcntl.h>			/* open */
+#include <unistd.h>			/* write, fsync, ftruncate */
+
+#include "utilities.h"
+#include "pq_wal.h"
+
+#define LOG_MAGIC "PQW1"
+#define MAGIC_SIZE 4
+#define GENERATION_SIZE 8
+#define LOG_HEADER_SIZE (MAGIC_SIZE + GENERATION_SIZE)
+#define TYPE_SIZE 1
+#define LENGTH_SIZE 4
+#define CHECKSUM_SIZE 4
+#define RECORD_OVERHEAD (TYPE_SIZE + LENGTH_SIZE + CHECKSUM_SIZE)
+#define MAX_IMAGE_SIZE 0xFFFFFFFFUL		/* fits in LENGTH_SIZE bytes */
+#define INIT_BUFFER_SIZE 256
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "WAL is not open");
+
+/* Log file:	magic | generation | record | record | ...
+	record:		type | payload length | payload | checksum(type .. payload)
+
+	A snapshot starts with the generation it was taken at; a log whose
+	generation differs from the snapshot's one is older and ignored.
+	Dequeue and Erase records hold the image of the removed element, so
+	replay removes the same one whatever the tie order of the engine.
+	A record is made, and its room reserved, before pqueue is changed:
+	an operation which cannot be logged is not done.					*/
+typedef enum record_type
+{
+	RECORD_ENQUEUE = 'E',
+	RECORD_DEQUEUE = 'D',
+	RECORD_ERASE = 'R'
+} record_type_ty;
+
+typedef struct byte_buffer
+{
+	unsigned char *bytes;
+	size_t size;
+	size_t capacity;
+} byte_buffer_ty;
+
+struct pq_wal
+{
+	pqueue_ty *pqueue;
+	pq_wal_cfg_ty cfg;
+	char *log_path;
+	char *snap_path;
+	char *tmp_path;
+	int log_fd;
+	size_t generation;
+	size_t log_bytes;
+	size_t pending_ops;
+	byte_buffer_ty pending;		/* records which are not committed yet */
+	byte_buffer_ty image;		/* scratch for serialized elements */
+	int is_broken;				/* the log may miss records; until compacted */
+	int is_refused;				/* an operation was not done since the sync */
+};
+
+typedef struct image_match
+{
+	pq_wal_ty *wal;
+	const unsigned char *image;
+	size_t size;
+} image_match_ty;
+
+/* PQWalErase: the match of the user, once its record can be made */
+typedef struct erase_match
+{
+	pq_wal_ty *wal;
+	PQIsMatch match_func;
+	void *param;
+	int is_failed;
+} erase_match_ty;
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int LoadSnapshotImp(pq_wal_ty *wal);
+static int ReplayLogImp(pq_wal_ty *wal, size_t *valid_end);
+static int ApplyRecordImp(pq_wal_ty *wal, int type, const unsigned char *payload,
+							size_t size);
+static int CommitImp(pq_wal_ty *wal);
+static int ResetLogImp(pq_wal_ty *wal, size_t generation);
+static int PrepareRecordImp(pq_wal_ty *wal, const void *data);
+static int AppendRecordImp(pq_wal_ty *wal, int type);
+static int SerializeImp(pq_wal_ty *wal, const void *data);
+static int IsSameImageImp(const void *element_data, const void *param);
+static int IsLoggedMatchImp(const void *element_data, const void *param);
+static int ReserveImp(byte_buffer_ty *buffer, size_t size);
+static int WriteAllImp(int fd, const void *src, size_t size);
+static int ReadAllImp(int fd, void *dest, size_t size);
+static int SyncDirImp(const char *path);
+static char *ConcatImp(const char *path, const char *suffix);
+static void ReleaseImp(pq_wal_ty *wal, void *data);
+static void FreeWalImp(pq_wal_ty *wal);
+static unsigned long ChecksumImp(const unsigned char *bytes, size_t size);
+static void EncodeImp(unsigned char *dest, size_t value, size_t num_bytes);
+static size_t DecodeImp(const unsigned char *src, size_t num_bytes);
+
+/*******************************************************************************
+***************************** PQWal Open **************************************/
+pq_wal_ty *PQWalOpen(pqueue_ty *pqueue, const pq_wal_cfg_ty *cfg)
+{
+	pq_wal_ty *wal = NULL;
+	size_t valid_end = 0;
+
+	assert (NULL != pqueue && "PQWalOpen: pqueue is invalid");
+	assert (NULL != cfg && NULL != cfg->path);
+	assert (NULL != cfg->serialize_func_p && NULL != cfg->deserialize_func_p);
+	assert (PQueueIsEmpty(pqueue) && "PQWalOpen: pqueue is not empty");
+
+	wal = (pq_wal_ty *)calloc(1, sizeof(pq_wal_ty));
+
+	if (NULL == wal)
+	{
+		return NULL;
+	}
+
+	wal->pqueue = pqueue;
+	wal->cfg = *cfg;
+	wal->cfg.group_commit = (0 == cfg->group_commit) ? 1 : cfg->group_commit;
+	wal->log_fd = -1;
+	wal->log_path = ConcatImp(cfg->path, ".log");
+	wal->snap_path = ConcatImp(cfg->path, ".snap");
+	wal->tmp_path = ConcatImp(cfg->path, ".snap.tmp");
+
+	if (NULL == wal->log_path || NULL == wal->snap_path || NULL == wal->tmp_path ||
+		0 != LoadSnapshotImp(wal) || 0 != ReplayLogImp(wal, &valid_end))
+	{
+		FreeWalImp(wal);
+		return NULL;
+	}
+
+	wal->log_fd = open(wal->log_path, O_RDWR | O_CREAT, 0644);
+
+	if (-1 == wal->log_fd)
+	{
+		FreeWalImp(wal);
+		return NULL;
+	}
+
+	if (0 == valid_end)
+	{
+		/* no log for the current snapshot yet */
+		if (0 != ResetLogImp(wal, wal->generation))
+		{
+			FreeWalImp(wal);
+			return NULL;
+		}
+	}
+	else
+	{
+		/* drop a torn record; new records go right after the valid ones */
+		if (0 != ftruncate(wal->log_fd, (off_t)valid_end) ||
+			(off_t)-1 == lseek(wal->log_fd, (off_t)valid_end, SEEK_SET))
+		{
+			FreeWalImp(wal);
+			return NULL;
+		}
+
+		wal->log_bytes = valid_end;
+	}
+
+	return wal;
+}
+
+/*******************************************************************************
+***************************** PQWal Close *************************************/
+int PQWalClose(pq_wal_ty *wal)
+{
+	int status = 0;
+
+	ASSERT_NOT_NULL_IMP(wal);
+
+	status = PQWalSync(wal);
+	FreeWalImp(wal);
+
+	return status;
+}
+
+/*******************************************************************************
+***************************** PQWal Enqueue ***********************************/
+int PQWalEnqueue(pq_wal_ty *wal, void *data)
+{
+	ASSERT_NOT_NULL_IMP(wal);
+
+	if (wal->is_broken || 0 != PrepareRecordImp(wal, data) ||
+		0 != PQueueEnqueue(wal->pqueue, data))
+	{
+		return PQ_WAL_NOT_DONE;
+	}
+
+	return AppendRecordImp(wal, RECORD_ENQUEUE);
+}
+
+/*******************************************************************************
+***************************** PQWal Dequeue ***********************************/
+void *PQWalDequeue(pq_wal_ty *wal)
+{
+	void *data = NULL;
+
+	ASSERT_NOT_NULL_IMP(wal);
+
+	if (PQueueIsEmpty(wal->pqueue))
+	{
+		return NULL;
+	}
+
+	data = PQueuePeek(wal->pqueue);
+
+	if (wal->is_broken || 0 != PrepareRecordImp(wal, data))
+	{
+		wal->is_refused = 1;
+		return NULL;
+	}
+
+	PQueueDequeue(wal->pqueue);
+
+	/* a failed commit keeps the record pending - PQWalSync reports it */
+	AppendRecordImp(wal, RECORD_DEQUEUE);
+
+	return data;
+}
+
+/*******************************************************************************
+***************************** PQWal Erase *************************************/
+void *PQWalErase(pq_wal_ty *wal, PQIsMatch match_func, void *param)
+{
+	erase_match_ty match = {NULL, NULL, NULL, 0};
+	void *data = NULL;
+
+	ASSERT_NOT_NULL_IMP(wal);
+
+	if (wal->is_broken)
+	{
+		wal->is_refused = 1;
+		return NULL;
+	}
+
+	match.wal = wal;
+	match.match_func = match_func;
+	match.param = param;
+
+	data = PQueueErase(wal->pqueue, IsLoggedMatchImp, &match);
+
+	if (match.is_failed)
+	{
+		wal->is_refused = 1;
+	}
+
+	if (NULL != data)
+	{
+		AppendRecordImp(wal, RECORD_ERASE);
+	}
+
+	return data;
+}
+
+/*******************************************************************************
+***************************** PQWal Sync **************************************/
+int PQWalSync(pq_wal_ty *wal)
+{
+	int status = PQ_WAL_SUCCESS;
+
+	ASSERT_NOT_NULL_IMP(wal);
+
+	status = CommitImp(wal);
+
+	if (PQ_WAL_SUCCESS == status && wal->is_refused)
+	{
+		status = PQ_WAL_NOT_DONE;
+	}
+
+	wal->is_refused = 0;
+
+	return status;
+}
+
+/*******************************************************************************
+***************************** PQWal Compact ***********************************/
+int PQWalCompact(pq_wal_ty *wal)
+{
+	unsigned char generation[GENERATION_SIZE] = {0};
+	int fd = -1;
+	int status = 0;
+
+	ASSERT_NOT_NULL_IMP(wal);
+
+	fd = open(wal->tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	if (-1 == fd)
+	{
+		return 1;
+	}
+
+	EncodeImp(generation, wal->generation + 1, GENERATION_SIZE);
+
+	status = WriteAllImp(fd, generation, GENERATION_SIZE);
+	status = status || PQueueSave(wal->pqueue, fd, wal->cfg.serialize_func_p,
+								  wal->cfg.param);
+	status = status || fsync(fd);
+	status = (0 != close(fd)) || status;
+
+	/* the new snapshot replaces the old one atomically */
+	status = status || rename(wal->tmp_path, wal->snap_path);
+	status = status || SyncDirImp(wal->snap_path);
+
+	if (0 != status)
+	{
+		return 1;
+	}
+
+	/* pending records are part of the snapshot already */
+	wal->pending.size = 0;
+	wal->pending_ops = 0;
+
+	/* a crash before this point leaves an older log, which is ignored; 
+		records after a failed reset would go to that log - and be lost */
+	wal->is_broken = (0 != ResetLogImp(wal, wal->generation + 1));
+
+	return wal->is_broken;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int LoadSnapshotImp(pq_wal_ty *wal)
+{
+	unsigned char generation[GENERATION_SIZE] = {0};
+	int fd = open(wal->snap_path, O_RDONLY);
+	int status = 0;
+
+	if (-1 == fd)
+	{
+		wal->generation = 0;
+		return (ENOENT != errno);
+	}
+
+	status = ReadAllImp(fd, generation, GENERATION_SIZE);
+	status = status || PQueueLoad(wal->pqueue, fd, wal->cfg.deserialize_func_p,
+								  wal->cfg.param);
+	close(fd);
+
+	wal->generation = DecodeImp(generation, GENERATION_SIZE);
+
+	return status;
+}
+
+/* valid_end is 0 when there is no log for the current generation */
+static int ReplayLogImp(pq_wal_ty *wal, size_t *valid_end)
+{
+	unsigned char header[LOG_HEADER_SIZE] = {0};
+	unsigned char checksum[CHECKSUM_SIZE] = {0};
+	byte_buffer_ty record = {NULL, 0, 0};
+	FILE *log = fopen(wal->log_path, "rb");
+	size_t size = 0;
+	size_t end = LOG_HEADER_SIZE;
+	int status = 0;
+
+	*valid_end = 0;
+
+	if (NULL == log)
+	{
+		return (ENOENT != errno);
+	}
+
+	if (1 != fread(header, LOG_HEADER_SIZE, 1, log) ||
+		0 != memcmp(header, LOG_MAGIC, MAGIC_SIZE) ||
+		wal->generation != DecodeImp(header + MAGIC_SIZE, GENERATION_SIZE))
+	{
+		fclose(log);
+		return 0;
+	}
+
+	for (;;)
+	{
+		/* type and length first, then the payload with its checksum */
+		if (0 != ReserveImp(&record, TYPE_SIZE + LENGTH_SIZE))
+		{
+			status = 1;
+			break;
+		}
+
+		if (1 != fread(record.bytes, TYPE_SIZE + LENGTH_SIZE, 1, log))
+		{
+			break;
+		}
+
+		size = DecodeImp(record.bytes + TYPE_SIZE, LENGTH_SIZE);
+
+		if (0 != ReserveImp(&record, TYPE_SIZE + LENGTH_SIZE + size))
+		{
+			status = 1;
+			break;
+		}
+
+		if ((0 < size && 1 != fread(record.bytes + TYPE_SIZE + LENGTH_SIZE, size, 1, log)) ||
+			1 != fread(checksum, CHECKSUM_SIZE, 1, log) ||
+			DecodeImp(checksum, CHECKSUM_SIZE) !=
+			ChecksumImp(record.bytes, TYPE_SIZE + LENGTH_SIZE + size))
+		{
+			/* torn record - everything before it is valid */
+			break;
+		}
+
+		if (0 != ApplyRecordImp(wal, record.bytes[0],
+								record.bytes + TYPE_SIZE + LENGTH_SIZE, size))
+		{
+			status = 1;
+			break;
+		}
+
+		end += RECORD_OVERHEAD + size;
+	}
+
+	free(record.bytes);
+	fclose(log);
+
+	*valid_end = end;
+
+	return status;
+}
+
+static int ApplyRecordImp(pq_wal_ty *wal, int type, const unsigned char *payload,
+							size_t size)
+{
+	image_match_ty match = {NULL, NULL, 0};
+	void *data = NULL;
+
+	switch (type)
+	{
+		case RECORD_ENQUEUE:
+			data = wal->cfg.deserialize_func_p(payload, size, wal->cfg.param);
+
+			return (NULL == data || 0 != PQueueEnqueue(wal->pqueue, data));
+
+		/* the element of the image, not the top one */
+		case RECORD_DEQUEUE:
+		case RECORD_ERASE:
+			match.wal = wal;
+			match.image = payload;
+			match.size = size;
+
+			ReleaseImp(wal, PQueueErase(wal->pqueue, IsSameImageImp, &match));
+
+			return 0;
+
+		default:
+			return 1;
+	}
+}
+
+/* write and fsync pending records, then compact when due */
+static int CommitImp(pq_wal_ty *wal)
+{
+	if (wal->is_broken)
+	{
+		return PQ_WAL_COMMIT_FAILED;
+	}
+
+	if (0 < wal->pending.size)
+	{
+		/* one write and one fsync for the whole group */
+		if (0 != WriteAllImp(wal->log_fd, wal->pending.bytes, wal->pending.size))
+		{
+			/* cut what was written, so a retry does not follow torn bytes */
+			wal->is_broken =
+				(0 != ftruncate(wal->log_fd, (off_t)wal->log_bytes) ||
+				 (off_t)-1 == lseek(wal->log_fd, (off_t)wal->log_bytes, SEEK_SET));
+
+			return PQ_WAL_COMMIT_FAILED;
+		}
+
+		/* after a failed fsync the kernel may have dropped the pages:
+			whether the records are on disk is unknown */
+		if (0 != fdatasync(wal->log_fd))
+		{
+			wal->is_broken = 1;
+
+			return PQ_WAL_COMMIT_FAILED;
+		}
+
+		wal->log_bytes += wal->pending.size;
+		wal->pending.size = 0;
+		wal->pending_ops = 0;
+	}
+
+	if (0 != wal->cfg.compact_bytes && wal->log_bytes > wal->cfg.compact_bytes &&
+		0 != PQWalCompact(wal))
+	{
+		return PQ_WAL_COMPACT_FAILED;
+	}
+
+	return PQ_WAL_SUCCESS;
+}
+
+static int ResetLogImp(pq_wal_ty *wal, size_t generation)
+{
+	unsigned char header[LOG_HEADER_SIZE] = {0};
+
+	memcpy(header, LOG_MAGIC, MAGIC_SIZE);
+	EncodeImp(header + MAGIC_SIZE, generation, GENERATION_SIZE);
+
+	if (0 != ftruncate(wal->log_fd, 0) ||
+		(off_t)-1 == lseek(wal->log_fd, 0, SEEK_SET) ||
+		0 != WriteAllImp(wal->log_fd, header, LOG_HEADER_SIZE) ||
+		0 != fsync(wal->log_fd))
+	{
+		return 1;
+	}
+
+	wal->generation = generation;
+	wal->log_bytes = LOG_HEADER_SIZE;
+
+	return 0;
+}
+
+/* image of data in wal->image, and room for its record in pending */
+static int PrepareRecordImp(pq_wal_ty *wal, const void *data)
+{
+	return (0 != SerializeImp(wal, data) ||
+			0 != ReserveImp(&wal->pending, wal->pending.size + RECORD_OVERHEAD + 
+											wal->image.size));
+}
+
+/* the record of wal->image, prepared by PrepareRecordImp; returns the 
+	status of the group commit it may trigger */
+static int AppendRecordImp(pq_wal_ty *wal, int type)
+{
+	unsigned char *record = wal->pending.bytes + wal->pending.size;
+	size_t size = wal->image.size;
+
+	record[0] = (unsigned char)type;
+	EncodeImp(record + TYPE_SIZE, size, LENGTH_SIZE);
+
+	if (0 < size)
+	{
+		memcpy(record + TYPE_SIZE + LENGTH_SIZE, wal->image.bytes, size);
+	}
+
+	EncodeImp(record + TYPE_SIZE + LENGTH_SIZE + size,
+			  ChecksumImp(record, TYPE_SIZE + LENGTH_SIZE + size), CHECKSUM_SIZE);
+
+	wal->pending.size += RECORD_OVERHEAD + size;
+	++wal->pending_ops;
+
+	/* group commit */
+	if (wal->pending_ops >= wal->cfg.group_commit)
+	{
+		return CommitImp(wal);
+	}
+
+	return PQ_WAL_SUCCESS;
+}
+
+/* the image of data is left in wal->image */
+static int SerializeImp(pq_wal_ty *wal, const void *data)
+{
+	size_t needed = 0;
+
+	if (0 != ReserveImp(&wal->image, INIT_BUFFER_SIZE))
+	{
+		return 1;
+	}
+
+	needed = wal->cfg.serialize_func_p(data, wal->image.bytes,
+									   wal->image.capacity, wal->cfg.param);
+
+	/* the length of a record is 32 bits */
+	if (needed > MAX_IMAGE_SIZE)
+	{
+		return 1;
+	}
+
+	if (needed > wal->image.capacity)
+	{
+		if (0 != ReserveImp(&wal->image, needed))
+		{
+			return 1;
+		}
+
+		needed = wal->cfg.serialize_func_p(data, wal->image.bytes,
+										   wal->image.capacity, wal->cfg.param);
+
+		/* still not written */
+		if (needed > wal->image.capacity)
+		{
+			return 1;
+		}
+	}
+
+	wal->image.size = needed;
+
+	return 0;
+}
+
+static int IsSameImageImp(const void *element_data, const void *param)
+{
+	const image_match_ty *match = (const image_match_ty *)param;
+
+	if (0 != SerializeImp(match->wal, element_data))
+	{
+		return 0;
+	}
+
+	return (match->size == match->wal->image.size &&
+			0 == memcmp(match->image, match->wal->image.bytes, match->size));
+}
+
+/* the element is not taken when its record cannot be made */
+static int IsLoggedMatchImp(const void *element_data, const void *param)
+{
+	erase_match_ty *match = (erase_match_ty *)param;
+
+	if (match->is_failed || !match->match_func(element_data, match->param))
+	{
+		return 0;
+	}
+
+	match->is_failed = (0 != PrepareRecordImp(match->wal, element_data));
+
+	return !match->is_failed;
+}
+
+static int ReserveImp(byte_buffer_ty *buffer, size_t size)
+{
+	unsigned char *bigger = NULL;
+	size_t capacity = (0 == buffer->capacity) ? INIT_BUFFER_SIZE : buffer->capacity;
+
+	if (size <= buffer->capacity)
+	{
+		return 0;
+	}
+
+	while (capacity < size)
+	{
+		capacity *= 2;
+	}
+
+	bigger = (unsigned char *)realloc(buffer->bytes, capacity);
+
+	if (NULL == bigger)
+	{
+		return 1;
+	}
+
+	buffer->bytes = bigger;
+	buffer->capacity = capacity;
+
+	return 0;
+}
+
+static int WriteAllImp(int fd, const void *src, size_t size)
+{
+	const unsigned char *runner = (const unsigned char *)src;
+	ssize_t ret = 0;
+
+	while (0 < size)
+	{
+		ret = write(fd, runner, size);
+
+		if (0 > ret && EINTR != errno)
+		{
+			return 1;
+		}
+
+		if (0 < ret)
+		{
+			runner += ret;
+			size -= (size_t)ret;
+		}
+	}
+
+	return 0;
+}
+
+static int ReadAllImp(int fd, void *dest, size_t size)
+{
+	unsigned char *runner = (unsigned char *)dest;
+	ssize_t ret = 0;
+
+	while (0 < size)
+	{
+		ret = read(fd, runner, size);
+
+		if (0 > ret && EINTR == errno)
+		{
+			continue;
+		}
+
+		if (0 >= ret)
+		{
+			return 1;
+		}
+
+		runner += ret;
+		size -= (size_t)ret;
+	}
+
+	return 0;
+}
+
+/* make a rename in the directory of path durable */
+static int SyncDirImp(const char *path)
+{
+	char *dir = ConcatImp(path, "");
+	char *slash = NULL;
+	int fd = -1;
+	int status = 0;
+
+	if (NULL == dir)
+	{
+		return 1;
+	}
+
+	slash = strrchr(dir, '/');
+
+	if (NULL == slash)
+	{
+		strcpy(dir, ".");
+	}
+	else
+	{
+		slash[(slash == dir) ? 1 : 0] = '\0';
+	}
+
+	fd = open(dir, O_RDONLY);
+	free(dir);
+
+	if (-1 == fd)
+	{
+		return 1;
+	}
+
+	status = fsync(fd);
+	close(fd);
+
+	return status;
+}
+
+static char *ConcatImp(const char *path, const char *suffix)
+{
+	/* room for "." when path has no directory */
+	char *result = (char *)malloc(strlen(path) + strlen(suffix) + 2);
+
+	if (NULL != result)
+	{
+		strcpy(result, path);
+		strcat(result, suffix);
+	}
+
+	return result;
+}
+
+static void ReleaseImp(pq_wal_ty *wal, void *data)
+{
+	if (NULL != data && NULL != wal->cfg.release_func_p)
+	{
+		wal->cfg.release_func_p(data, wal->cfg.param);
+	}
+}
+
+static void FreeWalImp(pq_wal_ty *wal)
+{
+	if (-1 != wal->log_fd)
+	{
+		close(wal->log_fd);
+	}
+
+	free(wal->log_path);
+	free(wal->snap_path);
+	free(wal->tmp_path);
+	free(wal->pending.bytes);
+	free(wal->image.bytes);
+
+	DEBUG_MODE
+	(
+		wal->pqueue = INVALID_PTR;
+		wal->pending.bytes = INVALID_PTR;
+		wal->image.bytes = INVALID_PTR;
+	)
+	free(wal);
+}
+
+/* FNV-1a, 32 bit */
+static unsigned long ChecksumImp(const unsigned char *bytes, size_t size)
+{
+	unsigned long hash = 2166136261UL;
+	size_t i = 0;
+
+	for (i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+	}
+
+	return hash;
+}
+
+/* little endian, independent of the host */
+static void EncodeImp(unsigned char *dest, size_t value, size_t num_bytes)
+{
+	size_t i = 0;
+
+	for (i = 0; i < num_bytes; ++i)
+	{
+		dest[i] = (unsigned char)(value & 0xFF);
+		value >>= BYTE;
+	}
+}
+
+static size_t DecodeImp(const unsigned char *src, size_t num_bytes)
+{
+	size_t value = 0;
+	size_t i = num_bytes;
+
+	while (0 < i)
+	{
+		--i;
+		value <<= BYTE;
+		value |= src[i];
+	}
+
+	return value;
+}
@@ -0,0 +1,293 @@
+/*******************************************************************************
+************************ - SLIDING WINDOW PRIORITY QUEUE - *********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of Priority queue of expiring elements
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "heap.h"
+#include "pq_window.h"
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Window pqueue is not allocated");
+
+/* Every element is in two heaps: by priority and by expiry. Each heap
+	reports the moves of an entry, so an expired entry is removed from the
+	priority heap at its index instead of by a search.					*/
+typedef struct entry
+{
+	void *data;
+	unsigned long expiry;
+	size_t prio_index;
+	size_t exp_index;
+	struct entry *next_free;
+} entry_ty;
+
+struct pq_window
+{
+	heap_ty *by_prio;
+	heap_ty *by_expiry;
+	entry_ty *free_entries;		/* removed entries, kept for reuse */
+	PQCmpFunc cmp_func;
+	const void *cmp_param;
+	PQReleaseFunc release_func;
+	void *release_param;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int CmpPrioImp(const void *entry1, const void *entry2, const void *param);
+static int CmpExpiryImp(const void *entry1, const void *entry2, const void *param);
+static void MovePrioImp(void *entry, size_t index, void *param);
+static void MoveExpiryImp(void *entry, size_t index, void *param);
+static void RecycleImp(pq_window_ty *window, entry_ty *entry);
+
+/*******************************************************************************
+***************************** PQWindow Create *********************************/
+pq_window_ty *PQWindowCreate(PQCmpFunc cmp_func_p, const void *cmp_param,
+								PQReleaseFunc release_func_p, void *release_param)
+{
+	pq_window_ty *window = NULL;
+
+	assert (NULL != cmp_func_p && "PQWindowCreate: Function pointer is invalid");
+
+	window = (pq_window_ty *)malloc(sizeof(pq_window_ty));
+
+	if (NULL == window)
+	{
+		return NULL;
+	}
+
+	window->cmp_func = cmp_func_p;
+	window->cmp_param = cmp_param;
+	window->release_func = release_func_p;
+	window->release_param = release_param;
+	window->free_entries = NULL;
+	window->by_prio = HeapCreate(CmpPrioImp, window);
+	window->by_expiry = HeapCreate(CmpExpiryImp, NULL);
+
+	if (NULL == window->by_prio || NULL == window->by_expiry)
+	{
+		if (NULL != window->by_prio)
+		{
+			HeapDestroy(window->by_prio);
+		}
+
+		if (NULL != window->by_expiry)
+		{
+			HeapDestroy(window->by_expiry);
+		}
+
+		free(window);
+		return NULL;
+	}
+
+	HeapSetMoveFunc(window->by_prio, MovePrioImp, NULL);
+	HeapSetMoveFunc(window->by_expiry, MoveExpiryImp, NULL);
+
+	return window;
+}
+
+/*******************************************************************************
+***************************** PQWindow Destroy ********************************/
+void PQWindowDestroy(pq_window_ty *window)
+{
+	entry_ty *entry = NULL;
+
+	ASSERT_NOT_NULL_IMP(window);
+
+	while (!HeapIsEmpty(window->by_prio))
+	{
+		entry = (entry_ty *)HeapPop(window->by_prio);
+
+		if (NULL != window->release_func)
+		{
+			window->release_func(entry->data, window->release_param);
+		}
+
+		free(entry);
+	}
+
+	while (NULL != window->free_entries)
+	{
+		entry = window->free_entries;
+		window->free_entries = entry->next_free;
+		free(entry);
+	}
+
+	HeapDestroy(window->by_prio);
+	HeapDestroy(window->by_expiry);
+
+	DEBUG_MODE
+	(
+		window->by_prio = INVALID_PTR;
+		window->by_expiry = INVALID_PTR;
+	)
+	free(window);
+}
+
+/*******************************************************************************
+***************************** PQWindow Enqueue ********************************/
+int PQWindowEnqueue(pq_window_ty *window, void *data, unsigned long expiry)
+{
+	entry_ty *entry = NULL;
+
+	ASSERT_NOT_NULL_IMP(window);
+
+	entry = window->free_entries;
+
+	if (NULL != entry)
+	{
+		window->free_entries = entry->next_free;
+	}
+	else
+	{
+		entry = (entry_ty *)malloc(sizeof(entry_ty));
+
+		if (NULL == entry)
+		{
+			return 1;
+		}
+	}
+
+	entry->data = data;
+	entry->expiry = expiry;
+
+	if (0 != HeapPush(window->by_prio, entry))
+	{
+		RecycleImp(window, entry);
+		return 1;
+	}
+
+	if (0 != HeapPush(window->by_expiry, entry))
+	{
+		HeapRemoveAt(window->by_prio, entry->prio_index);
+		RecycleImp(window, entry);
+		return 1;
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** PQWindow Peek ***********************************/
+void *PQWindowPeek(pq_window_ty *window, unsigned long now)
+{
+	entry_ty *top = NULL;
+
+	ASSERT_NOT_NULL_IMP(window);
+
+	PQWindowExpire(window, now);
+	top = (entry_ty *)HeapPeek(window->by_prio);
+
+	return (NULL == top) ? NULL : top->data;
+}
+
+/*******************************************************************************
+***************************** PQWindow Dequeue ********************************/
+void PQWindowDequeue(pq_window_ty *window)
+{
+	entry_ty *top = NULL;
+
+	ASSERT_NOT_NULL_IMP(window);
+	assert (!HeapIsEmpty(window->by_prio) && "PQWindowDequeue: window is empty");
+
+	/* the user may have freed top->data - only the expiries are compared */
+	top = (entry_ty *)HeapPeek(window->by_prio);
+	HeapRemoveAt(window->by_expiry, top->exp_index);
+	HeapPop(window->by_prio);
+	RecycleImp(window, top);
+}
+
+/*******************************************************************************
+***************************** PQWindow Expire *********************************/
+size_t PQWindowExpire(pq_window_ty *window, unsigned long now)
+{
+	entry_ty *oldest = NULL;
+	size_t count = 0;
+
+	ASSERT_NOT_NULL_IMP(window);
+
+	while (NULL != (oldest = (entry_ty *)HeapPeek(window->by_expiry)) &&
+			oldest->expiry <= now)
+	{
+		HeapPop(window->by_expiry);
+		HeapRemoveAt(window->by_prio, oldest->prio_index);
+
+		if (NULL != window->release_func)
+		{
+			window->release_func(oldest->data, window->release_param);
+		}
+
+		RecycleImp(window, oldest);
+		++count;
+	}
+
+	return count;
+}
+
+/*******************************************************************************
+***************************** PQWindow Size ***********************************/
+size_t PQWindowSize(const pq_window_ty *window)
+{
+	ASSERT_NOT_NULL_IMP(window);
+
+	return HeapSize(window->by_prio);
+}
+
+/*******************************************************************************
+***************************** PQWindow IsEmpty ********************************/
+int PQWindowIsEmpty(const pq_window_ty *window)
+{
+	ASSERT_NOT_NULL_IMP(window);
+
+	return HeapIsEmpty(window->by_prio);
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int CmpPrioImp(const void *entry1, const void *entry2, const void *param)
+{
+	const pq_window_ty *window = (const pq_window_ty *)param;
+
+	return window->cmp_func(((const entry_ty *)entry1)->data,
+							((const entry_ty *)entry2)->data, window->cmp_param);
+}
+
+static int CmpExpiryImp(const void *entry1, const void *entry2, const void *param)
+{
+	unsigned long expiry1 = ((const entry_ty *)entry1)->expiry;
+	unsigned long expiry2 = ((const entry_ty *)entry2)->expiry;
+
+	UNUSED(param);
+
+	return (expiry1 > expiry2) - (expiry1 < expiry2);
+}
+
+static void MovePrioImp(void *entry, size_t index, void *param)
+{
+	UNUSED(param);
+
+	((entry_ty *)entry)->prio_index = index;
+}
+
+static void MoveExpiryImp(void *entry, size_t index, void *param)
+{
+	UNUSED(param);
+
+	((entry_ty *)entry)->exp_index = index;
+}
+
+static void RecycleImp(pq_window_ty *window, entry_ty *entry)
+{
+	entry->next_free = window->free_entries;
+	window->free_entries = entry;
+}
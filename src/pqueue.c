@@ -7,27 +7,209 @@
 * 
 *******************************************************************************/
 
+#define _POSIX_C_SOURCE 200112L		/* read, write */
+
 #include <stdlib.h>			/* malloc, free*/
 #include <assert.h>			/* assert */
+#include <string.h>			/* memcpy */
+#include <errno.h>			/* errno, EINTR */
+#include <unistd.h>			/* read, write */
+#include <pthread.h>		/* pthread_create, pthread_join */
 
 #include "utilities.h"
 #include "sorted_list.h"
 #include "pqueue.h"
+#include "pq_engine.h"
 
 #define PQASSERT_NOT_NULL(ptr)									\
 		assert (NULL != ptr && "Priority Queue is not allocated");
 
+#define PQ_SNAPSHOT_MAGIC "PQS1"
+#define PQ_MAGIC_SIZE 4
+#define PQ_COUNT_SIZE 8
+#define PQ_LENGTH_SIZE 4
+#define PQ_MAX_RECORD_SIZE 0xFFFFFFFFUL	/* fits in PQ_LENGTH_SIZE bytes */
+#define PQ_IO_BUFFER_SIZE 65536
+#define PQ_RECORD_INIT_SIZE 256
+#define PQ_INDEX_INIT_BUCKETS 16
+#define PQ_BULK_MIN_CHUNK 4096		/* elements a thread sorts at least */
+
+/* an element in the key index; chained by the hash of its key and by its 
+	address, so Dequeue finds it without reading the element 			*/
+typedef struct pq_key_entry
+{
+	void *data;
+	size_t key_hash;
+	pq_handle_ty handle;
+	struct pq_key_entry *next_by_key;
+	struct pq_key_entry *next_by_data;
+} pq_key_entry_ty;
+
+typedef struct pq_key_index
+{
+	pq_key_entry_ty **by_key;
+	pq_key_entry_ty **by_data;
+	size_t num_buckets;			/* power of 2 */
+	size_t count;
+	PQKeyFunc key_func;
+	PQHashFunc hash_func;
+	PQIsMatch match_func;
+	void *param;
+	pq_tracker_ty tracker;
+} pq_key_index_ty;
+
 struct pqueue
 {
-    sortl_ty *sortl;
+	const pq_engine_ops_ty *ops;
+	void *engine;
+	pq_key_index_ty *index;		/* NULL when not kept */
+	PQCmpFunc cmp_func;			/* as the engine's - for the bulk sort */
+	const void *cmp_param;
+};
+
+/* state of PQueueEraseIf, for each removed element */
+typedef struct pq_erase_if
+{
+	pq_key_index_ty *index;
+	PQReleaseFunc out_func;
+	void *param;
+} pq_erase_if_ty;
+
+/* a step of PQueueEnqueueBulkParallel, on a thread of its own: sort
+	src[lo, hi) in place (is_sort; dst is scratch), or merge src[lo, mid)
+	and src[mid, hi) into dst[lo, hi) */
+typedef struct pq_bulk_task
+{
+	void **src;
+	void **dst;
+	size_t lo;
+	size_t mid;
+	size_t hi;
+	int is_sort;
+	PQCmpFunc cmp_func;
+	const void *cmp_param;
+	pthread_t thread;
+	int has_thread;
+} pq_bulk_task_ty;
+
+/* PQ_ENGINE_LIST */
+typedef struct pq_list
+{
+	sortl_ty *sortl;
+	pq_tracker_ty *tracker;
+} pq_list_ty;
+
+/* buffered stream over a file descriptor, used by Save and Load */
+typedef struct pq_stream
+{
+	int fd;
+	size_t used;
+	size_t pos;
+	unsigned char buffer[PQ_IO_BUFFER_SIZE];
+} pq_stream_ty;
+
+/* state of PQueueSave between the visits of the engine */
+typedef struct pq_save
+{
+	pq_stream_ty *stream;
+	unsigned char *record;
+	size_t record_size;
+	PQSerializeFunc serialize_func;
+	void *param;
+} pq_save_ty;
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int StreamWriteImp(pq_stream_ty *stream, const void *src, size_t size);
+static int StreamFlushImp(pq_stream_ty *stream);
+static int StreamReadImp(pq_stream_ty *stream, void *dest, size_t size);
+static void EncodeImp(unsigned char *dest, size_t value, size_t num_bytes);
+static size_t DecodeImp(const unsigned char *src, size_t num_bytes);
+static int SaveRecordImp(void *data, void *param);
+static int AddImp(pqueue_ty *pqueue, void *data, int (*add_func)(void *, void *));
+static size_t AddBatchImp(pqueue_ty *pqueue, void **items, size_t n, 
+							size_t (*batch_func)(void *, void **, size_t));
+static void EraseIfOutImp(void *data, void *param);
+static int BulkSortImp(pqueue_ty *pqueue, void **items, size_t n, size_t nchunks);
+static void BulkRunImp(pq_bulk_task_ty *tasks, size_t count);
+static void *BulkTaskImp(void *task);
+static void SortRangeImp(void **items, void **tmp, size_t lo, size_t hi, 
+							PQCmpFunc cmp_func, const void *cmp_param);
+static void MergeRangesImp(void **src, void **dst, size_t lo, size_t mid, 
+							size_t hi, PQCmpFunc cmp_func, const void *cmp_param);
+static size_t ChunkBeginImp(size_t n, size_t nchunks, size_t chunk);
+
+static pq_key_index_ty *IndexCreateImp(PQKeyFunc key_func, PQHashFunc hash_func,
+										PQIsMatch match_func, void *param);
+static void IndexDestroyImp(pq_key_index_ty *index);
+static int IndexAddImp(pq_key_index_ty *index, void *data);
+static void IndexRemoveImp(pq_key_index_ty *index, const void *data);
+static void IndexClearImp(pq_key_index_ty *index);
+static void IndexGrowImp(pq_key_index_ty *index);
+static pq_key_entry_ty *IndexFindKeyImp(const pq_key_index_ty *index, const void *key);
+static pq_key_entry_ty **IndexFindDataImp(const pq_key_index_ty *index, const void *data);
+static pq_handle_ty *IndexHandleImp(const void *data, void *param);
+static size_t MixImp(size_t hash);
+
+static void *ListCreateImp(PQCmpFunc cmp_func, const void *cmp_param);
+
+static void ListDestroyImp(void *engine);
+static int ListEnqueueImp(void *engine, void *data);
+static size_t ListEnqueueBatchImp(void *engine, void **items, size_t n);
+static size_t ListEnqueueSortedImp(void *engine, void **items, size_t n);
+static void ListRetrackImp(pq_list_ty *list);
+static void ListDequeueImp(void *engine);
+static void *ListPeekImp(const void *engine);
+static int ListIsEmptyImp(const void *engine);
+static size_t ListSizeImp(const void *engine);
+static void ListClearImp(void *engine);
+static void *ListEraseImp(void *engine, PQIsMatch match_func, void *param);
+static int ListForEachImp(void *engine, PQVisitFunc visit_func, void *param);
+static int ListAppendImp(void *engine, void *data);
+static void ListTrackImp(void *engine, pq_tracker_ty *tracker);
+static void *ListEraseAtImp(void *engine, const pq_handle_ty *handle);
+static size_t ListEraseIfImp(void *engine, PQIsMatch match_func, void *match_param,
+								PQReleaseFunc out_func, void *out_param);
+static void ListSetCmpParamImp(void *engine, const void *cmp_param);
+
+/* PQ_ENGINE_LIST - the sorted list */
+static const pq_engine_ops_ty list_engine_ops =
+{
+	ListDestroyImp,
+	ListEnqueueImp,
+	ListEnqueueBatchImp,
+	ListEnqueueSortedImp,
+	ListDequeueImp,
+	ListPeekImp,
+	ListIsEmptyImp,
+	ListSizeImp,
+	ListClearImp,
+	ListEraseImp,
+	ListForEachImp,
+	ListAppendImp,
+	ListTrackImp,
+	ListEraseAtImp,
+	ListEraseIfImp,
+	ListSetCmpParamImp,
+	NULL
 };
 
 
 /*******************************************************************************
 ***************************** PQueue Create ***********************************/
 pqueue_ty *PQueueCreate(PQCmpFunc cmp_func_p, const void *cmp_param)
+{
+	return PQueueCreateEx(cmp_func_p, cmp_param, NULL);
+}
+
+/*******************************************************************************
+***************************** PQueue CreateEx *********************************/
+pqueue_ty *PQueueCreateEx(PQCmpFunc cmp_func_p, const void *cmp_param,
+							const pq_config_ty *config)
 {
 	pqueue_ty *priority_queue = {NULL};
+	pq_engine_ty engine = (NULL == config) ? PQ_ENGINE_LIST : config->engine;
 	
 	assert (NULL != cmp_func_p && "PQueueCreate: Function pointer is invalid");
 	
@@ -40,11 +222,45 @@ pqueue_ty *PQueueCreate(PQCmpFunc cmp_func_p, const void *cmp_param)
 		return NULL;
 	}
 	
-	/* allocate sortl */
-	priority_queue->sortl = SortLCreate(cmp_func_p ,cmp_param);
+	priority_queue->index = NULL;
+	priority_queue->cmp_func = cmp_func_p;
+	priority_queue->cmp_param = cmp_param;
+	
+	/* create the engine */
+	switch (engine)
+	{
+		case PQ_ENGINE_MMAP:
+			priority_queue->ops = &pq_mmap_engine_ops;
+			priority_queue->engine = PQMmapEngineCreate(cmp_func_p, cmp_param, 
+														config);
+			break;
+		
+		case PQ_ENGINE_EXTERNAL:
+			priority_queue->ops = &pq_external_engine_ops;
+			priority_queue->engine = PQExternalEngineCreate(cmp_func_p, 
+															cmp_param, config);
+			break;
+		
+		case PQ_ENGINE_HEAP:
+			priority_queue->ops = &pq_heap_engine_ops;
+			priority_queue->engine = PQHeapEngineCreate(cmp_func_p, cmp_param, 
+														config);
+			break;
+		
+		case PQ_ENGINE_SEQHEAP:
+			priority_queue->ops = &pq_seqheap_engine_ops;
+			priority_queue->engine = PQSeqHeapEngineCreate(cmp_func_p, 
+															cmp_param, config);
+			break;
+		
+		default:
+			priority_queue->ops = &list_engine_ops;
+			priority_queue->engine = ListCreateImp(cmp_func_p ,cmp_param);
+			break;
+	}
 	
 	/* check handle allocation failure */
-	if (NULL == priority_queue->sortl)
+	if (NULL == priority_queue->engine)
 	{
 		free(priority_queue);
 		return NULL;
@@ -60,12 +276,19 @@ void PQueueDestroy(pqueue_ty *pqueue)
 	PQASSERT_NOT_NULL(pqueue);
 	
 	/* free pqueue */
-	SortLDestroy(pqueue->sortl);
+	pqueue->ops->destroy(pqueue->engine);
+	
+	if (NULL != pqueue->index)
+	{
+		IndexDestroyImp(pqueue->index);
+	}
 	
 	/* break pqueue fields */
     DEBUG_MODE
     (
-    	pqueue->sortl = INVALID_PTR;
+    	pqueue->engine = INVALID_PTR;
+    	pqueue->index = INVALID_PTR;
+    	pqueue->ops = INVALID_PTR;
     )
 	free(pqueue);
 }
@@ -74,29 +297,80 @@ void PQueueDestroy(pqueue_ty *pqueue)
 ***************************** PQueue Enqueue **********************************/
 int PQueueEnqueue(pqueue_ty *pqueue, void *data)
 {
-	sortl_itr_ty ret_itr = {NULL};
+	PQASSERT_NOT_NULL(pqueue);
 	
+	return AddImp(pqueue, data, pqueue->ops->enqueue);
+}
+
+/*******************************************************************************
+***************************** PQueue EnqueueBatch *****************************/
+size_t PQueueEnqueueBatch(pqueue_ty *pqueue, void **items, size_t n)
+{
 	PQASSERT_NOT_NULL(pqueue);
 	
-	ret_itr = SortLInsert(pqueue->sortl, data);
+	return AddBatchImp(pqueue, items, n, pqueue->ops->enqueue_batch);
+}
+
+/*******************************************************************************
+***************************** PQueue EnqueueBulkParallel **********************/
+size_t PQueueEnqueueBulkParallel(pqueue_ty *pqueue, void **items, size_t n, 
+									size_t nthreads)
+{
+	size_t nchunks = nthreads;
+	size_t added = 0;
+	int is_append = 0;
 	
-	/* check if insertion faild */
-	return (SortLIsSameIter(ret_itr, SortLEnd(pqueue->sortl)));
+	PQASSERT_NOT_NULL(pqueue);
+	assert (NULL != items || 0 == n);
+	assert (0 < nthreads && "PQueueEnqueueBulkParallel: no threads");
+	
+	/* a thread is not worth starting for a small chunk */
+	if (n / PQ_BULK_MIN_CHUNK < nchunks)
+	{
+		nchunks = n / PQ_BULK_MIN_CHUNK;
+	}
+	
+	is_append = (PQueueIsEmpty(pqueue) && NULL != pqueue->ops->append);
+	
+	/* sorted items are of use only to append or to merge */
+	if (1 >= nchunks || (!is_append && NULL == pqueue->ops->enqueue_sorted) || 
+		0 != BulkSortImp(pqueue, items, n, nchunks))
+	{
+		return PQueueEnqueueBatch(pqueue, items, n);
+	}
+	
+	if (!is_append)
+	{
+		return AddBatchImp(pqueue, items, n, pqueue->ops->enqueue_sorted);
+	}
+	
+	/* items are in priority order - append, no comparisons */
+	while (added < n && 0 == AddImp(pqueue, items[added], pqueue->ops->append))
+	{
+		++added;
+	}
+	
+	return added;
 }
 
 /*******************************************************************************
 ***************************** PQueue Dequeue **********************************/
 void PQueueDequeue(pqueue_ty *pqueue)
 {
-	sortl_itr_ty high_priority = {NULL};
+	void *top = NULL;
 	
  	PQASSERT_NOT_NULL(pqueue);
  	
- 	/* get the first valid iterator in list */
- 	high_priority = SortLBegin(pqueue->sortl);
+ 	if (NULL == pqueue->index)
+ 	{
+ 		pqueue->ops->dequeue(pqueue->engine);
+ 		return;
+ 	}
  	
- 	/* remove the result */
- 	SortLRemove(high_priority);
+ 	/* only the address - the user may have freed the element */
+ 	top = pqueue->ops->peek(pqueue->engine);
+ 	pqueue->ops->dequeue(pqueue->engine);
+ 	IndexRemoveImp(pqueue->index, top);
 }
 
 /*******************************************************************************
@@ -105,7 +379,7 @@ void *PQueuePeek(const pqueue_ty *pqueue)
 {
  	PQASSERT_NOT_NULL(pqueue);
  	
-	return SortLGetData(SortLBegin(pqueue->sortl));
+	return pqueue->ops->peek(pqueue->engine);
 }
 
 /*******************************************************************************
@@ -114,8 +388,7 @@ int PQueueIsEmpty(const pqueue_ty *pqueue)
 {
  	PQASSERT_NOT_NULL(pqueue);
  	
- 	return SortLIsEmpty(pqueue->sortl);
-
+ 	return pqueue->ops->is_empty(pqueue->engine);
 }
 
 /*******************************************************************************
@@ -124,7 +397,21 @@ size_t PQueueSize(const pqueue_ty *pqueue)
 {
  	PQASSERT_NOT_NULL(pqueue);
 	
-	return SortLCount(pqueue->sortl);
+	return pqueue->ops->size(pqueue->engine);
+}
+
+/*******************************************************************************
+***************************** PQueue Error ************************************/
+int PQueueError(const pqueue_ty *pqueue)
+{
+ 	PQASSERT_NOT_NULL(pqueue);
+	
+	if (NULL == pqueue->ops->error)
+	{
+		return 0;
+	}
+
+	return pqueue->ops->error(pqueue->engine);
 }
 
 /*******************************************************************************
@@ -133,10 +420,11 @@ void PQueueClear(pqueue_ty *pqueue)
 {
  	PQASSERT_NOT_NULL(pqueue);
 	
-	/* traverse pqueue and dequeue each element until it gets empty */
-	while (!PQueueIsEmpty(pqueue))
+	pqueue->ops->clear(pqueue->engine);
+	
+	if (NULL != pqueue->index)
 	{
-		PQueueDequeue(pqueue);
+		IndexClearImp(pqueue->index);
 	}
 }
 
@@ -144,19 +432,400 @@ void PQueueClear(pqueue_ty *pqueue)
 ***************************** PQueue Erase ************************************/
 void *PQueueErase(pqueue_ty *pqueue, const PQIsMatch match_func, void *param)
 {
- 	sortl_itr_ty begin = {NULL};
- 	sortl_itr_ty end = {NULL};
- 	sortl_itr_ty to_erase = {NULL};
- 	void *ret_data = NULL;
- 	
+	void *data = NULL;
+	
  	PQASSERT_NOT_NULL(pqueue);
 	assert (NULL != match_func && "PQueueErase: Function pointer is invalid");	
 	
-	begin = SortLBegin(pqueue->sortl);
-	end = SortLEnd(pqueue->sortl);
+	data = pqueue->ops->erase(pqueue->engine, match_func, param);
+	
+	if (NULL != data && NULL != pqueue->index)
+	{
+		IndexRemoveImp(pqueue->index, data);
+	}
+	
+	return data;
+}
+
+/*******************************************************************************
+***************************** PQueue EraseIf **********************************/
+size_t PQueueEraseIf(pqueue_ty *pqueue, PQIsMatch match_func, void *param,
+						PQReleaseFunc out_func)
+{
+	pq_erase_if_ty erase_if = {NULL};
+	size_t removed = 0;
+	void *data = NULL;
+	
+	PQASSERT_NOT_NULL(pqueue);
+	assert (NULL != match_func && "PQueueEraseIf: Function pointer is invalid");
+	
+	erase_if.index = pqueue->index;
+	erase_if.out_func = out_func;
+	erase_if.param = param;
+	
+	if (NULL != pqueue->ops->erase_if)
+	{
+		return pqueue->ops->erase_if(pqueue->engine, match_func, param, 
+									 EraseIfOutImp, &erase_if);
+	}
+	
+	/* no single pass - one search per element */
+	while (NULL != (data = PQueueErase(pqueue, match_func, param)))
+	{
+		++removed;
+		
+		if (NULL != out_func)
+		{
+			out_func(data, param);
+		}
+	}
+	
+	return removed;
+}
+
+/*******************************************************************************
+***************************** PQueue SetCmpParam ******************************/
+int PQueueSetCmpParam(pqueue_ty *pqueue, const void *cmp_param)
+{
+	PQASSERT_NOT_NULL(pqueue);
+	
+	if (NULL == pqueue->ops->set_cmp_param)
+	{
+		return 1;
+	}
+	
+	pqueue->ops->set_cmp_param(pqueue->engine, cmp_param);
+	pqueue->cmp_param = cmp_param;
+	
+	return 0;
+}
+
+/*******************************************************************************
+***************************** PQueue SetKeyIndex ******************************/
+int PQueueSetKeyIndex(pqueue_ty *pqueue, PQKeyFunc key_func, PQHashFunc hash_func,
+						PQIsMatch match_func, void *param)
+{
+	pq_key_index_ty *index = NULL;
+	
+	PQASSERT_NOT_NULL(pqueue);
+	assert (NULL != key_func && NULL != hash_func && NULL != match_func && 
+			"PQueueSetKeyIndex: Function pointer is invalid");
+	assert (PQueueIsEmpty(pqueue) && "PQueueSetKeyIndex: pqueue is not empty");
+	
+	if (NULL == pqueue->ops->track || NULL == pqueue->ops->erase_at)
+	{
+		return 1;
+	}
+	
+	index = IndexCreateImp(key_func, hash_func, match_func, param);
+	
+	if (NULL == index)
+	{
+		return 1;
+	}
+	
+	if (NULL != pqueue->index)
+	{
+		IndexDestroyImp(pqueue->index);
+	}
+	
+	pqueue->index = index;
+	pqueue->ops->track(pqueue->engine, &index->tracker);
+	
+	return 0;
+}
+
+/*******************************************************************************
+***************************** PQueue EraseKey *********************************/
+void *PQueueEraseKey(pqueue_ty *pqueue, const void *key)
+{
+	pq_key_entry_ty *entry = NULL;
+	void *data = NULL;
+	
+	PQASSERT_NOT_NULL(pqueue);
+	assert (NULL != pqueue->index && "PQueueEraseKey: no key index");
+	
+	entry = IndexFindKeyImp(pqueue->index, key);
+	
+	if (NULL == entry)
+	{
+		return NULL;
+	}
+	
+	data = pqueue->ops->erase_at(pqueue->engine, &entry->handle);
+	IndexRemoveImp(pqueue->index, data);
+	
+	return data;
+}
+
+/*******************************************************************************
+***************************** PQueue Contains *********************************/
+int PQueueContains(const pqueue_ty *pqueue, const void *key)
+{
+	PQASSERT_NOT_NULL(pqueue);
+	assert (NULL != pqueue->index && "PQueueContains: no key index");
+	
+	return (NULL != IndexFindKeyImp(pqueue->index, key));
+}
+
+/*******************************************************************************
+***************************** PQueue Save *************************************/
+int PQueueSave(pqueue_ty *pqueue, int fd, PQSerializeFunc serialize_func, void *param)
+{
+	pq_save_ty save = {0};
+	unsigned char header[PQ_MAGIC_SIZE + PQ_COUNT_SIZE] = {0};
+	int status = 0;
+	
+	PQASSERT_NOT_NULL(pqueue);
+	assert (NULL != serialize_func && "PQueueSave: Function pointer is invalid");
+	
+	if (NULL == pqueue->ops->for_each)
+	{
+		return 1;
+	}
+	
+	save.stream = (pq_stream_ty *)malloc(sizeof(pq_stream_ty));
+	save.record_size = PQ_RECORD_INIT_SIZE;
+	save.record = (unsigned char *)malloc(save.record_size);
+	save.serialize_func = serialize_func;
+	save.param = param;
+	
+	if (NULL == save.stream || NULL == save.record)
+	{
+		free(save.stream);
+		free(save.record);
+		return 1;
+	}
+	
+	save.stream->fd = fd;
+	save.stream->used = 0;
+	
+	memcpy(header, PQ_SNAPSHOT_MAGIC, PQ_MAGIC_SIZE);
+	EncodeImp(header + PQ_MAGIC_SIZE, PQueueSize(pqueue), PQ_COUNT_SIZE);
+	status = StreamWriteImp(save.stream, header, sizeof(header));
+	
+	/* the engine visits in priority order */
+	status = status || 
+			 pqueue->ops->for_each(pqueue->engine, SaveRecordImp, &save);
+	
+	status = status || StreamFlushImp(save.stream);
+	
+	free(save.record);
+	free(save.stream);
+	
+	return status;
+}
+
+/*******************************************************************************
+***************************** PQueue Load *************************************/
+int PQueueLoad(pqueue_ty *pqueue, int fd, PQDeserializeFunc deserialize_func, void *param)
+{
+	pq_stream_ty *stream = NULL;
+	unsigned char *record = NULL;
+	unsigned char *bigger = NULL;
+	unsigned char header[PQ_MAGIC_SIZE + PQ_COUNT_SIZE] = {0};
+	unsigned char length[PQ_LENGTH_SIZE] = {0};
+	size_t record_size = PQ_RECORD_INIT_SIZE;
+	size_t count = 0;
+	size_t size = 0;
+	void *data = NULL;
+	int status = 0;
+	
+	PQASSERT_NOT_NULL(pqueue);
+	assert (NULL != deserialize_func && "PQueueLoad: Function pointer is invalid");
+	assert (PQueueIsEmpty(pqueue) && "PQueueLoad: pqueue is not empty");
+	
+	if (NULL == pqueue->ops->append)
+	{
+		return 1;
+	}
+	
+	stream = (pq_stream_ty *)malloc(sizeof(pq_stream_ty));
+	record = (unsigned char *)malloc(record_size);
+	
+	if (NULL == stream || NULL == record)
+	{
+		free(stream);
+		free(record);
+		return 1;
+	}
+	
+	stream->fd = fd;
+	stream->used = 0;
+	stream->pos = 0;
+	
+	status = StreamReadImp(stream, header, sizeof(header));
+	status = status || (0 != memcmp(header, PQ_SNAPSHOT_MAGIC, PQ_MAGIC_SIZE));
+	count = DecodeImp(header + PQ_MAGIC_SIZE, PQ_COUNT_SIZE);
+	
+	for (; 0 == status && 0 < count; --count)
+	{
+		status = StreamReadImp(stream, length, PQ_LENGTH_SIZE);
+		size = DecodeImp(length, PQ_LENGTH_SIZE);
+		
+		if (0 == status && size > record_size)
+		{
+			bigger = (unsigned char *)realloc(record, size);
+			
+			if (NULL == bigger)
+			{
+				status = 1;
+				break;
+			}
+			
+			record = bigger;
+			record_size = size;
+		}
+		
+		status = status || StreamReadImp(stream, record, size);
+		
+		if (0 == status)
+		{
+			data = deserialize_func(record, size, param);
+			
+			/* records are in priority order - append, no comparisons */
+			status = (NULL == data) || 
+					 AddImp(pqueue, data, pqueue->ops->append);
+		}
+	}
+	
+	free(record);
+	free(stream);
+	
+	return status;
+}
+
+
+/*******************************************************************************
+***************************** List Engine *************************************/
+static void *ListCreateImp(PQCmpFunc cmp_func, const void *cmp_param)
+{
+	pq_list_ty *list = (pq_list_ty *)malloc(sizeof(pq_list_ty));
+	
+	if (NULL == list)
+	{
+		return NULL;
+	}
+	
+	list->sortl = SortLCreate(cmp_func, cmp_param);
+	list->tracker = NULL;
+	
+	if (NULL == list->sortl)
+	{
+		free(list);
+		return NULL;
+	}
+	
+	return list;
+}
+
+static void ListDestroyImp(void *engine)
+{
+	pq_list_ty *list = (pq_list_ty *)engine;
+	
+	SortLDestroy(list->sortl);
+	
+	DEBUG_MODE
+	(
+		list->sortl = INVALID_PTR;
+	)
+	free(list);
+}
+
+static int ListEnqueueImp(void *engine, void *data)
+{
+	pq_list_ty *list = (pq_list_ty *)engine;
+	sortl_itr_ty where = SortLInsert(list->sortl, data);
+	
+	/* check if insertion faild */
+	if (SortLIsSameIter(where, SortLEnd(list->sortl)))
+	{
+		return 1;
+	}
+	
+	if (NULL != list->tracker)
+	{
+		list->tracker->handle_func_p(data, list->tracker->param)->iter = where;
+	}
+	
+	return 0;
+}
+
+static size_t ListEnqueueBatchImp(void *engine, void **items, size_t n)
+{
+	pq_list_ty *list = (pq_list_ty *)engine;
+	
+	n = SortLInsertBatch(list->sortl, items, n);
+	ListRetrackImp(list);
+	
+	return n;
+}
+
+static size_t ListEnqueueSortedImp(void *engine, void **items, size_t n)
+{
+	pq_list_ty *list = (pq_list_ty *)engine;
+	
+	n = SortLInsertSorted(list->sortl, items, n);
+	ListRetrackImp(list);
+	
+	return n;
+}
+
+/* a batch has no iterators - one pass over the list instead */
+static void ListRetrackImp(pq_list_ty *list)
+{
+	sortl_itr_ty runner = {NULL};
+	sortl_itr_ty end = SortLEnd(list->sortl);
+	
+	for (runner = SortLBegin(list->sortl); NULL != list->tracker && 
+		 !SortLIsSameIter(runner, end); runner = SortLNext(runner))
+	{
+		list->tracker->handle_func_p(SortLGetData(runner), 
+									 list->tracker->param)->iter = runner;
+	}
+}
+
+static void ListDequeueImp(void *engine)
+{
+	pq_list_ty *list = (pq_list_ty *)engine;
+	
+ 	/* the first valid iterator in list has the highest priority */
+ 	SortLRemove(SortLBegin(list->sortl));
+}
+
+static void *ListPeekImp(const void *engine)
+{
+	return SortLGetData(SortLBegin(((const pq_list_ty *)engine)->sortl));
+}
+
+static int ListIsEmptyImp(const void *engine)
+{
+	return SortLIsEmpty(((const pq_list_ty *)engine)->sortl);
+}
+
+static size_t ListSizeImp(const void *engine)
+{
+	return SortLCount(((const pq_list_ty *)engine)->sortl);
+}
+
+static void ListClearImp(void *engine)
+{
+	/* dequeue each element until it gets empty */
+	while (!ListIsEmptyImp(engine))
+	{
+		ListDequeueImp(engine);
+	}
+}
+
+static void *ListEraseImp(void *engine, PQIsMatch match_func, void *param)
+{
+	sortl_ty *sortl = ((pq_list_ty *)engine)->sortl;
+ 	sortl_itr_ty end = SortLEnd(sortl);
+ 	sortl_itr_ty to_erase = {NULL};
+ 	void *ret_data = NULL;
 	
 	/* get an iterator to a matched element */
-	to_erase = SortLFindIf(begin, end, match_func, param);
+	to_erase = SortLFindIf(SortLBegin(sortl), end, match_func, param);
 	
 	/* In case find failed return NULL */	
 	if (SortLIsSameIter(to_erase, end))
@@ -173,6 +842,746 @@ void *PQueueErase(pqueue_ty *pqueue, const PQIsMatch match_func, void *param)
 	return ret_data;
 }
 
+static int ListForEachImp(void *engine, PQVisitFunc visit_func, void *param)
+{
+	sortl_ty *sortl = ((pq_list_ty *)engine)->sortl;
+	sortl_itr_ty runner = SortLBegin(sortl);
+	sortl_itr_ty end = SortLEnd(sortl);
+	int status = 0;
+	
+	/* the list is already in priority order */
+	while (0 == status && !SortLIsSameIter(runner, end))
+	{
+		status = visit_func(SortLGetData(runner), param);
+		runner = SortLNext(runner);
+	}
+	
+	return status;
+}
 
+static int ListAppendImp(void *engine, void *data)
+{
+	pq_list_ty *list = (pq_list_ty *)engine;
+	sortl_itr_ty where = SortLAppend(list->sortl, data);
+	
+	if (SortLIsSameIter(where, SortLEnd(list->sortl)))
+	{
+		return 1;
+	}
+	
+	if (NULL != list->tracker)
+	{
+		list->tracker->handle_func_p(data, list->tracker->param)->iter = where;
+	}
+	
+	return 0;
+}
+
+static void ListTrackImp(void *engine, pq_tracker_ty *tracker)
+{
+	((pq_list_ty *)engine)->tracker = tracker;
+}
+
+static size_t ListEraseIfImp(void *engine, PQIsMatch match_func, void *match_param,
+								PQReleaseFunc out_func, void *out_param)
+{
+	sortl_ty *sortl = ((pq_list_ty *)engine)->sortl;
+	sortl_itr_ty runner = SortLBegin(sortl);
+	sortl_itr_ty end = SortLEnd(sortl);
+	size_t removed = 0;
+	void *data = NULL;
+	
+	/* one traversal - removing returns the next node */
+	while (!SortLIsSameIter(runner, end))
+	{
+		data = SortLGetData(runner);
+		
+		if (match_func(data, match_param))
+		{
+			runner = SortLRemove(runner);
+			out_func(data, out_param);
+			++removed;
+		}
+		else
+		{
+			runner = SortLNext(runner);
+		}
+	}
+	
+	return removed;
+}
+
+/* list nodes never move - the iterator of the insertion is still valid */
+static void *ListEraseAtImp(void *engine, const pq_handle_ty *handle)
+{
+	void *data = SortLGetData(handle->iter);
+	
+	UNUSED(engine);
+	
+	SortLRemove(handle->iter);
+	
+	return data;
+}
+
+/* nodes are relinked in place - the tracked iterators stay valid */
+static void ListSetCmpParamImp(void *engine, const void *cmp_param)
+{
+	SortLSetCmpParam(((pq_list_ty *)engine)->sortl, cmp_param);
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int StreamWriteImp(pq_stream_ty *stream, const void *src, size_t size)
+{
+	const unsigned char *runner = (const unsigned char *)src;
+	size_t chunk = 0;
+	
+	while (0 < size)
+	{
+		if (PQ_IO_BUFFER_SIZE == stream->used && 0 != StreamFlushImp(stream))
+		{
+			return 1;
+		}
+		
+		chunk = PQ_IO_BUFFER_SIZE - stream->used;
+		chunk = (chunk < size) ? chunk : size;
+		
+		memcpy(stream->buffer + stream->used, runner, chunk);
+		stream->used += chunk;
+		runner += chunk;
+		size -= chunk;
+	}
+	
+	return 0;
+}
+
+static int StreamFlushImp(pq_stream_ty *stream)
+{
+	size_t written = 0;
+	ssize_t ret = 0;
+	
+	while (written < stream->used)
+	{
+		ret = write(stream->fd, stream->buffer + written, stream->used - written);
+		
+		if (0 > ret && EINTR != errno)
+		{
+			return 1;
+		}
+		
+		written += (0 < ret) ? (size_t)ret : 0;
+	}
+	
+	stream->used = 0;
+	
+	return 0;
+}
+
+/* read exactly size bytes; non-zero on I/O error or end of file */
+static int StreamReadImp(pq_stream_ty *stream, void *dest, size_t size)
+{
+	unsigned char *runner = (unsigned char *)dest;
+	size_t chunk = 0;
+	ssize_t ret = 0;
+	
+	while (0 < size)
+	{
+		if (stream->pos == stream->used)
+		{
+			ret = read(stream->fd, stream->buffer, PQ_IO_BUFFER_SIZE);
+			
+			if (0 > ret && EINTR == errno)
+			{
+				continue;
+			}
+			
+			if (0 >= ret)
+			{
+				return 1;
+			}
+			
+			stream->used = (size_t)ret;
+			stream->pos = 0;
+		}
+		
+		chunk = stream->used - stream->pos;
+		chunk = (chunk < size) ? chunk : size;
+		
+		memcpy(runner, stream->buffer + stream->pos, chunk);
+		stream->pos += chunk;
+		runner += chunk;
+		size -= chunk;
+	}
+	
+	return 0;
+}
+
+/* little endian, independent of the host */
+static void EncodeImp(unsigned char *dest, size_t value, size_t num_bytes)
+{
+	size_t i = 0;
+	
+	for (i = 0; i < num_bytes; ++i)
+	{
+		dest[i] = (unsigned char)(value & 0xFF);
+		value >>= BYTE;
+	}
+}
+
+static size_t DecodeImp(const unsigned char *src, size_t num_bytes)
+{
+	size_t value = 0;
+	size_t i = num_bytes;
+	
+	while (0 < i)
+	{
+		--i;
+		value <<= BYTE;
+		value |= src[i];
+	}
+	
+	return value;
+}
+
+/* write one length prefixed record */
+static int SaveRecordImp(void *data, void *param)
+{
+	pq_save_ty *save = (pq_save_ty *)param;
+	unsigned char *bigger = NULL;
+	unsigned char length[PQ_LENGTH_SIZE] = {0};
+	size_t needed = 0;
+	int status = 0;
+	
+	needed = save->serialize_func(data, save->record, save->record_size, 
+								  save->param);
+	
+	if (needed > PQ_MAX_RECORD_SIZE)
+	{
+		return 1;
+	}
+	
+	/* grow the record buffer and serialize again */
+	if (needed > save->record_size)
+	{
+		bigger = (unsigned char *)realloc(save->record, needed);
+		
+		if (NULL == bigger)
+		{
+			return 1;
+		}
+		
+		save->record = bigger;
+		save->record_size = needed;
+		needed = save->serialize_func(data, save->record, save->record_size, 
+									  save->param);
+		
+		/* still not written */
+		if (needed > save->record_size)
+		{
+			return 1;
+		}
+	}
+	
+	EncodeImp(length, needed, PQ_LENGTH_SIZE);
+	status = StreamWriteImp(save->stream, length, PQ_LENGTH_SIZE);
+	status = status || StreamWriteImp(save->stream, save->record, needed);
+	
+	return status;
+}
+
+/* add data through add_func (enqueue or append), keeping the index */
+static int AddImp(pqueue_ty *pqueue, void *data, int (*add_func)(void *, void *))
+{
+	if (NULL == pqueue->index)
+	{
+		return add_func(pqueue->engine, data);
+	}
+	
+	/* the entry exists before the engine reports the handle */
+	if (0 != IndexAddImp(pqueue->index, data))
+	{
+		return 1;
+	}
+	
+	if (0 != add_func(pqueue->engine, data))
+	{
+		IndexRemoveImp(pqueue->index, data);
+		return 1;
+	}
+	
+	return 0;
+}
+
+/* the index first - only the items it took are added; one by one when the
+	engine has no batch_func */
+static size_t AddBatchImp(pqueue_ty *pqueue, void **items, size_t n, 
+							size_t (*batch_func)(void *, void **, size_t))
+{
+	size_t added = 0;
+	size_t i = 0;
+	
+	if (NULL != pqueue->index)
+	{
+		while (i < n && 0 == IndexAddImp(pqueue->index, items[i]))
+		{
+			++i;
+		}
+		
+		n = i;
+	}
+	
+	if (NULL != batch_func)
+	{
+		added = batch_func(pqueue->engine, items, n);
+	}
+	else
+	{
+		while (added < n && 0 == pqueue->ops->enqueue(pqueue->engine, items[added]))
+		{
+			++added;
+		}
+	}
+	
+	for (i = added; NULL != pqueue->index && i < n; ++i)
+	{
+		IndexRemoveImp(pqueue->index, items[i]);
+	}
+	
+	return added;
+}
+
+
+/* a removed element leaves the index before it reaches the user */
+static void EraseIfOutImp(void *data, void *param)
+{
+	pq_erase_if_ty *erase_if = (pq_erase_if_ty *)param;
+	
+	if (NULL != erase_if->index)
+	{
+		IndexRemoveImp(erase_if->index, data);
+	}
+	
+	if (NULL != erase_if->out_func)
+	{
+		erase_if->out_func(data, erase_if->param);
+	}
+}
+
+/* stable sort of items on nchunks threads: each sorts a chunk, then pairs of
+	chunks are merged, every pair on its own thread, until one is left */
+static int BulkSortImp(pqueue_ty *pqueue, void **items, size_t n, size_t nchunks)
+{
+	pq_bulk_task_ty *tasks = NULL;
+	void **tmp = NULL;
+	void **src = items;
+	void **dst = NULL;
+	void **swap = NULL;
+	size_t width = 1;
+	size_t count = 0;
+	size_t i = 0;
+	
+	tasks = (pq_bulk_task_ty *)malloc(nchunks * sizeof(pq_bulk_task_ty));
+	tmp = (void **)malloc(n * sizeof(void *));
+	
+	if (NULL == tasks || NULL == tmp)
+	{
+		free(tasks);
+		free(tmp);
+		return 1;
+	}
+	
+	dst = tmp;
+	
+	for (i = 0; i < nchunks; ++i)
+	{
+		tasks[i].src = items;
+		tasks[i].dst = tmp;
+		tasks[i].lo = ChunkBeginImp(n, nchunks, i);
+		tasks[i].hi = ChunkBeginImp(n, nchunks, i + 1);
+		tasks[i].mid = tasks[i].hi;
+		tasks[i].is_sort = 1;
+		tasks[i].cmp_func = pqueue->cmp_func;
+		tasks[i].cmp_param = pqueue->cmp_param;
+	}
+	
+	BulkRunImp(tasks, nchunks);
+	
+	/* each round merges pairs of the runs of the previous one into dst */
+	for (width = 1; width < nchunks; width *= 2)
+	{
+		for (i = 0, count = 0; i < nchunks; i += 2 * width, ++count)
+		{
+			tasks[count].src = src;
+			tasks[count].dst = dst;
+			tasks[count].lo = ChunkBeginImp(n, nchunks, i);
+			tasks[count].mid = ChunkBeginImp(n, nchunks, 
+								(i + width < nchunks) ? i + width : nchunks);
+			tasks[count].hi = ChunkBeginImp(n, nchunks, 
+								(i + 2 * width < nchunks) ? i + 2 * width : nchunks);
+			tasks[count].is_sort = 0;
+		}
+		
+		BulkRunImp(tasks, count);
+		
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+	
+	if (src != items)
+	{
+		memcpy(items, src, n * sizeof(void *));
+	}
+	
+	free(tasks);
+	free(tmp);
+	
+	return 0;
+}
 
-
+/* the first task on the calling thread; one which gets no thread runs there
+	too, so a failed pthread_create only costs time */
+static void BulkRunImp(pq_bulk_task_ty *tasks, size_t count)
+{
+	size_t i = 0;
+	
+	for (i = 1; i < count; ++i)
+	{
+		tasks[i].has_thread = (0 == pthread_create(&tasks[i].thread, NULL, 
+												   BulkTaskImp, &tasks[i]));
+		
+		if (!tasks[i].has_thread)
+		{
+			BulkTaskImp(&tasks[i]);
+		}
+	}
+	
+	BulkTaskImp(&tasks[0]);
+	
+	for (i = 1; i < count; ++i)
+	{
+		if (tasks[i].has_thread)
+		{
+			pthread_join(tasks[i].thread, NULL);
+		}
+	}
+}
+
+static void *BulkTaskImp(void *task)
+{
+	pq_bulk_task_ty *step = (pq_bulk_task_ty *)task;
+	
+	if (step->is_sort)
+	{
+		SortRangeImp(step->src, step->dst, step->lo, step->hi, 
+					 step->cmp_func, step->cmp_param);
+	}
+	else
+	{
+		MergeRangesImp(step->src, step->dst, step->lo, step->mid, step->hi, 
+					   step->cmp_func, step->cmp_param);
+	}
+	
+	return NULL;
+}
+
+/* stable bottom-up merge sort of items[lo, hi); tmp[lo, hi) is scratch */
+static void SortRangeImp(void **items, void **tmp, size_t lo, size_t hi, 
+							PQCmpFunc cmp_func, const void *cmp_param)
+{
+	void **src = items;
+	void **dst = tmp;
+	void **swap = NULL;
+	size_t width = 1;
+	size_t from = 0;
+	size_t mid = 0;
+	size_t to = 0;
+	
+	for (width = 1; width < hi - lo; width *= 2)
+	{
+		for (from = lo; from < hi; from += 2 * width)
+		{
+			mid = (width < hi - from) ? from + width : hi;
+			to = (2 * width < hi - from) ? from + 2 * width : hi;
+			
+			MergeRangesImp(src, dst, from, mid, to, cmp_func, cmp_param);
+		}
+		
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+	
+	if (src != items)
+	{
+		memcpy(items + lo, src + lo, (hi - lo) * sizeof(void *));
+	}
+}
+
+/* take from the left run on ties to keep the sort stable */
+static void MergeRangesImp(void **src, void **dst, size_t lo, size_t mid, 
+							size_t hi, PQCmpFunc cmp_func, const void *cmp_param)
+{
+	size_t left = lo;
+	size_t right = mid;
+	
+	while (left < mid && right < hi)
+	{
+		if (0 < cmp_func(src[left], src[right], cmp_param))
+		{
+			dst[lo++] = src[right++];
+		}
+		else
+		{
+			dst[lo++] = src[left++];
+		}
+	}
+	
+	memcpy(dst + lo, src + left, (mid - left) * sizeof(void *));
+	memcpy(dst + lo + (mid - left), src + right, (hi - right) * sizeof(void *));
+}
+
+/* chunk begins spread the remainder of n / nchunks over the first chunks */
+static size_t ChunkBeginImp(size_t n, size_t nchunks, size_t chunk)
+{
+	return chunk * (n / nchunks) + ((chunk < n % nchunks) ? chunk : n % nchunks);
+}
+
+
+/*******************************************************************************
+***************************** Key Index ***************************************/
+static pq_key_index_ty *IndexCreateImp(PQKeyFunc key_func, PQHashFunc hash_func,
+										PQIsMatch match_func, void *param)
+{
+	pq_key_index_ty *index = (pq_key_index_ty *)malloc(sizeof(pq_key_index_ty));
+	size_t i = 0;
+	
+	if (NULL == index)
+	{
+		return NULL;
+	}
+	
+	index->num_buckets = PQ_INDEX_INIT_BUCKETS;
+	index->by_key = (pq_key_entry_ty **)malloc(index->num_buckets * 
+												sizeof(pq_key_entry_ty *));
+	index->by_data = (pq_key_entry_ty **)malloc(index->num_buckets * 
+												sizeof(pq_key_entry_ty *));
+	
+	if (NULL == index->by_key || NULL == index->by_data)
+	{
+		free(index->by_key);
+		free(index->by_data);
+		free(index);
+		return NULL;
+	}
+	
+	for (i = 0; i < index->num_buckets; ++i)
+	{
+		index->by_key[i] = NULL;
+		index->by_data[i] = NULL;
+	}
+	
+	index->count = 0;
+	index->key_func = key_func;
+	index->hash_func = hash_func;
+	index->match_func = match_func;
+	index->param = param;
+	index->tracker.handle_func_p = IndexHandleImp;
+	index->tracker.param = index;
+	
+	return index;
+}
+
+static void IndexDestroyImp(pq_key_index_ty *index)
+{
+	IndexClearImp(index);
+	
+	free(index->by_key);
+	free(index->by_data);
+	
+	DEBUG_MODE
+	(
+		index->by_key = INVALID_PTR;
+		index->by_data = INVALID_PTR;
+	)
+	free(index);
+}
+
+static int IndexAddImp(pq_key_index_ty *index, void *data)
+{
+	pq_key_entry_ty *entry = NULL;
+	size_t slot = 0;
+	
+	/* at one entry per bucket; when growing fails it is only slower */
+	if (index->count >= index->num_buckets)
+	{
+		IndexGrowImp(index);
+	}
+	
+	entry = (pq_key_entry_ty *)malloc(sizeof(pq_key_entry_ty));
+	
+	if (NULL == entry)
+	{
+		return 1;
+	}
+	
+	entry->data = data;
+	entry->key_hash = MixImp(index->hash_func(index->key_func(data, index->param),
+											  index->param));
+	
+	slot = entry->key_hash & (index->num_buckets - 1);
+	entry->next_by_key = index->by_key[slot];
+	index->by_key[slot] = entry;
+	
+	slot = MixImp((size_t)data) & (index->num_buckets - 1);
+	entry->next_by_data = index->by_data[slot];
+	index->by_data[slot] = entry;
+	
+	++index->count;
+	
+	return 0;
+}
+
+/* by address only - data is not read */
+static void IndexRemoveImp(pq_key_index_ty *index, const void *data)
+{
+	pq_key_entry_ty **link = IndexFindDataImp(index, data);
+	pq_key_entry_ty *entry = *link;
+	
+	assert (NULL != entry && "PQueue: element is not in the key index");
+	
+	*link = entry->next_by_data;
+	
+	link = &index->by_key[entry->key_hash & (index->num_buckets - 1)];
+	
+	while (*link != entry)
+	{
+		link = &(*link)->next_by_key;
+	}
+	
+	*link = entry->next_by_key;
+	
+	free(entry);
+	--index->count;
+}
+
+static void IndexClearImp(pq_key_index_ty *index)
+{
+	pq_key_entry_ty *entry = NULL;
+	size_t i = 0;
+	
+	for (i = 0; i < index->num_buckets; ++i)
+	{
+		while (NULL != index->by_key[i])
+		{
+			entry = index->by_key[i];
+			index->by_key[i] = entry->next_by_key;
+			free(entry);
+		}
+		
+		index->by_data[i] = NULL;
+	}
+	
+	index->count = 0;
+}
+
+static void IndexGrowImp(pq_key_index_ty *index)
+{
+	size_t num_buckets = 2 * index->num_buckets;
+	pq_key_entry_ty **by_key = NULL;
+	pq_key_entry_ty **by_data = NULL;
+	pq_key_entry_ty *entry = NULL;
+	size_t slot = 0;
+	size_t i = 0;
+	
+	by_key = (pq_key_entry_ty **)malloc(num_buckets * sizeof(pq_key_entry_ty *));
+	by_data = (pq_key_entry_ty **)malloc(num_buckets * sizeof(pq_key_entry_ty *));
+	
+	if (NULL == by_key || NULL == by_data)
+	{
+		free(by_key);
+		free(by_data);
+		return;
+	}
+	
+	for (i = 0; i < num_buckets; ++i)
+	{
+		by_key[i] = NULL;
+		by_data[i] = NULL;
+	}
+	
+	/* every entry is in exactly one chain by key */
+	for (i = 0; i < index->num_buckets; ++i)
+	{
+		while (NULL != index->by_key[i])
+		{
+			entry = index->by_key[i];
+			index->by_key[i] = entry->next_by_key;
+			
+			slot = entry->key_hash & (num_buckets - 1);
+			entry->next_by_key = by_key[slot];
+			by_key[slot] = entry;
+			
+			slot = MixImp((size_t)entry->data) & (num_buckets - 1);
+			entry->next_by_data = by_data[slot];
+			by_data[slot] = entry;
+		}
+	}
+	
+	free(index->by_key);
+	free(index->by_data);
+	
+	index->by_key = by_key;
+	index->by_data = by_data;
+	index->num_buckets = num_buckets;
+}
+
+static pq_key_entry_ty *IndexFindKeyImp(const pq_key_index_ty *index, const void *key)
+{
+	size_t key_hash = MixImp(index->hash_func(key, index->param));
+	pq_key_entry_ty *runner = index->by_key[key_hash & (index->num_buckets - 1)];
+	
+	while (NULL != runner && (runner->key_hash != key_hash || 
+		   !index->match_func(runner->data, key)))
+	{
+		runner = runner->next_by_key;
+	}
+	
+	return runner;
+}
+
+/* the link that points at the entry of data (at NULL when it is not found) */
+static pq_key_entry_ty **IndexFindDataImp(const pq_key_index_ty *index, const void *data)
+{
+	pq_key_entry_ty **link = NULL;
+	
+	link = &index->by_data[MixImp((size_t)data) & (index->num_buckets - 1)];
+	
+	while (NULL != *link && (*link)->data != data)
+	{
+		link = &(*link)->next_by_data;
+	}
+	
+	return link;
+}
+
+/* the tracker of the engine */
+static pq_handle_ty *IndexHandleImp(const void *data, void *param)
+{
+	pq_key_entry_ty *entry = *IndexFindDataImp((pq_key_index_ty *)param, data);
+	
+	assert (NULL != entry && "PQueue: element is not in the key index");
+	
+	return &entry->handle;
+}
+
+/* the buckets are chosen by the low bits - spread the high ones into them */
+static size_t MixImp(size_t hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x45D9F3BUL;
+	hash ^= hash >> 16;
+	
+	return hash;
+}
@@ -0,0 +1,259 @@
+/*******************************************************************************
+******************************* - QUANTILE - **********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of Running quantile (median) tracker
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "heap.h"
+#include "quantile.h"
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "Quantile tracker is not allocated");
+
+/* The elements up to the quantile are in a max heap (lower), the rest in
+	a min heap (upper); the top of lower is the quantile. The heaps report
+	the moves of a handle, so it is removed at its index.				*/
+struct quantile_handle
+{
+	void *data;
+	heap_ty *heap;			/* lower or upper */
+	size_t index;
+};
+
+struct quantile
+{
+	heap_ty *lower;
+	heap_ty *upper;
+	double q;
+	QuantileCmpFunc cmp_func;
+	const void *cmp_param;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int CmpLowerImp(const void *handle1, const void *handle2, const void *param);
+static int CmpUpperImp(const void *handle1, const void *handle2, const void *param);
+static void MoveImp(void *handle, size_t index, void *heap);
+static int MoveTopImp(heap_ty *from, heap_ty *to);
+static int RebalanceImp(quantile_ty *tracker);
+static void FreeHeapImp(heap_ty *heap);
+
+/*******************************************************************************
+***************************** Quantile Create *********************************/
+quantile_ty *QuantileCreate(double q, QuantileCmpFunc cmp_func_p, const void *cmp_param)
+{
+	quantile_ty *tracker = NULL;
+
+	assert (NULL != cmp_func_p && "QuantileCreate: Function pointer is invalid");
+	assert (0 <= q && 1 >= q && "QuantileCreate: q is out of range");
+
+	tracker = (quantile_ty *)malloc(sizeof(quantile_ty));
+
+	if (NULL == tracker)
+	{
+		return NULL;
+	}
+
+	tracker->q = q;
+	tracker->cmp_func = cmp_func_p;
+	tracker->cmp_param = cmp_param;
+	tracker->lower = HeapCreate(CmpLowerImp, tracker);
+	tracker->upper = HeapCreate(CmpUpperImp, tracker);
+
+	if (NULL == tracker->lower || NULL == tracker->upper)
+	{
+		if (NULL != tracker->lower)
+		{
+			HeapDestroy(tracker->lower);
+		}
+
+		if (NULL != tracker->upper)
+		{
+			HeapDestroy(tracker->upper);
+		}
+
+		free(tracker);
+		return NULL;
+	}
+
+	HeapSetMoveFunc(tracker->lower, MoveImp, tracker->lower);
+	HeapSetMoveFunc(tracker->upper, MoveImp, tracker->upper);
+
+	return tracker;
+}
+
+/*******************************************************************************
+***************************** Quantile Destroy ********************************/
+void QuantileDestroy(quantile_ty *tracker)
+{
+	ASSERT_NOT_NULL_IMP(tracker);
+
+	FreeHeapImp(tracker->lower);
+	FreeHeapImp(tracker->upper);
+
+	DEBUG_MODE
+	(
+		tracker->lower = INVALID_PTR;
+		tracker->upper = INVALID_PTR;
+	)
+	free(tracker);
+}
+
+/*******************************************************************************
+***************************** Quantile Insert *********************************/
+quantile_handle_ty *QuantileInsert(quantile_ty *tracker, void *data)
+{
+	quantile_handle_ty *handle = NULL;
+	quantile_handle_ty *lower_top = NULL;
+	heap_ty *heap = NULL;
+
+	ASSERT_NOT_NULL_IMP(tracker);
+
+	handle = (quantile_handle_ty *)malloc(sizeof(quantile_handle_ty));
+
+	if (NULL == handle)
+	{
+		return NULL;
+	}
+
+	handle->data = data;
+	lower_top = (quantile_handle_ty *)HeapPeek(tracker->lower);
+	heap = (NULL == lower_top ||
+			0 >= tracker->cmp_func(data, lower_top->data, tracker->cmp_param)) ?
+			tracker->lower : tracker->upper;
+
+	if (0 != HeapPush(heap, handle))
+	{
+		free(handle);
+		return NULL;
+	}
+
+	/* a failed move changed nothing - taking handle out restores the balance */
+	if (0 != RebalanceImp(tracker))
+	{
+		HeapRemoveAt(handle->heap, handle->index);
+		free(handle);
+		return NULL;
+	}
+
+	return handle;
+}
+
+/*******************************************************************************
+***************************** Quantile Remove *********************************/
+void *QuantileRemove(quantile_ty *tracker, quantile_handle_ty *handle)
+{
+	void *data = NULL;
+
+	ASSERT_NOT_NULL_IMP(tracker);
+	assert (NULL != handle && "QuantileRemove: handle is invalid");
+
+	HeapRemoveAt(handle->heap, handle->index);
+	data = handle->data;
+	free(handle);
+
+	/* moves into the heap which lost an element - no allocation */
+	RebalanceImp(tracker);
+
+	return data;
+}
+
+/*******************************************************************************
+***************************** Quantile Get ************************************/
+void *QuantileGet(const quantile_ty *tracker)
+{
+	quantile_handle_ty *top = NULL;
+
+	ASSERT_NOT_NULL_IMP(tracker);
+
+	top = (quantile_handle_ty *)HeapPeek(tracker->lower);
+
+	return (NULL == top) ? NULL : top->data;
+}
+
+/*******************************************************************************
+***************************** Quantile Size ***********************************/
+size_t QuantileSize(const quantile_ty *tracker)
+{
+	ASSERT_NOT_NULL_IMP(tracker);
+
+	return HeapSize(tracker->lower) + HeapSize(tracker->upper);
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+
+/* lower is a max heap - the biggest of the small elements on top */
+static int CmpLowerImp(const void *handle1, const void *handle2, const void *param)
+{
+	const quantile_ty *tracker = (const quantile_ty *)param;
+
+	return tracker->cmp_func(((const quantile_handle_ty *)handle2)->data,
+							((const quantile_handle_ty *)handle1)->data,
+							tracker->cmp_param);
+}
+
+static int CmpUpperImp(const void *handle1, const void *handle2, const void *param)
+{
+	const quantile_ty *tracker = (const quantile_ty *)param;
+
+	return tracker->cmp_func(((const quantile_handle_ty *)handle1)->data,
+							((const quantile_handle_ty *)handle2)->data,
+							tracker->cmp_param);
+}
+
+static void MoveImp(void *handle, size_t index, void *heap)
+{
+	((quantile_handle_ty *)handle)->heap = (heap_ty *)heap;
+	((quantile_handle_ty *)handle)->index = index;
+}
+
+static int MoveTopImp(heap_ty *from, heap_ty *to)
+{
+	if (0 != HeapPush(to, HeapPeek(from)))
+	{
+		return 1;
+	}
+
+	HeapPop(from);
+
+	return 0;
+}
+
+/* lower keeps floor(q * (n - 1)) + 1 of n elements; at most one move */
+static int RebalanceImp(quantile_ty *tracker)
+{
+	size_t n = QuantileSize(tracker);
+	size_t target = (0 == n) ? 0 : (size_t)(tracker->q * (double)(n - 1)) + 1;
+
+	if (HeapSize(tracker->lower) > target)
+	{
+		return MoveTopImp(tracker->lower, tracker->upper);
+	}
+
+	if (HeapSize(tracker->lower) < target)
+	{
+		return MoveTopImp(tracker->upper, tracker->lower);
+	}
+
+	return 0;
+}
+
+static void FreeHeapImp(heap_ty *heap)
+{
+	while (!HeapIsEmpty(heap))
+	{
+		free(HeapPop(heap));
+	}
+
+	HeapDestroy(heap);
+}
@@ -10,6 +10,7 @@
 
 #include <stdlib.h>			/* malloc, free*/
 #include <assert.h>			/* assert */
+#include <limits.h>			/* CHAR_BIT */
 
 #include "utilities.h"
 #include "sorted_list.h"
@@ -17,26 +18,72 @@
 #define ASSERT_NOT_NULL_IMP(ptr)								\
 		assert (NULL != ptr && "Sort LIST is not allocated");
 
+#define SKIP_MAX_HEIGHT 16		/* 4^16 elements */
+#define FINGER_MAX_STEPS 4		/* from the hint, before using the index */
+#define MERGE_MIN_GALLOP 7		/* run length which starts galloping */
+#define SORT_MAX_PENDING (sizeof(size_t) * CHAR_BIT + 1)	/* runs to merge */
+
+/* Skip index: towers over some of the dlist nodes. A node gets a tower of 
+	height h with probability 1/4^h, so one node in 4 has one; a search goes 
+	down the towers and ends with a few steps in the dlist. A node without
+	a tower is still in order - a failed tower allocation is not an error. */
+typedef struct sortl_tower
+{
+	dlist_itr_ty node;
+	size_t height;
+	struct sortl_tower **next;
+} sortl_tower_ty;
+
+typedef struct sortl_skip
+{
+	sortl_tower_ty *head;			/* of SKIP_MAX_HEIGHT, on no node */
+	size_t height;
+	unsigned long seed;
+} sortl_skip_ty;
 
 struct sortl 
 {
     dlist_ty *dlist;
 	CmpFunc p_cmp_func;
     const void *cmp_param;
+    sortl_skip_ty *skip;			/* NULL when there is no index */
+    dlist_itr_ty finger;			/* last insertion, or next to a removed one */
 };
 
-typedef struct callback_params_sl
-{
-	CmpFunc cmp_func_p;
-	const void *cmp_param;
-	void *user_data;
-} callback_params_sl_ty;
-
 
 /*******************************************************************************
 ***************************** Side-Functions **********************************/
-int IsBiggerImp(const void *element_data, const void *param);
-int IsEqualImp(const void *element_data, const void *param);
+static void SortArrayImp(void **items, void **tmp, size_t n, 
+							CmpFunc cmp_func_p, const void *cmp_param);
+static void SortNodesImp(sortl_ty *sort_list);
+static dlist_itr_ty RunEndImp(const sortl_ty *sort_list, dlist_itr_ty from, 
+								dlist_itr_ty end);
+static dlist_itr_ty MergeRunsImp(const sortl_ty *sort_list, dlist_itr_ty left, 
+									dlist_itr_ty right, dlist_itr_ty end);
+static dlist_itr_ty MergeRunImp(const sortl_ty *sort_list, dlist_itr_ty from, 
+								dlist_itr_ty end, const void *data, int is_upper, 
+								int is_galloping, size_t *length);
+static int IsInRunImp(const sortl_ty *sort_list, dlist_itr_ty node, 
+						const void *data, int is_upper);
+static dlist_itr_ty BoundImp(const sortl_ty *sort_list, const void *data, 
+								int is_upper, sortl_tower_ty **update);
+static dlist_itr_ty DescendImp(const sortl_ty *sort_list, const void *data, 
+								int is_upper, sortl_tower_ty **update);
+static dlist_itr_ty FingerImp(const sortl_ty *sort_list, dlist_itr_ty where, 
+								const void *data);
+static sortl_tower_ty *TowerCreateImp(size_t height, dlist_itr_ty node);
+static size_t DrawHeightImp(sortl_skip_ty *skip);
+static sortl_skip_ty *SkipCreateImp(void);
+static void SkipDestroyImp(sortl_skip_ty *skip);
+static void SkipClearImp(sortl_skip_ty *skip);
+static void SkipBuildImp(sortl_ty *sort_list);
+static void SkipLinkRangeImp(const sortl_ty *sort_list, sortl_tower_ty **last, 
+								dlist_itr_ty from, dlist_itr_ty to);
+static void SkipUnlinkRangeImp(const sortl_ty *sort_list, dlist_itr_ty from, 
+								dlist_itr_ty to);
+static void SkipLinkImp(const sortl_ty *sort_list, sortl_tower_ty **update, 
+						dlist_itr_ty node);
+static void SkipUnlinkImp(const sortl_ty *sort_list, dlist_itr_ty node);
 
 /*******************************************************************************
 ***************************** SortL Create ************************************/
@@ -68,6 +115,65 @@ sortl_ty *SortLCreate(const CmpFunc cmp_func_p, const void *cmp_param)
 	/* init slist fields */
 	sort_list->p_cmp_func = cmp_func_p;
 	sort_list->cmp_param = cmp_param;
+	sort_list->skip = NULL;
+	sort_list->finger = DListEnd(sort_list->dlist);
+	
+	return sort_list;
+}
+
+/*******************************************************************************
+***************************** SortL CreateFromArray ***************************/
+sortl_ty *SortLCreateFromArray(const CmpFunc cmp_func_p, const void *cmp_param, 
+								void **items, size_t n)
+{
+	sortl_ty *sort_list = NULL;
+	void **sorted = NULL;
+	void **from = items;
+	size_t i = 0;
+	
+	assert (NULL != items || 0 == n);
+	
+	sort_list = SortLCreate(cmp_func_p, cmp_param);
+	
+	if (NULL == sort_list)
+	{
+		return NULL;
+	}
+	
+	/* sort a copy of the array, which is faster to walk than the nodes; 
+		without memory for it the nodes are sorted in place */
+	if (1 < n)
+	{
+		sorted = (void **)malloc(2 * n * sizeof(void *));
+	}
+	
+	if (NULL != sorted)
+	{
+		for (i = 0; i < n; ++i)
+		{
+			sorted[i] = items[i];
+		}
+		
+		SortArrayImp(sorted, sorted + n, n, cmp_func_p, cmp_param);
+		from = sorted;
+	}
+	
+	for (i = 0; i < n; ++i)
+	{
+		if (0 != DListPushBack(sort_list->dlist, from[i]))
+		{
+			free(sorted);
+			SortLDestroy(sort_list);
+			return NULL;
+		}
+	}
+	
+	if (NULL == sorted)
+	{
+		SortNodesImp(sort_list);
+	}
+	
+	free(sorted);
 	
 	return sort_list;
 }
@@ -76,28 +182,41 @@ sortl_ty *SortLCreate(const CmpFunc cmp_func_p, const void *cmp_param)
 ***************************** SortL Insert ************************************/
 sortl_itr_ty SortLInsert(sortl_ty *sort_list, void *data)
 {
-	callback_params_sl_ty callback_params = {NULL};
-	IsMatchFunc is_bigger_p = IsBiggerImp;
-	sortl_itr_ty begin = {NULL};
-	sortl_itr_ty end = {NULL};
-	sortl_itr_ty return_itr = {NULL};
+	sortl_itr_ty hint = {NULL};
 	
     /* debug only */
 	ASSERT_NOT_NULL_IMP(sort_list);
 	
-	/* fill cmp_objects_package fields with comparison information */
-	callback_params.cmp_func_p = sort_list->p_cmp_func;
-	callback_params.cmp_param = sort_list->cmp_param;
-	callback_params.user_data = data;
+	/* search from the last insertion - the end at first */
+	hint.dlist_itr = sort_list->finger;
+	hint.sortl = sort_list;
 	
-	begin = SortLBegin(sort_list);
-	end = SortLEnd(sort_list);
+	return SortLInsertHint(sort_list, hint, data);
+}
 
-	/* find an element which its data is bigger than the data provided by the user. */
-	return_itr = SortLFindIf(begin, end, is_bigger_p, &callback_params);
-									
-	/* insert new node in the returned location */
-	return_itr.dlist_itr = DListInsert(return_itr.dlist_itr, data);
+/*******************************************************************************
+***************************** SortL InsertHint ********************************/
+sortl_itr_ty SortLInsertHint(sortl_ty *sort_list, sortl_itr_ty hint, void *data)
+{
+	sortl_itr_ty return_itr = {NULL};
+	
+	ASSERT_NOT_NULL_IMP(sort_list);
+	assert (hint.sortl == sort_list && "SortLInsertHint: hint is not in list");
+	
+	/* insert before the first element which is bigger than data */
+	return_itr.dlist_itr = DListInsert(FingerImp(sort_list, hint.dlist_itr, data), 
+									   data);
+	return_itr.sortl = sort_list;
+	
+	if (!DListIsSameIter(return_itr.dlist_itr, DListEnd(sort_list->dlist)))
+	{
+		sort_list->finger = return_itr.dlist_itr;
+		
+		if (NULL != sort_list->skip)
+		{
+			SkipLinkImp(sort_list, NULL, return_itr.dlist_itr);
+		}
+	}
 	
 	return return_itr;
 }
@@ -117,6 +236,11 @@ void SortLDestroy(sortl_ty *sort_list)
 {
 	ASSERT_NOT_NULL_IMP(sort_list);
 	
+	if (NULL != sort_list->skip)
+	{
+		SkipDestroyImp(sort_list->skip);
+	}
+	
 	/* free dlist with DListDestroy */
 	DListDestroy(sort_list->dlist);
 	
@@ -147,6 +271,7 @@ sortl_itr_ty SortLBegin(sortl_ty *sort_list)
 	ASSERT_NOT_NULL_IMP(sort_list);
 	
 	begin.dlist_itr = DListBegin(sort_list->dlist);
+	begin.sortl = sort_list;
 	
 	return begin;
 }
@@ -162,6 +287,7 @@ sortl_itr_ty SortLEnd(sortl_ty *sort_list)
 	ASSERT_NOT_NULL_IMP(sort_list);
 	
 	end.dlist_itr = DListEnd(sort_list->dlist);
+	end.sortl = sort_list;
 	
 	return end;
 }
@@ -174,6 +300,7 @@ sortl_itr_ty SortLNext(sortl_itr_ty iter)
 	sortl_itr_ty next = {NULL};
 	
 	next.dlist_itr = DListNext(iter.dlist_itr);
+	next.sortl = iter.sortl;
 	
 	return next;
 }
@@ -185,6 +312,7 @@ sortl_itr_ty SortLPrev(sortl_itr_ty iter)
 	sortl_itr_ty prev = {NULL};
 	
 	prev.dlist_itr = DListPrev(iter.dlist_itr);
+	prev.sortl = iter.sortl;
 	
 	return prev;
 }
@@ -201,49 +329,63 @@ int SortLIsSameIter(sortl_itr_ty iter1, sortl_itr_ty iter2)
 ***************************** SortL Merge *************************************/
 void SortLMerge(sortl_ty *dest, sortl_ty *donor)
 {
-	callback_params_sl_ty callb_params = {NULL};
-		
-	sortl_itr_ty dest_where = {NULL};		
-	sortl_itr_ty donor_from = {NULL};		
-	sortl_itr_ty donor_to = {NULL};		
+	dlist_itr_ty where = {NULL};
+	dlist_itr_ty dest_end = {NULL};
+	dlist_itr_ty from = {NULL};
+	dlist_itr_ty to = {NULL};
+	dlist_itr_ty donor_end = {NULL};
+	size_t dest_run = 0;
+	size_t donor_run = 0;
+	int is_galloping = 0;
 
 	ASSERT_NOT_NULL_IMP(dest);
 	ASSERT_NOT_NULL_IMP(donor);
 	
-	dest_where = SortLBegin(dest);
-	donor_from = SortLBegin(donor);
-
-	/* fill cmp_objects_package fields with dest's comparison information */
-	callb_params.cmp_func_p = dest->p_cmp_func;
-	callb_params.cmp_param = dest->cmp_param;
-	callb_params.user_data = SortLGetData(donor_from);
+	where = DListBegin(dest->dlist);
+	dest_end = DListEnd(dest->dlist);
+	donor_end = DListEnd(donor->dlist);
 	
-	/* traverse dest list until the end */
-	while(!SortLIsEmpty(donor))
+	while (!DListIsEmpty(donor->dlist))
 	{
-		/* in dest traverse 'where' until is bigger than 'from' donor element */
-		dest_where = SortLFindIf(dest_where, SortLEnd(dest), IsBiggerImp, &callb_params);
-		/* change param comparison to dest_where value */
-		callb_params.user_data = SortLGetData(dest_where);
+		from = DListBegin(donor->dlist);
 		
-		/* In case where got the the end of dest, the rest of donor will be copied to dest */
-		if (SortLIsSameIter(dest_where, SortLEnd(dest)))
-		{
-			donor_to = SortLEnd(donor);
-		}
-		else
+		/* dest elements not bigger than 'from' stay before it - on ties dest 
+			goes first to keep the merge stable */
+		where = MergeRunImp(dest, where, dest_end, DListGetData(from), 1, 
+							is_galloping, &dest_run);
+		
+		/* where got to the end of dest - the rest of donor is moved after it */
+		if (DListIsSameIter(where, dest_end))
 		{
-			/* in donor traverse 'to' until is bigger than 'where' dest element */
-			donor_to = SortLFindIf(donor_from, SortLEnd(donor), IsBiggerImp, &callb_params);
-			/* change param comparison to donor_to value */
-			callb_params.user_data = SortLGetData(donor_to);
+			DListSplice(dest_end, from, donor_end);
+			break;
 		}
-
-		/* copy and remove range of donor elements to dest list */	
-		DListSplice(dest_where.dlist_itr, donor_from.dlist_itr, donor_to.dlist_itr);
 		
-		donor_from = donor_to;
-	}		
+		/* donor elements smaller than 'where' go before it; 'from' is one */
+		to = MergeRunImp(dest, DListNext(from), donor_end, DListGetData(where), 0, 
+						 is_galloping, &donor_run);
+		DListSplice(where, from, to);
+		
+		/* the next donor element is not smaller than 'where' */
+		where = DListNext(where);
+		
+		/* long runs on either side - gallop until they get short again */
+		is_galloping = (MERGE_MIN_GALLOP <= dest_run || 
+						MERGE_MIN_GALLOP <= donor_run);
+	}
+	
+	/* the nodes of donor are in dest now */
+	if (NULL != dest->skip)
+	{
+		SkipBuildImp(dest);
+	}
+	
+	if (NULL != donor->skip)
+	{
+		SkipClearImp(donor->skip);
+	}
+	
+	donor->finger = DListEnd(donor->dlist);
 }
 
 /* PsuedoCode
@@ -253,28 +395,327 @@ donor	2	--	3	--	22	--	36	--	77	--	600	--	END
 		from-to											end
 */
 
+/*******************************************************************************
+***************************** SortL Append ************************************/
+sortl_itr_ty SortLAppend(sortl_ty *sort_list, void *data)
+{
+	sortl_itr_ty ret_itr = {NULL};
+	
+	ASSERT_NOT_NULL_IMP(sort_list);
+	
+	assert ((DListIsEmpty(sort_list->dlist) || 
+			0 >= sort_list->p_cmp_func(DListGetData(DListPrev(DListEnd(sort_list->dlist))), 
+									   data, sort_list->cmp_param))
+	&& "SortLAppend: data is smaller than the last element");
+	
+	ret_itr.dlist_itr = DListInsert(DListEnd(sort_list->dlist), data);
+	ret_itr.sortl = sort_list;
+	
+	if (!DListIsSameIter(ret_itr.dlist_itr, DListEnd(sort_list->dlist)))
+	{
+		sort_list->finger = ret_itr.dlist_itr;
+		
+		if (NULL != sort_list->skip)
+		{
+			SkipLinkImp(sort_list, NULL, ret_itr.dlist_itr);
+		}
+	}
+	
+	return ret_itr;
+}
+
+
+/*******************************************************************************
+***************************** SortL InsertBatch *******************************/
+size_t SortLInsertBatch(sortl_ty *sort_list, void **items, size_t n)
+{
+	void **tmp = NULL;
+	size_t i = 0;
+	
+	ASSERT_NOT_NULL_IMP(sort_list);
+	assert (NULL != items || 0 == n);
+	
+	/* a batch already in order is not sorted again */
+	for (i = 1; i < n && 0 >= sort_list->p_cmp_func(items[i - 1], items[i], 
+													 sort_list->cmp_param); ++i)
+	{
+		/* empty */
+	}
+	
+	if (i < n)
+	{
+		tmp = (void **)malloc(n * sizeof(void *));
+		
+		if (NULL == tmp)
+		{
+			return 0;
+		}
+		
+		SortArrayImp(items, tmp, n, sort_list->p_cmp_func, sort_list->cmp_param);
+		free(tmp);
+	}
+	
+	return SortLInsertSorted(sort_list, items, n);
+}
+
+/*******************************************************************************
+***************************** SortL InsertSorted ******************************/
+size_t SortLInsertSorted(sortl_ty *sort_list, void **items, size_t n)
+{
+	dlist_itr_ty where = {NULL};
+	dlist_itr_ty end = {NULL};
+	dlist_itr_ty ret_itr = {NULL};
+	size_t i = 0;
+	
+	ASSERT_NOT_NULL_IMP(sort_list);
+	assert (NULL != items || 0 == n);
+	
+	DEBUG_MODE
+	(
+		for (i = 1; i < n; ++i)
+		{
+			assert (0 >= sort_list->p_cmp_func(items[i - 1], items[i], 
+											   sort_list->cmp_param) && 
+					"SortLInsertSorted: items are not in order");
+		}
+	)
+	
+	where = DListBegin(sort_list->dlist);
+	end = DListEnd(sort_list->dlist);
+	
+	/* one pass over the list, the batch is already sorted */
+	for (i = 0; i < n; ++i)
+	{
+		/* skip list elements which are not bigger than the current item */
+		while (!DListIsSameIter(where, end) && 
+			   0 >= sort_list->p_cmp_func(DListGetData(where), items[i], 
+			   							  sort_list->cmp_param))
+		{
+			where = DListNext(where);
+		}
+		
+		ret_itr = DListInsert(where, items[i]);
+		
+		/* check if insertion faild */
+		if (DListIsSameIter(ret_itr, end))
+		{
+			break;
+		}
+	}
+	
+	if (NULL != sort_list->skip)
+	{
+		SkipBuildImp(sort_list);
+	}
+	
+	return i;
+}
+
+/*******************************************************************************
+***************************** SortL Adopt *************************************/
+void SortLAdopt(sortl_ty *sort_list, dlist_ty *dlist)
+{
+	ASSERT_NOT_NULL_IMP(sort_list);
+	assert (NULL != dlist && dlist != sort_list->dlist && 
+			"SortLAdopt: dlist is invalid");
+	
+	if (DListIsEmpty(dlist))
+	{
+		return;
+	}
+	
+	/* the elements of list are one run, which goes first on ties */
+	DListSplice(DListEnd(sort_list->dlist), DListBegin(dlist), DListEnd(dlist));
+	SortNodesImp(sort_list);
+	
+	if (NULL != sort_list->skip)
+	{
+		SkipBuildImp(sort_list);
+	}
+}
+
+
+/*******************************************************************************
+***************************** SortL SetCmpParam *******************************/
+void SortLSetCmpParam(sortl_ty *sort_list, const void *cmp_param)
+{
+	ASSERT_NOT_NULL_IMP(sort_list);
+	
+	sort_list->cmp_param = cmp_param;
+	SortNodesImp(sort_list);
+	
+	if (NULL != sort_list->skip)
+	{
+		SkipBuildImp(sort_list);
+	}
+}
+
+
+/*******************************************************************************
+***************************** SortL SetSkipIndex ******************************/
+int SortLSetSkipIndex(sortl_ty *sort_list, int is_enabled)
+{
+	ASSERT_NOT_NULL_IMP(sort_list);
+	
+	if (!is_enabled && NULL != sort_list->skip)
+	{
+		SkipDestroyImp(sort_list->skip);
+		sort_list->skip = NULL;
+	}
+	else if (is_enabled && NULL == sort_list->skip)
+	{
+		sort_list->skip = SkipCreateImp();
+		
+		if (NULL == sort_list->skip)
+		{
+			return 1;
+		}
+		
+		SkipBuildImp(sort_list);
+	}
+	
+	return 0;
+}
+
+
 /*******************************************************************************
 ***************************** SortL Find **************************************/
 sortl_itr_ty SortLFind(const sortl_ty *sortl, const void *data)
 {
-	callback_params_sl_ty params = {NULL};
-	IsMatchFunc is_equal_p = IsEqualImp;
 	sortl_itr_ty ret_itr = {NULL};
 
 	ASSERT_NOT_NULL_IMP(sortl);
 	
-	/* fill callback_params_sl_ty fields with comparison information */
-	params.cmp_func_p = sortl->p_cmp_func;
-	params.cmp_param = sortl->cmp_param;
-	params.user_data = (void *)data;
+	/* the first element which is not smaller than data */
+	ret_itr.dlist_itr = BoundImp(sortl, data, 0, NULL);
+	ret_itr.sortl = (sortl_ty *)sortl;
 	
-	/* find an element which its data equals the data provided by the user */
-	ret_itr.dlist_itr = DListFind(DListBegin(sortl->dlist), DListEnd(sortl->dlist), 
-								is_equal_p, &params);
+	/* not equal - data is not in list */
+	if (!DListIsSameIter(ret_itr.dlist_itr, DListEnd(sortl->dlist)) &&
+		0 != sortl->p_cmp_func(DListGetData(ret_itr.dlist_itr), data, 
+							   sortl->cmp_param))
+	{
+		ret_itr.dlist_itr = DListEnd(sortl->dlist);
+	}
 	
 	return ret_itr;
 }
 
+/*******************************************************************************
+***************************** SortL Bounds ***********************************/
+sortl_itr_ty SortLLowerBound(const sortl_ty *sortl, const void *data)
+{
+	sortl_itr_ty ret_itr = {NULL};
+	
+	ASSERT_NOT_NULL_IMP(sortl);
+	
+	ret_itr.dlist_itr = BoundImp(sortl, data, 0, NULL);
+	ret_itr.sortl = (sortl_ty *)sortl;
+	
+	return ret_itr;
+}
+
+sortl_itr_ty SortLUpperBound(const sortl_ty *sortl, const void *data)
+{
+	sortl_itr_ty ret_itr = {NULL};
+	
+	ASSERT_NOT_NULL_IMP(sortl);
+	
+	ret_itr.dlist_itr = BoundImp(sortl, data, 1, NULL);
+	ret_itr.sortl = (sortl_ty *)sortl;
+	
+	return ret_itr;
+}
+
+void SortLEqualRange(const sortl_ty *sortl, const void *data, 
+						sortl_itr_ty *from, sortl_itr_ty *to)
+{
+	dlist_itr_ty runner = {NULL};
+	dlist_itr_ty end = {NULL};
+	
+	ASSERT_NOT_NULL_IMP(sortl);
+	assert (NULL != from && NULL != to);
+	
+	*from = SortLLowerBound(sortl, data);
+	runner = from->dlist_itr;
+	end = DListEnd(sortl->dlist);
+	
+	/* the equal ones follow the lower bound - no second search */
+	while (!DListIsSameIter(runner, end) && 
+		   0 == sortl->p_cmp_func(DListGetData(runner), data, sortl->cmp_param))
+	{
+		runner = DListNext(runner);
+	}
+	
+	to->dlist_itr = runner;
+	to->sortl = from->sortl;
+}
+
+
+/*******************************************************************************
+***************************** SortL ExtractRange ******************************/
+void SortLExtractRange(sortl_ty *sort_list, sortl_itr_ty from, sortl_itr_ty to, 
+						sortl_ty *out_list)
+{
+	sortl_tower_ty *last[SKIP_MAX_HEIGHT];
+	dlist_itr_ty out_last = {NULL};
+	int is_out_empty = 0;
+	size_t i = 0;
+	
+	ASSERT_NOT_NULL_IMP(sort_list);
+	ASSERT_NOT_NULL_IMP(out_list);
+	assert (sort_list != out_list && "SortLExtractRange: out_list is list");
+	assert (from.sortl == sort_list && to.sortl == sort_list && 
+			"SortLExtractRange: iterators are not in list");
+	
+	if (DListIsSameIter(from.dlist_itr, to.dlist_itr))
+	{
+		return;
+	}
+	
+	is_out_empty = DListIsEmpty(out_list->dlist);
+	
+	assert ((is_out_empty || 
+			0 >= out_list->p_cmp_func(DListGetData(DListPrev(DListEnd(out_list->dlist))), 
+									  DListGetData(from.dlist_itr), 
+									  out_list->cmp_param))
+	&& "SortLExtractRange: out_list has bigger elements");
+	
+	if (NULL != sort_list->skip)
+	{
+		SkipUnlinkRangeImp(sort_list, from.dlist_itr, to.dlist_itr);
+	}
+	
+	/* the last towers of out_list, before it gets the range */
+	if (NULL != out_list->skip)
+	{
+		for (i = 0; i < SKIP_MAX_HEIGHT; ++i)
+		{
+			last[i] = out_list->skip->head;
+		}
+		
+		DescendImp(out_list, DListGetData(from.dlist_itr), 1, last);
+	}
+	
+	if (!is_out_empty)
+	{
+		out_last = DListPrev(DListEnd(out_list->dlist));
+	}
+	
+	DListSplice(DListEnd(out_list->dlist), from.dlist_itr, to.dlist_itr);
+	
+	/* the finger may have moved with the range */
+	sort_list->finger = DListEnd(sort_list->dlist);
+	
+	if (NULL != out_list->skip)
+	{
+		SkipLinkRangeImp(out_list, last, is_out_empty ? DListBegin(out_list->dlist) : 
+										 DListNext(out_last), 
+						 DListEnd(out_list->dlist));
+	}
+}
+
+
 /*******************************************************************************
 ***************************** SortL IsEmpty ***********************************/
 
@@ -292,8 +733,24 @@ int SortLIsEmpty(const sortl_ty *sort_list)
 sortl_itr_ty SortLRemove(sortl_itr_ty iter)
 {
 	sortl_itr_ty ret_itr = {NULL};
+	int is_finger = 0;
+	
+	ASSERT_NOT_NULL_IMP(iter.sortl);
+	
+	if (NULL != iter.sortl->skip)
+	{
+		SkipUnlinkImp(iter.sortl, iter.dlist_itr);
+	}
 	
+	is_finger = DListIsSameIter(iter.sortl->finger, iter.dlist_itr);
 	ret_itr.dlist_itr = DListRemove(iter.dlist_itr);
+	ret_itr.sortl = iter.sortl;
+	
+	/* the neighbour keeps the finger where the next insertion is likely */
+	if (is_finger)
+	{
+		iter.sortl->finger = ret_itr.dlist_itr;
+	}
 	
 	return ret_itr;
 }
@@ -312,6 +769,7 @@ sortl_itr_ty SortLFindIf(sortl_itr_ty from, sortl_itr_ty to, IsMatchFunc is_matc
 	
 	/* find matched element; in case not found get the end of range */
 	ret_itr.dlist_itr = DListFind(from.dlist_itr, to.dlist_itr, is_match_func, param);
+	ret_itr.sortl = from.sortl;
 	
 	return ret_itr;
 }
@@ -319,34 +777,672 @@ sortl_itr_ty SortLFindIf(sortl_itr_ty from, sortl_itr_ty to, IsMatchFunc is_matc
 
 /*******************************************************************************
 ***************************** Side Functions **********************************/
-int IsBiggerImp(const void *element_data, const void *param)
+/* Stable bottom-up merge sort; tmp holds n elements */
+static void SortArrayImp(void **items, void **tmp, size_t n, 
+							CmpFunc cmp_func_p, const void *cmp_param)
+{
+	void **src = items;
+	void **dst = tmp;
+	void **swap = NULL;
+	size_t width = 1;
+	size_t lo = 0;
+	size_t mid = 0;
+	size_t hi = 0;
+	size_t left = 0;
+	size_t right = 0;
+	size_t out = 0;
+	
+	for (width = 1; width < n; width *= 2)
+	{
+		for (lo = 0; lo < n; lo += 2 * width)
+		{
+			mid = (lo + width < n) ? lo + width : n;
+			hi = (lo + 2 * width < n) ? lo + 2 * width : n;
+			
+			left = lo;
+			right = mid;
+			out = lo;
+			
+			while (left < mid && right < hi)
+			{
+				/* take from the left run on ties to keep the sort stable */
+				if (0 < cmp_func_p(src[left], src[right], cmp_param))
+				{
+					dst[out++] = src[right++];
+				}
+				else
+				{
+					dst[out++] = src[left++];
+				}
+			}
+			
+			while (left < mid)
+			{
+				dst[out++] = src[left++];
+			}
+			
+			while (right < hi)
+			{
+				dst[out++] = src[right++];
+			}
+		}
+		
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+	
+	/* the sorted result ended up in the temporary buffer */
+	if (src != items)
+	{
+		for (lo = 0; lo < n; ++lo)
+		{
+			items[lo] = src[lo];
+		}
+	}
+}
+
+/* natural merge sort: the sorted runs are found once and merged as in a 
+	binary counter - a pending run for each bit of the number of runs, so 
+	an element is merged O(log(runs)) times							*/
+static void SortNodesImp(sortl_ty *sort_list)
+{
+	dlist_itr_ty pending[SORT_MAX_PENDING];		/* begins of the runs */
+	dlist_itr_ty from = DListBegin(sort_list->dlist);
+	dlist_itr_ty next = {NULL};
+	dlist_itr_ty end = DListEnd(sort_list->dlist);
+	size_t depth = 0;
+	size_t runs = 0;
+	size_t bits = 0;
+	
+	while (!DListIsSameIter(from, end))
+	{
+		next = RunEndImp(sort_list, from, end);
+		pending[depth++] = from;
+		++runs;
+		
+		/* carry: merge the two last runs for each trailing 0 bit */
+		for (bits = runs; 0 == (bits & 1); bits >>= 1)
+		{
+			--depth;
+			pending[depth - 1] = MergeRunsImp(sort_list, pending[depth - 1], 
+											  pending[depth], next);
+		}
+		
+		from = next;
+	}
+	
+	while (1 < depth)
+	{
+		--depth;
+		pending[depth - 1] = MergeRunsImp(sort_list, pending[depth - 1], 
+										  pending[depth], end);
+	}
+}
+
+/* first element of [from, end) smaller than the one before it; end if none */
+static dlist_itr_ty RunEndImp(const sortl_ty *sort_list, dlist_itr_ty from, 
+								dlist_itr_ty end)
+{
+	dlist_itr_ty next = DListNext(from);
+	
+	while (!DListIsSameIter(next, end) && 
+		   0 >= sort_list->p_cmp_func(DListGetData(from), DListGetData(next), 
+		   							  sort_list->cmp_param))
+	{
+		from = next;
+		next = DListNext(next);
+	}
+	
+	return next;
+}
+
+/* merge the runs [left, right) and [right, end); nodes are spliced, so end 
+	and every other iterator stay valid. Returns the begin of the merged run */
+static dlist_itr_ty MergeRunsImp(const sortl_ty *sort_list, dlist_itr_ty left, 
+									dlist_itr_ty right, dlist_itr_ty end)
+{
+	dlist_itr_ty begin = left;
+	dlist_itr_ty to = {NULL};
+	
+	while (!DListIsSameIter(left, right) && !DListIsSameIter(right, end))
+	{
+		/* move the right elements smaller than left before it - on ties the 
+			left one goes first to keep the sort stable */
+		to = right;
+		
+		while (!DListIsSameIter(to, end) && 
+			   0 > sort_list->p_cmp_func(DListGetData(to), DListGetData(left), 
+			   							 sort_list->cmp_param))
+		{
+			to = DListNext(to);
+		}
+		
+		if (!DListIsSameIter(to, right))
+		{
+			if (DListIsSameIter(left, begin))
+			{
+				begin = right;
+			}
+			
+			DListSplice(left, right, to);
+			right = to;
+		}
+		
+		left = DListNext(left);
+	}
+	
+	return begin;
+}
+
+/* end of the run of [from, end) which is before data: the first element 
+	bigger than data (is_upper) or not smaller than data. Galloping compares 
+	the elements 1, 2, 4.. after the last one known in the run, then halves 
+	the gap it overshot: O(log k) comparisons for a run of k, still k steps 
+	and a few more, as a dlist has no random access. length gets k		*/
+static dlist_itr_ty MergeRunImp(const sortl_ty *sort_list, dlist_itr_ty from, 
+								dlist_itr_ty end, const void *data, int is_upper, 
+								int is_galloping, size_t *length)
+{
+	dlist_itr_ty last = from;
+	dlist_itr_ty probe = from;
+	size_t step = 1;
+	size_t gap = 0;
+	size_t half = 0;
+	size_t i = 0;
+	
+	*length = 0;
+	
+	if (!is_galloping)
+	{
+		while (!DListIsSameIter(probe, end) && 
+			   IsInRunImp(sort_list, probe, data, is_upper))
+		{
+			probe = DListNext(probe);
+			++*length;
+		}
+		
+		return probe;
+	}
+	
+	if (DListIsSameIter(from, end) || !IsInRunImp(sort_list, from, data, is_upper))
+	{
+		return from;
+	}
+	
+	*length = 1;
+	
+	/* probe 'step' elements after 'last'; gap of unknown ones in between */
+	for (;;)
+	{
+		probe = last;
+		
+		for (i = 0; i < step && !DListIsSameIter(probe, end); ++i)
+		{
+			probe = DListNext(probe);
+		}
+		
+		gap = i - 1;
+		
+		if (DListIsSameIter(probe, end) || 
+			!IsInRunImp(sort_list, probe, data, is_upper))
+		{
+			break;
+		}
+		
+		last = probe;
+		*length += step;
+		step *= 2;
+	}
+	
+	/* the run ends in the gap after 'last', or at probe */
+	while (0 < gap)
+	{
+		half = (gap + 1) / 2;
+		
+		for (probe = last, i = 0; i < half; ++i)
+		{
+			probe = DListNext(probe);
+		}
+		
+		if (IsInRunImp(sort_list, probe, data, is_upper))
+		{
+			last = probe;
+			*length += half;
+			gap -= half;
+		}
+		else
+		{
+			gap = half - 1;
+		}
+	}
+	
+	return DListNext(last);
+}
+
+static int IsInRunImp(const sortl_ty *sort_list, dlist_itr_ty node, 
+						const void *data, int is_upper)
+{
+	int cmp = sort_list->p_cmp_func(DListGetData(node), data, sort_list->cmp_param);
+	
+	return (0 > cmp || (0 == cmp && is_upper));
+}
+
+/* first element bigger than data (is_upper) or not smaller than data; 
+	update (may be NULL) gets the last tower before it at each level	*/
+static dlist_itr_ty BoundImp(const sortl_ty *sort_list, const void *data, 
+								int is_upper, sortl_tower_ty **update)
+{
+	dlist_itr_ty runner = DescendImp(sort_list, data, is_upper, update);
+	dlist_itr_ty end = DListEnd(sort_list->dlist);
+	int cmp = 0;
+	
+	/* the last steps - in the dlist */
+	while (!DListIsSameIter(runner, end))
+	{
+		cmp = sort_list->p_cmp_func(DListGetData(runner), data, sort_list->cmp_param);
+		
+		if (0 < cmp || (0 == cmp && !is_upper))
+		{
+			break;
+		}
+		
+		runner = DListNext(runner);
+	}
+	
+	return runner;
+}
+
+/* go down the towers; return the node to continue from in the dlist */
+static dlist_itr_ty DescendImp(const sortl_ty *sort_list, const void *data, 
+								int is_upper, sortl_tower_ty **update)
+{
+	sortl_tower_ty *tower = NULL;
+	size_t level = 0;
+	int cmp = 0;
+	
+	if (NULL == sort_list->skip)
+	{
+		return DListBegin(sort_list->dlist);
+	}
+	
+	tower = sort_list->skip->head;
+	
+	for (level = sort_list->skip->height; 0 < level; --level)
+	{
+		while (NULL != tower->next[level - 1])
+		{
+			cmp = sort_list->p_cmp_func(DListGetData(tower->next[level - 1]->node), 
+										data, sort_list->cmp_param);
+			
+			if (0 < cmp || (0 == cmp && !is_upper))
+			{
+				break;
+			}
+			
+			tower = tower->next[level - 1];
+		}
+		
+		if (NULL != update)
+		{
+			update[level - 1] = tower;
+		}
+	}
+	
+	return (tower == sort_list->skip->head) ? DListBegin(sort_list->dlist) : 
+											  DListNext(tower->node);
+}
+
+/* first element bigger than data, walking from where in the direction of 
+	data; far from where, the index is used when there is one			*/
+static dlist_itr_ty FingerImp(const sortl_ty *sort_list, dlist_itr_ty where, 
+								const void *data)
+{
+	dlist_itr_ty begin = DListBegin(sort_list->dlist);
+	dlist_itr_ty end = DListEnd(sort_list->dlist);
+	size_t max_steps = (NULL == sort_list->skip) ? ~(size_t)0 : FINGER_MAX_STEPS;
+	size_t steps = 0;
+	
+	if (!DListIsSameIter(where, end) && 
+		0 >= sort_list->p_cmp_func(DListGetData(where), data, sort_list->cmp_param))
+	{
+		/* forward, over the elements which are not bigger */
+		where = DListNext(where);
+		
+		while (!DListIsSameIter(where, end) && 
+			   0 >= sort_list->p_cmp_func(DListGetData(where), data, 
+			   							  sort_list->cmp_param))
+		{
+			if (++steps == max_steps)
+			{
+				return BoundImp(sort_list, data, 1, NULL);
+			}
+			
+			where = DListNext(where);
+		}
+	}
+	else if (!DListIsSameIter(where, begin) && 
+			 0 < sort_list->p_cmp_func(DListGetData(begin), data, 
+			 						   sort_list->cmp_param))
+	{
+		/* smaller than all - a new head needs no walk */
+		where = begin;
+	}
+	else
+	{
+		/* backward, while the previous one is still bigger */
+		while (!DListIsSameIter(where, begin) && 
+			   0 < sort_list->p_cmp_func(DListGetData(DListPrev(where)), data, 
+			   							 sort_list->cmp_param))
+		{
+			if (++steps == max_steps)
+			{
+				return BoundImp(sort_list, data, 1, NULL);
+			}
+			
+			where = DListPrev(where);
+		}
+	}
+	
+	return where;
+}
+
+/* the next pointers are allocated with the tower */
+static sortl_tower_ty *TowerCreateImp(size_t height, dlist_itr_ty node)
 {
-	int is_bigger = 0;
+	sortl_tower_ty *tower = NULL;
+	size_t i = 0;
+	
+	tower = (sortl_tower_ty *)malloc(sizeof(sortl_tower_ty) + 
+									 height * sizeof(sortl_tower_ty *));
+	
+	if (NULL == tower)
+	{
+		return NULL;
+	}
+	
+	tower->node = node;
+	tower->height = height;
+	tower->next = (sortl_tower_ty **)(tower + 1);
 	
-	/* convert 'param' to callback_params_sl_ty data type */
-	callback_params_sl_ty callb_params = *(callback_params_sl_ty *)param;
+	for (i = 0; i < height; ++i)
+	{
+		tower->next[i] = NULL;
+	}
+	
+	return tower;
+}
 
-	/* determine if data's node element is bigger than param value */	
-	is_bigger = callb_params.cmp_func_p(element_data, callb_params.user_data, 
-										callb_params.cmp_param);
+/* xorshift; each level is one more pair of zero bits */
+static size_t DrawHeightImp(sortl_skip_ty *skip)
+{
+	unsigned long bits = skip->seed;
+	size_t height = 0;
+	
+	bits ^= bits << 13;
+	bits &= 0xFFFFFFFFUL;
+	bits ^= bits >> 17;
+	bits ^= bits << 5;
+	bits &= 0xFFFFFFFFUL;
+	skip->seed = bits;
+	
+	while (height < SKIP_MAX_HEIGHT && 0 == (bits & 3))
+	{
+		++height;
+		bits >>= 2;
+	}
+	
+	return height;
+}
+
+static sortl_skip_ty *SkipCreateImp(void)
+{
+	sortl_skip_ty *skip = (sortl_skip_ty *)malloc(sizeof(sortl_skip_ty));
+	dlist_itr_ty no_node = {NULL};
+	
+	if (NULL == skip)
+	{
+		return NULL;
+	}
+	
+	skip->head = TowerCreateImp(SKIP_MAX_HEIGHT, no_node);
+	skip->height = 0;
+	skip->seed = 2463534242UL;
+	
+	if (NULL == skip->head)
+	{
+		free(skip);
+		return NULL;
+	}
+	
+	return skip;
+}
 
-	return (is_bigger > 0);
+static void SkipDestroyImp(sortl_skip_ty *skip)
+{
+	SkipClearImp(skip);
+	free(skip->head);
+	
+	DEBUG_MODE
+	(
+		skip->head = INVALID_PTR;
+	)
+	free(skip);
 }
 
-int IsEqualImp(const void *element_data, const void *param)
+static void SkipClearImp(sortl_skip_ty *skip)
 {
-	int is_equal = 0;
+	sortl_tower_ty *tower = skip->head->next[0];
+	sortl_tower_ty *next = NULL;
+	size_t i = 0;
+	
+	while (NULL != tower)
+	{
+		next = tower->next[0];
+		free(tower);
+		tower = next;
+	}
 	
-	/* convert 'param' to callback_params_sl_ty data type */
-	callback_params_sl_ty callb_params = *(callback_params_sl_ty *)param;
+	for (i = 0; i < SKIP_MAX_HEIGHT; ++i)
+	{
+		skip->head->next[i] = NULL;
+	}
 	
-	/* determine if data's node element equals to param value */	
-	is_equal = callb_params.cmp_func_p(element_data, callb_params.user_data, 
-										callb_params.cmp_param);
+	skip->height = 0;
+}
 
-	return (is_equal == 0);
+/* new towers for all the nodes in one pass - each one goes last */
+static void SkipBuildImp(sortl_ty *sort_list)
+{
+	sortl_tower_ty *last[SKIP_MAX_HEIGHT];
+	size_t i = 0;
+	
+	SkipClearImp(sort_list->skip);
+	
+	for (i = 0; i < SKIP_MAX_HEIGHT; ++i)
+	{
+		last[i] = sort_list->skip->head;
+	}
+	
+	SkipLinkRangeImp(sort_list, last, DListBegin(sort_list->dlist), 
+					 DListEnd(sort_list->dlist));
 }
 
+/* towers for the nodes [from, to), which are after all the towers; last 
+	holds the last tower of each level									*/
+static void SkipLinkRangeImp(const sortl_ty *sort_list, sortl_tower_ty **last, 
+								dlist_itr_ty from, dlist_itr_ty to)
+{
+	sortl_tower_ty *tower = NULL;
+	size_t i = 0;
+	
+	while (!DListIsSameIter(from, to))
+	{
+		SkipLinkImp(sort_list, last, from);
+		
+		/* the new tower, if any, is the last one of its levels */
+		tower = last[0]->next[0];
+		
+		for (i = 0; NULL != tower && i < tower->height; ++i)
+		{
+			last[i] = tower;
+		}
+		
+		from = DListNext(from);
+	}
+}
 
+/* remove the towers of the nodes [from, to) - they are in a row */
+static void SkipUnlinkRangeImp(const sortl_ty *sort_list, dlist_itr_ty from, 
+								dlist_itr_ty to)
+{
+	sortl_tower_ty *update[SKIP_MAX_HEIGHT];
+	sortl_skip_ty *skip = sort_list->skip;
+	sortl_tower_ty *tower = NULL;
+	sortl_tower_ty *next = NULL;
+	dlist_itr_ty runner = {NULL};
+	size_t i = 0;
+	
+	if (0 == skip->height)
+	{
+		return;
+	}
+	
+	runner = DescendImp(sort_list, DListGetData(from), 0, update);
+	tower = update[0]->next[0];
+	
+	/* the towers of the equal elements before from stay */
+	while (!DListIsSameIter(runner, from))
+	{
+		if (NULL != tower && DListIsSameIter(tower->node, runner))
+		{
+			for (i = 0; i < tower->height; ++i)
+			{
+				update[i] = tower;
+			}
+			
+			tower = tower->next[0];
+		}
+		
+		runner = DListNext(runner);
+	}
+	
+	while (!DListIsSameIter(runner, to))
+	{
+		if (NULL != tower && DListIsSameIter(tower->node, runner))
+		{
+			next = tower->next[0];
+			
+			for (i = 0; i < tower->height; ++i)
+			{
+				update[i]->next[i] = tower->next[i];
+			}
+			
+			free(tower);
+			tower = next;
+		}
+		
+		runner = DListNext(runner);
+	}
+	
+	while (0 < skip->height && NULL == skip->head->next[skip->height - 1])
+	{
+		--skip->height;
+	}
+}
 
+/* give node a tower, after the towers of update; when update is NULL
+	they are searched only if the tower is not empty					*/
+static void SkipLinkImp(const sortl_ty *sort_list, sortl_tower_ty **update, 
+						dlist_itr_ty node)
+{
+	sortl_tower_ty *found[SKIP_MAX_HEIGHT];
+	sortl_skip_ty *skip = sort_list->skip;
+	sortl_tower_ty *tower = NULL;
+	sortl_tower_ty *prev = NULL;
+	size_t height = DrawHeightImp(skip);
+	size_t i = 0;
+	
+	if (0 == height)
+	{
+		return;
+	}
+	
+	tower = TowerCreateImp(height, node);
+	
+	/* no tower - the node is found through the dlist */
+	if (NULL == tower)
+	{
+		return;
+	}
+	
+	if (NULL == update)
+	{
+		DescendImp(sort_list, DListGetData(node), 1, found);
+		update = found;
+	}
+	
+	for (i = 0; i < height; ++i)
+	{
+		prev = (i < skip->height) ? update[i] : skip->head;
+		tower->next[i] = prev->next[i];
+		prev->next[i] = tower;
+	}
+	
+	if (height > skip->height)
+	{
+		skip->height = height;
+	}
+}
 
+/* remove the tower of node, if it has one */
+static void SkipUnlinkImp(const sortl_ty *sort_list, dlist_itr_ty node)
+{
+	sortl_tower_ty *update[SKIP_MAX_HEIGHT];
+	sortl_skip_ty *skip = sort_list->skip;
+	sortl_tower_ty *tower = NULL;
+	sortl_tower_ty *prev = NULL;
+	void *data = DListGetData(node);
+	size_t i = 0;
+	
+	DescendImp(sort_list, data, 0, update);
+	
+	if (0 == skip->height)
+	{
+		return;
+	}
+	
+	/* the towers of equal elements are in a row */
+	tower = update[0]->next[0];
+	
+	while (NULL != tower && !DListIsSameIter(tower->node, node) &&
+		   0 == sort_list->p_cmp_func(DListGetData(tower->node), data, 
+		   							  sort_list->cmp_param))
+	{
+		tower = tower->next[0];
+	}
+	
+	if (NULL == tower || !DListIsSameIter(tower->node, node))
+	{
+		return;
+	}
+	
+	for (i = 0; i < tower->height; ++i)
+	{
+		prev = update[i];
+		
+		while (prev->next[i] != tower)
+		{
+			prev = prev->next[i];
+		}
+		
+		prev->next[i] = tower->next[i];
+	}
+	
+	free(tower);
+	
+	while (0 < skip->height && NULL == skip->head->next[skip->height - 1])
+	{
+		--skip->height;
+	}
+}
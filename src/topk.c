@@ -0,0 +1,210 @@
+/*******************************************************************************
+********************************* - TOP K - ***********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of Streaming top-K accumulator
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "heap.h"
+#include "topk.h"
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "TopK is not allocated");
+
+/* a min heap of the kept items - the threshold is its top */
+struct topk
+{
+	heap_ty *heap;
+	size_t k;
+	void *threshold;		/* NULL until k items are kept */
+	TopKCmpFunc cmp_func;
+	const void *cmp_param;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static void *KeepImp(topk_ty *tk, void *item);
+
+/*******************************************************************************
+***************************** TopK Create *************************************/
+topk_ty *TopKCreate(size_t k, TopKCmpFunc cmp_func_p, const void *cmp_param)
+{
+	topk_ty *tk = NULL;
+
+	assert (NULL != cmp_func_p && "TopKCreate: Function pointer is invalid");
+
+	tk = (topk_ty *)malloc(sizeof(topk_ty));
+
+	if (NULL == tk)
+	{
+		return NULL;
+	}
+
+	tk->heap = HeapCreate(cmp_func_p, cmp_param);
+
+	if (NULL == tk->heap || 0 != HeapReserve(tk->heap, k))
+	{
+		if (NULL != tk->heap)
+		{
+			HeapDestroy(tk->heap);
+		}
+
+		free(tk);
+		return NULL;
+	}
+
+	tk->k = k;
+	tk->threshold = NULL;
+	tk->cmp_func = cmp_func_p;
+	tk->cmp_param = cmp_param;
+
+	return tk;
+}
+
+/*******************************************************************************
+***************************** TopK Destroy ************************************/
+void TopKDestroy(topk_ty *tk)
+{
+	ASSERT_NOT_NULL_IMP(tk);
+
+	HeapDestroy(tk->heap);
+
+	DEBUG_MODE
+	(
+		tk->heap = INVALID_PTR;
+	)
+	free(tk);
+}
+
+/*******************************************************************************
+***************************** TopK Offer **************************************/
+void *TopKOffer(topk_ty *tk, void *item)
+{
+	ASSERT_NOT_NULL_IMP(tk);
+
+	if (NULL != tk->threshold &&
+		0 >= tk->cmp_func(item, tk->threshold, tk->cmp_param))
+	{
+		return item;
+	}
+
+	return KeepImp(tk, item);
+}
+
+/*******************************************************************************
+***************************** TopK OfferBatch *********************************/
+size_t TopKOfferBatch(topk_ty *tk, void **items, size_t n)
+{
+	TopKCmpFunc cmp_func = NULL;
+	const void *cmp_param = NULL;
+	void *threshold = NULL;
+	void *dropped = NULL;
+	size_t num_dropped = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(tk);
+	assert ((NULL != items || 0 == n) && "TopKOfferBatch: items is invalid");
+
+	cmp_func = tk->cmp_func;
+	cmp_param = tk->cmp_param;
+	threshold = tk->threshold;
+
+	for (i = 0; i < n; ++i)
+	{
+		/* the common case stays in this loop, away from the heap */
+		if (NULL != threshold && 0 >= cmp_func(items[i], threshold, cmp_param))
+		{
+			items[num_dropped++] = items[i];
+			continue;
+		}
+
+		dropped = KeepImp(tk, items[i]);
+		threshold = tk->threshold;
+
+		if (NULL != dropped)
+		{
+			items[num_dropped++] = dropped;
+		}
+	}
+
+	return num_dropped;
+}
+
+/*******************************************************************************
+***************************** TopK Result *************************************/
+size_t TopKResult(topk_ty *tk, void **out)
+{
+	size_t size = 0;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(tk);
+	assert ((NULL != out || 0 == tk->k) && "TopKResult: out is invalid");
+
+	size = HeapSize(tk->heap);
+
+	/* the heap pops the smallest first */
+	for (i = size; 0 < i; --i)
+	{
+		out[i - 1] = HeapPop(tk->heap);
+	}
+
+	/* within the reserved capacity - does not fail */
+	HeapPushBatch(tk->heap, out, size);
+	tk->threshold = (size == tk->k) ? HeapPeek(tk->heap) : NULL;
+
+	return size;
+}
+
+/*******************************************************************************
+***************************** TopK Threshold **********************************/
+void *TopKThreshold(const topk_ty *tk)
+{
+	ASSERT_NOT_NULL_IMP(tk);
+
+	return tk->threshold;
+}
+
+/*******************************************************************************
+***************************** TopK Size ***************************************/
+size_t TopKSize(const topk_ty *tk)
+{
+	ASSERT_NOT_NULL_IMP(tk);
+
+	return HeapSize(tk->heap);
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+
+/* item passed the threshold: push it, or replace the threshold */
+static void *KeepImp(topk_ty *tk, void *item)
+{
+	void *evicted = NULL;
+
+	if (0 == tk->k)
+	{
+		return item;
+	}
+
+	if (HeapSize(tk->heap) < tk->k)
+	{
+		/* within the reserved capacity - does not fail */
+		HeapPush(tk->heap, item);
+	}
+	else
+	{
+		evicted = HeapReplaceTop(tk->heap, item);
+	}
+
+	tk->threshold = (HeapSize(tk->heap) == tk->k) ? HeapPeek(tk->heap) : NULL;
+
+	return evicted;
+}
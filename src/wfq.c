@@ -0,0 +1,360 @@
+/*******************************************************************************
+************************ - WEIGHTED FAIR QUEUING - *****************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Implementation of Weighted fair queuing across tenants
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+#include <limits.h>			/* ULONG_MAX */
+
+#include "utilities.h"
+#include "heap.h"
+#include "wfq.h"
+
+#define WFQ_UNIT_BITS 16
+#define WFQ_VIRTUAL_UNIT (1UL << WFQ_UNIT_BITS)	/* of cost 1 at weight 1 */
+#define WFQ_MAX_SPAN (ULONG_MAX / 2)	/* of one element - keeps tags comparable */
+
+#define ASSERT_NOT_NULL_IMP(ptr)								\
+		assert (NULL != ptr && "WFQ is not allocated");
+
+/* Self-clocked fair queuing: the virtual time is the finish tag of the
+	last served element. The head of an active tenant starts when the
+	previous one finished (or at the virtual time, for an idle tenant) and
+	finishes cost / weight later. Active tenants are in a heap by the
+	finish tag of their head.
+	The tags run modulo ULONG_MAX + 1. Every finish tag of an active
+	tenant is at most one span past the virtual time, so with spans
+	capped at WFQ_MAX_SPAN two tags compare by the sign of their
+	difference, across a wrap as well.								*/
+typedef struct entry
+{
+	void *data;
+	unsigned long cost;
+} entry_ty;
+
+typedef struct tenant
+{
+	pqueue_ty *entries;
+	unsigned long weight;
+	unsigned long start;		/* of the head */
+	unsigned long finish;		/* of the head; the last one when idle */
+	size_t index;				/* in the heap of tenants */
+	size_t id;
+	int is_active;
+} tenant_ty;
+
+struct wfq
+{
+	tenant_ty *tenants;
+	size_t num_tenants;
+	heap_ty *active;
+	unsigned long virtual_time;
+	size_t size;
+	PQCmpFunc cmp_func;
+	const void *cmp_param;
+};
+
+
+/*******************************************************************************
+***************************** Side-Functions **********************************/
+static int CmpEntriesImp(const void *entry1, const void *entry2, const void *param);
+static int CmpTenantsImp(const void *tenant1, const void *tenant2, const void *param);
+static void MoveTenantImp(void *tenant, size_t index, void *param);
+static unsigned long HeadFinishImp(const tenant_ty *tenant);
+static unsigned long SpanImp(unsigned long cost, unsigned long weight);
+
+/*******************************************************************************
+***************************** WFQ Create **************************************/
+wfq_ty *WFQCreate(size_t num_tenants, PQCmpFunc cmp_func_p, const void *cmp_param)
+{
+	pq_config_ty config = {PQ_ENGINE_HEAP, NULL, 0, 0, NULL, NULL, NULL, NULL};
+	wfq_ty *wfq = NULL;
+	int status = 0;
+	size_t i = 0;
+
+	assert (NULL != cmp_func_p && "WFQCreate: Function pointer is invalid");
+
+	wfq = (wfq_ty *)malloc(sizeof(wfq_ty));
+
+	if (NULL == wfq)
+	{
+		return NULL;
+	}
+
+	wfq->num_tenants = 0;
+	wfq->virtual_time = 0;
+	wfq->size = 0;
+	wfq->cmp_func = cmp_func_p;
+	wfq->cmp_param = cmp_param;
+	wfq->active = HeapCreate(CmpTenantsImp, NULL);
+	wfq->tenants = (tenant_ty *)malloc(num_tenants * sizeof(tenant_ty) + 1);
+
+	/* selection never allocates - every tenant fits in the heap */
+	status = (NULL == wfq->active || NULL == wfq->tenants ||
+				0 != HeapReserve(wfq->active, num_tenants));
+
+	for (i = 0; 0 == status && i < num_tenants; ++i)
+	{
+		tenant_ty *tenant = &wfq->tenants[i];
+
+		tenant->entries = PQueueCreateEx(CmpEntriesImp, wfq, &config);
+		tenant->weight = 1;
+		tenant->start = 0;
+		tenant->finish = 0;
+		tenant->index = 0;
+		tenant->id = i;
+		tenant->is_active = 0;
+
+		status = (NULL == tenant->entries);
+		wfq->num_tenants += !status;
+	}
+
+	if (0 != status)
+	{
+		WFQDestroy(wfq);
+		return NULL;
+	}
+
+	HeapSetMoveFunc(wfq->active, MoveTenantImp, NULL);
+
+	return wfq;
+}
+
+/*******************************************************************************
+***************************** WFQ Destroy *************************************/
+void WFQDestroy(wfq_ty *wfq)
+{
+	pqueue_ty *entries = NULL;
+	size_t i = 0;
+
+	ASSERT_NOT_NULL_IMP(wfq);
+
+	for (i = 0; i < wfq->num_tenants; ++i)
+	{
+		entries = wfq->tenants[i].entries;
+
+		while (!PQueueIsEmpty(entries))
+		{
+			free(PQueuePeek(entries));
+			PQueueDequeue(entries);
+		}
+
+		PQueueDestroy(entries);
+	}
+
+	if (NULL != wfq->active)
+	{
+		HeapDestroy(wfq->active);
+	}
+
+	free(wfq->tenants);
+
+	DEBUG_MODE
+	(
+		wfq->tenants = INVALID_PTR;
+		wfq->active = INVALID_PTR;
+	)
+	free(wfq);
+}
+
+/*******************************************************************************
+***************************** WFQ SetWeight ***********************************/
+void WFQSetWeight(wfq_ty *wfq, size_t tenant, unsigned int weight)
+{
+	ASSERT_NOT_NULL_IMP(wfq);
+	assert (tenant < wfq->num_tenants && "WFQSetWeight: tenant is out of range");
+	assert (0 < weight && "WFQSetWeight: weight must be positive");
+
+	wfq->tenants[tenant].weight = weight;
+}
+
+/*******************************************************************************
+***************************** WFQ Enqueue *************************************/
+int WFQEnqueue(wfq_ty *wfq, size_t tenant, void *data, unsigned long cost)
+{
+	tenant_ty *target = NULL;
+	entry_ty *entry = NULL;
+
+	ASSERT_NOT_NULL_IMP(wfq);
+	assert (tenant < wfq->num_tenants && "WFQEnqueue: tenant is out of range");
+
+	target = &wfq->tenants[tenant];
+	entry = (entry_ty *)malloc(sizeof(entry_ty));
+
+	if (NULL == entry)
+	{
+		return 1;
+	}
+
+	entry->data = data;
+	entry->cost = cost;
+
+	if (0 != PQueueEnqueue(target->entries, entry))
+	{
+		free(entry);
+		return 1;
+	}
+
+	++wfq->size;
+
+	/* an idle tenant joins at the virtual time - the others are untouched.
+		It went idle when its last tag became the virtual time, and the
+		virtual time only moves forward, so that tag is never ahead.	*/
+	if (!target->is_active)
+	{
+		target->start = wfq->virtual_time;
+		target->finish = HeadFinishImp(target);
+		target->is_active = 1;
+		HeapPush(wfq->active, target);
+	}
+	else if (entry == PQueuePeek(target->entries))
+	{
+		/* a new head keeps the start of the head it replaced */
+		target->finish = HeadFinishImp(target);
+		HeapUpdateAt(wfq->active, target->index);
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** WFQ Dequeue *************************************/
+void *WFQDequeue(wfq_ty *wfq, size_t *tenant_out)
+{
+	tenant_ty *served = NULL;
+	entry_ty *entry = NULL;
+	void *data = NULL;
+
+	ASSERT_NOT_NULL_IMP(wfq);
+
+	served = (tenant_ty *)HeapPeek(wfq->active);
+
+	if (NULL == served)
+	{
+		return NULL;
+	}
+
+	entry = (entry_ty *)PQueuePeek(served->entries);
+	PQueueDequeue(served->entries);
+	data = entry->data;
+	free(entry);
+	--wfq->size;
+
+	wfq->virtual_time = served->finish;
+
+	if (PQueueIsEmpty(served->entries))
+	{
+		served->is_active = 0;
+		HeapPop(wfq->active);
+	}
+	else
+	{
+		served->start = served->finish;
+		served->finish = HeadFinishImp(served);
+		HeapUpdateAt(wfq->active, served->index);
+	}
+
+	if (NULL != tenant_out)
+	{
+		*tenant_out = served->id;
+	}
+
+	return data;
+}
+
+/*******************************************************************************
+***************************** WFQ Size ****************************************/
+size_t WFQSize(const wfq_ty *wfq)
+{
+	ASSERT_NOT_NULL_IMP(wfq);
+
+	return wfq->size;
+}
+
+size_t WFQTenantSize(const wfq_ty *wfq, size_t tenant)
+{
+	ASSERT_NOT_NULL_IMP(wfq);
+	assert (tenant < wfq->num_tenants && "WFQTenantSize: tenant is out of range");
+
+	return PQueueSize(wfq->tenants[tenant].entries);
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int CmpEntriesImp(const void *entry1, const void *entry2, const void *param)
+{
+	const wfq_ty *wfq = (const wfq_ty *)param;
+
+	return wfq->cmp_func(((const entry_ty *)entry1)->data,
+						((const entry_ty *)entry2)->data, wfq->cmp_param);
+}
+
+/* by finish tag; ties by tenant id, so equal shares alternate */
+static int CmpTenantsImp(const void *tenant1, const void *tenant2, const void *param)
+{
+	const tenant_ty *t1 = (const tenant_ty *)tenant1;
+	const tenant_ty *t2 = (const tenant_ty *)tenant2;
+
+	UNUSED(param);
+
+	if (t1->finish != t2->finish)
+	{
+		return (t1->finish - t2->finish > WFQ_MAX_SPAN) ? -1 : 1;
+	}
+
+	return (t1->id > t2->id) - (t1->id < t2->id);
+}
+
+static void MoveTenantImp(void *tenant, size_t index, void *param)
+{
+	UNUSED(param);
+
+	((tenant_ty *)tenant)->index = index;
+}
+
+static unsigned long HeadFinishImp(const tenant_ty *tenant)
+{
+	const entry_ty *head = (const entry_ty *)PQueuePeek(tenant->entries);
+
+	return tenant->start + SpanImp(head->cost, tenant->weight);
+}
+
+/* cost * WFQ_VIRTUAL_UNIT / weight without overflow, capped at WFQ_MAX_SPAN */
+static unsigned long SpanImp(unsigned long cost, unsigned long weight)
+{
+	unsigned long whole = cost / weight;
+	unsigned long rest = cost % weight;
+	unsigned long fraction = 0;
+	int i = 0;
+
+	if (whole > WFQ_MAX_SPAN / WFQ_VIRTUAL_UNIT)
+	{
+		return WFQ_MAX_SPAN;
+	}
+
+	/* rest / weight in binary, one bit at a time - rest * 2 may overflow */
+	for (i = 0; i < WFQ_UNIT_BITS; ++i)
+	{
+		fraction <<= 1;
+
+		if (rest >= weight - rest)
+		{
+			rest -= weight - rest;
+			fraction |= 1;
+		}
+		else
+		{
+			rest <<= 1;
+		}
+	}
+
+	whole *= WFQ_VIRTUAL_UNIT;
+
+	return (fraction > WFQ_MAX_SPAN - whole) ? WFQ_MAX_SPAN : whole + fraction;
+}
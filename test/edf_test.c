@@ -0,0 +1,184 @@
+/*******************************************************************************
+*************************** - EDF SCHEDULER - *********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+#include <limits.h>		/* ULONG_MAX */
+
+#include "utilities.h"
+#include "edf.h"
+
+void TestEDFOrder(void);
+void TestEDFAging(void);
+void TestEDFBudget(void);
+void TestEDFCancel(void);
+void TestEDFBigTimes(void);
+
+
+static int ids[100];
+static int test_failures = 0;
+
+int main(void)
+{
+	size_t i = 0;
+
+	for (i = 0; i < 100; ++i)
+	{
+		ids[i] = (int)i;
+	}
+
+	PRINT_MSG(\n--- Tests EDF Scheduler ---\n);
+
+	TestEDFOrder();
+	TestEDFAging();
+	TestEDFBudget();
+	TestEDFCancel();
+	TestEDFBigTimes();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestEDFOrder(void)
+{
+	edf_ty *sched = EDFCreate(0);
+	unsigned long prev = 0;
+	int is_ok = 1;
+	size_t i = 0;
+
+	for (i = 0; i < 100; ++i)
+	{
+		is_ok &= (NULL != EDFSubmit(sched, &ids[i], (i * 37) % 100, 1, i));
+	}
+
+	is_ok &= (100 == EDFSize(sched));
+
+	while (NULL != EDFNext(sched))
+	{
+		is_ok &= (prev <= EDFTaskDeadline(EDFNext(sched)));
+		prev = EDFTaskDeadline(EDFNext(sched));
+		is_ok &= (NULL != EDFCharge(sched, 1));
+	}
+
+	/* equal deadlines run in submission order */
+	EDFSubmit(sched, &ids[0], 50, 1, 0);
+	EDFSubmit(sched, &ids[1], 50, 1, 0);
+	EDFSubmit(sched, &ids[2], 50, 1, 0);
+
+	is_ok &= (&ids[0] == EDFCharge(sched, 1));
+	is_ok &= (&ids[1] == EDFCharge(sched, 1));
+	is_ok &= (&ids[2] == EDFCharge(sched, 1));
+
+	EDFDestroy(sched);
+
+	PRINT_TEST_RESULT(is_ok, "Deadline order", test_failures);
+}
+
+void TestEDFAging(void)
+{
+	edf_ty *plain = EDFCreate(0);
+	edf_ty *aging = EDFCreate(100);
+	int is_ok = 1;
+
+	/* a task submitted at 0, due at 100; later ones due at 60 */
+	EDFSubmit(plain, &ids[0], 100, 1, 0);
+	EDFSubmit(plain, &ids[1], 60, 1, 30);
+	EDFSubmit(plain, &ids[2], 60, 1, 50);
+
+	EDFSubmit(aging, &ids[0], 100, 1, 0);
+	EDFSubmit(aging, &ids[1], 60, 1, 30);
+	EDFSubmit(aging, &ids[2], 60, 1, 50);
+
+	is_ok &= (&ids[1] == EDFCharge(plain, 1));
+	is_ok &= (&ids[2] == EDFCharge(plain, 1));
+	is_ok &= (&ids[0] == EDFCharge(plain, 1));
+
+	/* 100 - 30 of waiting beats 60 submitted at 30, but not at 50 */
+	is_ok &= (&ids[1] == EDFCharge(aging, 1));
+	is_ok &= (&ids[0] == EDFCharge(aging, 1));
+	is_ok &= (&ids[2] == EDFCharge(aging, 1));
+
+	EDFDestroy(plain);
+	EDFDestroy(aging);
+
+	PRINT_TEST_RESULT(is_ok, "Aging", test_failures);
+}
+
+void TestEDFBudget(void)
+{
+	edf_ty *sched = EDFCreate(0);
+	int is_ok = 1;
+
+	EDFSubmit(sched, &ids[0], 10, 5, 0);
+	EDFSubmit(sched, &ids[1], 20, 3, 0);
+
+	is_ok &= (NULL == EDFCharge(sched, 2));
+	is_ok &= (3 == EDFTaskBudget(EDFNext(sched)));
+	is_ok &= (NULL == EDFCharge(sched, 2));
+	is_ok &= (&ids[0] == EDFCharge(sched, 2));
+	is_ok &= (&ids[1] == EDFTaskData(EDFNext(sched)));
+	is_ok &= (&ids[1] == EDFCharge(sched, 3));
+	is_ok &= (0 == EDFSize(sched));
+
+	EDFDestroy(sched);
+
+	PRINT_TEST_RESULT(is_ok, "Budget", test_failures);
+}
+
+void TestEDFCancel(void)
+{
+	edf_ty *sched = EDFCreate(0);
+	edf_task_ty *tasks[10];
+	int is_ok = 1;
+	size_t i = 0;
+
+	for (i = 0; i < 10; ++i)
+	{
+		tasks[i] = EDFSubmit(sched, &ids[i], i, 1, 0);
+	}
+
+	is_ok &= (&ids[0] == EDFCancel(sched, tasks[0]));
+	is_ok &= (&ids[5] == EDFCancel(sched, tasks[5]));
+	is_ok &= (8 == EDFSize(sched));
+	is_ok &= (&ids[1] == EDFTaskData(EDFNext(sched)));
+
+	/* tasks left are freed */
+	EDFDestroy(sched);
+
+	PRINT_TEST_RESULT(is_ok, "Cancel", test_failures);
+}
+
+void TestEDFBigTimes(void)
+{
+	edf_ty *plain = EDFCreate(0);
+	edf_ty *aging = EDFCreate(100);
+	int is_ok = 1;
+
+	/* deadline * 100 does not fit in an unsigned long */
+	EDFSubmit(plain, &ids[0], ULONG_MAX, 1, 0);
+	EDFSubmit(plain, &ids[1], ULONG_MAX - 1, 1, 0);
+	EDFSubmit(plain, &ids[2], ULONG_MAX / 100 + 1, 1, 0);
+
+	is_ok &= (&ids[2] == EDFCharge(plain, 1));
+	is_ok &= (&ids[1] == EDFCharge(plain, 1));
+	is_ok &= (&ids[0] == EDFCharge(plain, 1));
+
+	/* neither does 100 * now - it would wrap around to 84 */
+	EDFSubmit(aging, &ids[0], 0, 1, ULONG_MAX / 100 + 1);
+	EDFSubmit(aging, &ids[1], 1, 1, 0);
+
+	is_ok &= (&ids[1] == EDFCharge(aging, 1));
+	is_ok &= (&ids[0] == EDFCharge(aging, 1));
+
+	EDFDestroy(plain);
+	EDFDestroy(aging);
+
+	PRINT_TEST_RESULT(is_ok, "Big deadlines and times", test_failures);
+}
@@ -0,0 +1,257 @@
+/*******************************************************************************
+***************************** - GRAPH SEARCH - ********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "graph_search.h"
+
+#define NODES 2000
+#define DEGREE 6
+#define SIDE 40			/* grid of SIDE x SIDE */
+
+void TestGraphSearchDijkstra(graph_open_set_ty open_set, const char *test_name);
+void TestGraphSearchAStar(graph_open_set_ty open_set, const char *test_name);
+void TestGraphSearchPath(void);
+
+static void BuildRandomGraph(void);
+static void BuildGrid(void);
+static void BellmanFord(graph_node_ty source, unsigned long *dist);
+static unsigned long Manhattan(graph_node_ty node, graph_node_ty target, void *param);
+
+static size_t offsets[NODES + 1];
+static graph_node_ty targets[NODES * DEGREE];
+static unsigned int weights[NODES * DEGREE];
+static csr_graph_ty graph = {0, offsets, targets, weights};
+static int test_failures = 0;
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Graph Search ---\n);
+
+	TestGraphSearchDijkstra(GRAPH_OPEN_HEAP, "Dijkstra heap");
+	TestGraphSearchDijkstra(GRAPH_OPEN_RADIX, "Dijkstra radix");
+	TestGraphSearchAStar(GRAPH_OPEN_HEAP, "A* heap");
+	TestGraphSearchAStar(GRAPH_OPEN_RADIX, "A* radix");
+	TestGraphSearchPath();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestGraphSearchDijkstra(graph_open_set_ty open_set, const char *test_name)
+{
+	static unsigned long expected[NODES];
+	graph_search_ty *search = NULL;
+	graph_node_ty source = 0;
+	graph_node_ty node = 0;
+	int is_ok = 1;
+
+	BuildRandomGraph();
+	search = GraphSearchCreate(&graph, open_set);
+
+	/* the workspace is reused by every run */
+	for (source = 0; source < NODES; source += 97)
+	{
+		BellmanFord(source, expected);
+		is_ok &= (GRAPH_INFINITY == GraphSearchRun(search, source, GRAPH_NO_NODE,
+													NULL, NULL));
+
+		for (node = 0; node < NODES; ++node)
+		{
+			is_ok &= (expected[node] == GraphSearchDistance(search, node));
+		}
+
+		/* stopping at a target gives the same distance */
+		is_ok &= (expected[NODES - 1] ==
+					GraphSearchRun(search, source, NODES - 1, NULL, NULL));
+	}
+
+	GraphSearchDestroy(search);
+
+	PRINT_TEST_RESULT(is_ok, test_name, test_failures);
+}
+
+void TestGraphSearchAStar(graph_open_set_ty open_set, const char *test_name)
+{
+	static unsigned long expected[NODES];
+	graph_search_ty *search = NULL;
+	graph_node_ty target = 0;
+	int is_ok = 1;
+
+	BuildGrid();
+	search = GraphSearchCreate(&graph, open_set);
+	BellmanFord(0, expected);
+
+	for (target = 1; target < SIDE * SIDE; target += 37)
+	{
+		is_ok &= (expected[target] ==
+					GraphSearchRun(search, 0, target, Manhattan, NULL));
+	}
+
+	GraphSearchDestroy(search);
+
+	PRINT_TEST_RESULT(is_ok, test_name, test_failures);
+}
+
+void TestGraphSearchPath(void)
+{
+	graph_search_ty *search = NULL;
+	graph_node_ty path[2 * SIDE];
+	unsigned long length = 0;
+	int is_ok = 1;
+	size_t len = 0;
+	size_t i = 0;
+	size_t e = 0;
+
+	BuildGrid();
+	search = GraphSearchCreate(&graph, GRAPH_OPEN_HEAP);
+
+	/* corner to corner; the weights along the path add up */
+	length = GraphSearchRun(search, 0, SIDE * SIDE - 1, Manhattan, NULL);
+	len = GraphSearchPath(search, SIDE * SIDE - 1, path, 2 * SIDE);
+
+	is_ok &= (2 * SIDE - 1 == len);
+	is_ok &= (0 == path[0] && SIDE * SIDE - 1 == path[len - 1]);
+	is_ok &= (GRAPH_NO_NODE == GraphSearchPredecessor(search, 0));
+
+	for (i = 1; i < len; ++i)
+	{
+		for (e = offsets[path[i - 1]]; targets[e] != path[i]; ++e)
+		{
+			/* empty */
+		}
+
+		length -= weights[e];
+	}
+
+	is_ok &= (0 == length);
+	is_ok &= (len == GraphSearchPath(search, SIDE * SIDE - 1, path, 1));
+
+	GraphSearchDestroy(search);
+
+	PRINT_TEST_RESULT(is_ok, "Path", test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+/* DEGREE pseudo random edges per node; some nodes are unreachable */
+static void BuildRandomGraph(void)
+{
+	unsigned long seed = 7;
+	size_t u = 0;
+	size_t d = 0;
+	size_t e = 0;
+
+	graph.num_nodes = NODES;
+
+	for (u = 0; u < NODES; ++u)
+	{
+		offsets[u] = e;
+
+		for (d = 0; d < DEGREE && 0 != u % 50; ++d)
+		{
+			seed = (seed * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+			targets[e] = (graph_node_ty)((seed >> 8) % NODES);
+			weights[e] = (unsigned int)(seed % 1000);
+			++e;
+		}
+	}
+
+	offsets[NODES] = e;
+}
+
+/* 4-neighbour grid, weights of at least 1 (Manhattan is consistent) */
+static void BuildGrid(void)
+{
+	size_t u = 0;
+	size_t e = 0;
+	size_t x = 0;
+	size_t y = 0;
+
+	graph.num_nodes = SIDE * SIDE;
+
+	for (u = 0; u < SIDE * SIDE; ++u)
+	{
+		x = u % SIDE;
+		y = u / SIDE;
+		offsets[u] = e;
+
+		if (0 < x)
+		{
+			targets[e] = (graph_node_ty)(u - 1);
+			weights[e++] = (unsigned int)(1 + (u * 7) % 5);
+		}
+
+		if (SIDE - 1 > x)
+		{
+			targets[e] = (graph_node_ty)(u + 1);
+			weights[e++] = (unsigned int)(1 + (u * 3) % 4);
+		}
+
+		if (0 < y)
+		{
+			targets[e] = (graph_node_ty)(u - SIDE);
+			weights[e++] = (unsigned int)(1 + (u * 11) % 3);
+		}
+
+		if (SIDE - 1 > y)
+		{
+			targets[e] = (graph_node_ty)(u + SIDE);
+			weights[e++] = 1;
+		}
+	}
+
+	offsets[SIDE * SIDE] = e;
+}
+
+static void BellmanFord(graph_node_ty source, unsigned long *dist)
+{
+	int is_changed = 1;
+	size_t u = 0;
+	size_t e = 0;
+
+	for (u = 0; u < graph.num_nodes; ++u)
+	{
+		dist[u] = GRAPH_INFINITY;
+	}
+
+	dist[source] = 0;
+
+	while (is_changed)
+	{
+		is_changed = 0;
+
+		for (u = 0; u < graph.num_nodes; ++u)
+		{
+			for (e = offsets[u]; GRAPH_INFINITY != dist[u] && e < offsets[u + 1]; ++e)
+			{
+				if (dist[u] + weights[e] < dist[targets[e]])
+				{
+					dist[targets[e]] = dist[u] + weights[e];
+					is_changed = 1;
+				}
+			}
+		}
+	}
+}
+
+static unsigned long Manhattan(graph_node_ty node, graph_node_ty target, void *param)
+{
+	unsigned long dx = (node % SIDE > target % SIDE) ?
+						node % SIDE - target % SIDE : target % SIDE - node % SIDE;
+	unsigned long dy = (node / SIDE > target / SIDE) ?
+						node / SIDE - target / SIDE : target / SIDE - node / SIDE;
+
+	UNUSED(param);
+
+	return dx + dy;
+}
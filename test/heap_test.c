@@ -0,0 +1,329 @@
+/*******************************************************************************
+********************************* - HEAP - ************************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "heap.h"
+
+#define NUM 1000
+
+void TestHeapPushPop(void);
+void TestHeapPushBatch(void);
+void TestHeapRemoveAt(void);
+void TestHeapMoveFunc(void);
+void TestHeapRemoveIf(void);
+void TestHeapSetCmpParam(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+static int CmpSigned(const void *obj1, const void *obj2, const void *sign);
+static int IsSameInt(const void *data, const void *param);
+static int IsMultipleOf(const void *data, const void *param);
+static void CountRemoved(void *data, void *param);
+static void TrackIndex(void *data, size_t index, void *param);
+static int IsValidHeap(heap_ty *heap);
+
+static int values[NUM];
+static int test_failures = 0;
+
+int main(void)
+{
+	size_t i = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		values[i] = (int)((i * 7919) % NUM);
+	}
+
+	PRINT_MSG(\n--- Tests Heap ---\n);
+
+	TestHeapPushPop();
+	TestHeapPushBatch();
+	TestHeapRemoveAt();
+	TestHeapMoveFunc();
+	TestHeapRemoveIf();
+	TestHeapSetCmpParam();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestHeapPushPop(void)
+{
+	heap_ty *heap = HeapCreate(CmpInts, NULL);
+	int is_ok = 1;
+	int i = 0;
+
+	is_ok &= HeapIsEmpty(heap);
+	is_ok &= (NULL == HeapPeek(heap));
+	is_ok &= (NULL == HeapPop(heap));
+
+	for (i = 0; i < NUM; ++i)
+	{
+		is_ok &= (0 == HeapPush(heap, &values[i]));
+	}
+
+	is_ok &= (NUM == HeapSize(heap));
+	is_ok &= IsValidHeap(heap);
+
+	for (i = 0; i < NUM; ++i)
+	{
+		is_ok &= (i == *(int *)HeapPeek(heap));
+		is_ok &= (i == *(int *)HeapPop(heap));
+	}
+
+	is_ok &= HeapIsEmpty(heap);
+
+	HeapDestroy(heap);
+
+	PRINT_TEST_RESULT(is_ok, "Push Pop", test_failures);
+}
+
+void TestHeapPushBatch(void)
+{
+	heap_ty *heap = HeapCreate(CmpInts, NULL);
+	void *items[NUM];
+	int is_ok = 1;
+	int i = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		items[i] = &values[i];
+	}
+
+	/* a big batch rebuilds, a small one sifts up */
+	is_ok &= (NUM - 10 == HeapPushBatch(heap, items, NUM - 10));
+	is_ok &= IsValidHeap(heap);
+	is_ok &= (10 == HeapPushBatch(heap, items + NUM - 10, 10));
+	is_ok &= IsValidHeap(heap);
+	is_ok &= (NUM == HeapSize(heap));
+
+	for (i = 0; i < NUM; ++i)
+	{
+		is_ok &= (i == *(int *)HeapPop(heap));
+	}
+
+	HeapClear(heap);
+	is_ok &= HeapIsEmpty(heap);
+
+	HeapDestroy(heap);
+
+	PRINT_TEST_RESULT(is_ok, "PushBatch", test_failures);
+}
+
+void TestHeapRemoveAt(void)
+{
+	heap_ty *heap = HeapCreate(CmpInts, NULL);
+	int is_ok = 1;
+	int key = 0;
+	int i = 0;
+	size_t index = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		HeapPush(heap, &values[i]);
+	}
+
+	/* remove all the odd values */
+	for (key = 1; key < NUM; key += 2)
+	{
+		index = HeapFindIf(heap, IsSameInt, &key);
+		is_ok &= (index < HeapSize(heap));
+		is_ok &= (key == *(int *)HeapRemoveAt(heap, index));
+	}
+
+	is_ok &= (NUM / 2 == HeapSize(heap));
+	is_ok &= IsValidHeap(heap);
+
+	key = 1;
+	is_ok &= (HeapSize(heap) == HeapFindIf(heap, IsSameInt, &key));
+
+	for (i = 0; i < NUM; i += 2)
+	{
+		is_ok &= (i == *(int *)HeapPop(heap));
+	}
+
+	HeapDestroy(heap);
+
+	PRINT_TEST_RESULT(is_ok, "FindIf RemoveAt", test_failures);
+}
+
+void TestHeapMoveFunc(void)
+{
+	heap_ty *heap = HeapCreate(CmpInts, NULL);
+	size_t indexes[NUM];
+	int keys[NUM];
+	int is_ok = 1;
+	int i = 0;
+
+	HeapSetMoveFunc(heap, TrackIndex, indexes);
+
+	for (i = 0; i < NUM; ++i)
+	{
+		keys[i] = values[i];
+		HeapPush(heap, &keys[i]);
+	}
+
+	/* change keys through the reported indexes */
+	for (i = 0; i < NUM; i += 3)
+	{
+		keys[i] = -keys[i] - 1;
+		HeapUpdateAt(heap, indexes[values[i]]);
+	}
+
+	is_ok &= IsValidHeap(heap);
+
+	for (i = 0; i < NUM && is_ok; ++i)
+	{
+		int *top = (int *)HeapPeek(heap);
+		int value = (*top < 0) ? -*top - 1 : *top;
+
+		is_ok &= (0 == indexes[value]);
+		HeapPop(heap);
+	}
+
+	HeapDestroy(heap);
+
+	PRINT_TEST_RESULT(is_ok, "MoveFunc UpdateAt", test_failures);
+}
+
+void TestHeapRemoveIf(void)
+{
+	heap_ty *heap = HeapCreate(CmpInts, NULL);
+	size_t indexes[NUM];
+	size_t removed = 0;
+	int divisor = 3;
+	int is_ok = 1;
+	int i = 0;
+
+	HeapSetMoveFunc(heap, TrackIndex, indexes);
+
+	for (i = 0; i < NUM; ++i)
+	{
+		HeapPush(heap, &values[i]);
+	}
+
+	is_ok &= (NUM / 3 + 1 == HeapRemoveIf(heap, IsMultipleOf, &divisor, 
+										  CountRemoved, &removed));
+	is_ok &= (NUM / 3 + 1 == removed);
+	is_ok &= (NUM - NUM / 3 - 1 == HeapSize(heap));
+	is_ok &= IsValidHeap(heap);
+
+	/* the elements left were reported at their new indexes */
+	for (i = 0; i < NUM && is_ok; ++i)
+	{
+		if (0 != values[i] % 3)
+		{
+			is_ok &= (&values[i] == HeapGet(heap, indexes[values[i]]));
+		}
+	}
+
+	is_ok &= (0 == HeapRemoveIf(heap, IsMultipleOf, &divisor, NULL, NULL));
+
+	for (i = 1; i < NUM && is_ok; ++i)
+	{
+		is_ok &= (0 == i % 3 || i == *(int *)HeapPop(heap));
+	}
+
+	HeapDestroy(heap);
+
+	PRINT_TEST_RESULT(is_ok, "RemoveIf", test_failures);
+}
+
+void TestHeapSetCmpParam(void)
+{
+	int ascending = 1;
+	int descending = -1;
+	heap_ty *heap = HeapCreate(CmpSigned, &ascending);
+	size_t indexes[NUM];
+	int is_ok = 1;
+	int i = 0;
+
+	HeapSetMoveFunc(heap, TrackIndex, indexes);
+
+	for (i = 0; i < NUM; ++i)
+	{
+		HeapPush(heap, &values[i]);
+	}
+
+	HeapSetCmpParam(heap, &descending);
+
+	is_ok &= (NUM == HeapSize(heap));
+
+	/* every element was reported at its new index */
+	for (i = 0; i < NUM; ++i)
+	{
+		is_ok &= (&values[i] == HeapGet(heap, indexes[values[i]]));
+	}
+
+	for (i = NUM - 1; 0 <= i && is_ok; --i)
+	{
+		is_ok &= (i == *(int *)HeapPop(heap));
+	}
+
+	HeapDestroy(heap);
+
+	PRINT_TEST_RESULT(is_ok, "SetCmpParam", test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+
+	return *(const int *)obj1 - *(const int *)obj2;
+}
+
+static int CmpSigned(const void *obj1, const void *obj2, const void *sign)
+{
+	return *(const int *)sign * (*(const int *)obj1 - *(const int *)obj2);
+}
+
+static int IsSameInt(const void *data, const void *param)
+{
+	return *(const int *)data == *(const int *)param;
+}
+
+static int IsMultipleOf(const void *data, const void *param)
+{
+	return 0 == *(const int *)data % *(const int *)param;
+}
+
+static void CountRemoved(void *data, void *param)
+{
+	UNUSED(data);
+
+	++*(size_t *)param;
+}
+
+/* the index of the element of value v is kept in indexes[v] */
+static void TrackIndex(void *data, size_t index, void *param)
+{
+	int value = *(int *)data;
+
+	((size_t *)param)[(value < 0) ? -value - 1 : value] = index;
+}
+
+static int IsValidHeap(heap_ty *heap)
+{
+	size_t i = 0;
+
+	for (i = 1; i < HeapSize(heap); ++i)
+	{
+		if (0 > CmpInts(HeapGet(heap, i), HeapGet(heap, (i - 1) / 2), NULL))
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
@@ -0,0 +1,133 @@
+/*******************************************************************************
+****************************** - LOSER TREE - *********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "loser_tree.h"
+
+#define SOURCES 5
+#define LEN 40
+
+void TestLoserTreeMerge(void);
+void TestLoserTreeEmpty(void);
+void TestLoserTreeTies(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+
+static int test_failures = 0;
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Loser Tree ---\n);
+
+	TestLoserTreeMerge();
+	TestLoserTreeEmpty();
+	TestLoserTreeTies();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestLoserTreeMerge(void)
+{
+	loser_tree_ty *tree = LoserTreeCreate(SOURCES, CmpInts, NULL);
+	int runs[SOURCES][LEN];
+	size_t pos[SOURCES] = {0};
+	size_t s = 0;
+	int is_ok = 1;
+	int i = 0;
+
+	/* source s holds s, s + SOURCES, s + 2 * SOURCES ... */
+	for (s = 0; s < SOURCES; ++s)
+	{
+		for (i = 0; i < LEN; ++i)
+		{
+			runs[s][i] = (int)s + i * SOURCES;
+		}
+
+		LoserTreeSet(tree, s, &runs[s][0]);
+	}
+
+	LoserTreeBuild(tree);
+	is_ok &= (SOURCES == LoserTreeNumSources(tree));
+
+	for (i = 0; i < SOURCES * LEN; ++i)
+	{
+		s = LoserTreeWinner(tree);
+		is_ok &= (i == *(int *)LoserTreeTop(tree));
+		is_ok &= ((size_t)i % SOURCES == s);
+
+		++pos[s];
+		LoserTreeReplay(tree, (LEN == pos[s]) ? NULL : &runs[s][pos[s]]);
+	}
+
+	is_ok &= (NULL == LoserTreeTop(tree));
+
+	LoserTreeDestroy(tree);
+
+	PRINT_TEST_RESULT(is_ok, "Merge", test_failures);
+}
+
+void TestLoserTreeEmpty(void)
+{
+	loser_tree_ty *tree = LoserTreeCreate(1, CmpInts, NULL);
+	int value = 7;
+	int is_ok = 1;
+
+	is_ok &= (NULL == LoserTreeTop(tree));
+
+	LoserTreeSet(tree, 0, &value);
+	LoserTreeBuild(tree);
+	is_ok &= (&value == LoserTreeTop(tree));
+	is_ok &= (0 == LoserTreeWinner(tree));
+
+	LoserTreeReplay(tree, NULL);
+	is_ok &= (NULL == LoserTreeTop(tree));
+
+	LoserTreeDestroy(tree);
+
+	PRINT_TEST_RESULT(is_ok, "Single Empty", test_failures);
+}
+
+void TestLoserTreeTies(void)
+{
+	loser_tree_ty *tree = LoserTreeCreate(3, CmpInts, NULL);
+	int values[3] = {4, 4, 4};
+	int is_ok = 1;
+
+	LoserTreeSet(tree, 2, &values[2]);
+	LoserTreeSet(tree, 1, &values[1]);
+	LoserTreeSet(tree, 0, &values[0]);
+	LoserTreeBuild(tree);
+
+	/* equal keys come out by source */
+	is_ok &= (0 == LoserTreeWinner(tree));
+	LoserTreeReplay(tree, NULL);
+	is_ok &= (1 == LoserTreeWinner(tree));
+	LoserTreeReplay(tree, NULL);
+	is_ok &= (2 == LoserTreeWinner(tree));
+	LoserTreeReplay(tree, NULL);
+	is_ok &= (NULL == LoserTreeTop(tree));
+
+	LoserTreeDestroy(tree);
+
+	PRINT_TEST_RESULT(is_ok, "Ties", test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+
+	return *(const int *)obj1 - *(const int *)obj2;
+}
@@ -0,0 +1,352 @@
+/*******************************************************************************
+************************ - EXTERNAL MEMORY PRIORITY QUEUE - ********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L		/* mkdtemp */
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* malloc, free, mkdtemp */
+#include <stddef.h>		/* size_t */
+#include <string.h>		/* memcpy */
+#include <unistd.h>		/* rmdir */
+
+#include "utilities.h"
+#include "pqueue.h"
+
+#define MEMORY 8
+
+void TestPQExternalSpill(void);
+void TestPQExternalInterleaved(void);
+void TestPQExternalErase(void);
+void TestPQExternalDirectory(void);
+void TestPQExternalMergeLevels(void);
+void TestPQExternalReadFailure(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+static int IsSameInt(const void *element_data, const void *param);
+static size_t SerializeInt(const void *data, void *buffer, size_t size, void *param);
+static void *DeserializeInt(const void *buffer, size_t size, void *param);
+static void ReleaseInt(void *data, void *param);
+static int *NewInt(int value);
+static void FreeInt(void *data);
+static pqueue_ty *CreateQueue(const char *dir);
+
+/* elements alive in memory, and the most seen at once */
+static size_t live = 0;
+static size_t max_live = 0;
+
+/* records written into runs */
+static size_t writes = 0;
+
+/* records fail to be read back while set */
+static int is_read_failing = 0;
+static int test_failures = 0;
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests External Memory Priority Queue ---\n);
+
+	TestPQExternalSpill();
+	TestPQExternalInterleaved();
+	TestPQExternalErase();
+	TestPQExternalDirectory();
+	TestPQExternalMergeLevels();
+	TestPQExternalReadFailure();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQExternalSpill(void)
+{
+	pqueue_ty *pqueue = CreateQueue(NULL);
+	int prev = -1;
+	int is_ok = 1;
+	int i = 0;
+
+	max_live = live;
+
+	/* 2000 / MEMORY runs - merged into runs of level 1 */
+	for (i = 0; i < 2000; ++i)
+	{
+		is_ok &= (0 == PQueueEnqueue(pqueue, NewInt((i * 7919) % 2000)));
+	}
+
+	is_ok &= (2000 == PQueueSize(pqueue));
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		is_ok &= (prev + 1 == *(int *)PQueuePeek(pqueue));
+		prev = *(int *)PQueuePeek(pqueue);
+		FreeInt(PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+	}
+
+	/* the heap, the element being added and the heads of at most 16 runs
+		on each of the 2 levels - twice for the 16 being merged, plus the
+		head of the merged run */
+	is_ok &= (1999 == prev && MEMORY + 1 + 2 * 16 + 16 + 1 >= max_live);
+
+	PRINT_TEST_RESULT(is_ok, "Test Spill and merge in bounded memory", test_failures);
+
+	PQueueDestroy(pqueue);
+}
+
+void TestPQExternalInterleaved(void)
+{
+	pqueue_ty *pqueue = CreateQueue(NULL);
+	int is_ok = 1;
+	int i = 0;
+
+	for (i = 100; i > 50; --i)
+	{
+		PQueueEnqueue(pqueue, NewInt(i));
+	}
+
+	/* smaller than everything on disk */
+	for (i = 0; i < 10; ++i)
+	{
+		PQueueEnqueue(pqueue, NewInt(i));
+		is_ok &= (i == *(int *)PQueuePeek(pqueue));
+		FreeInt(PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+		is_ok &= (51 == *(int *)PQueuePeek(pqueue));
+	}
+
+	is_ok &= (50 == PQueueSize(pqueue));
+
+	/* what is left is released, in memory and on disk */
+	PQueueClear(pqueue);
+	is_ok &= (PQueueIsEmpty(pqueue) && 0 == live);
+
+	PQueueEnqueue(pqueue, NewInt(7));
+	is_ok &= (7 == *(int *)PQueuePeek(pqueue));
+
+	PQueueDestroy(pqueue);
+	is_ok &= (0 == live);
+
+	PRINT_TEST_RESULT(is_ok, "Test Interleaved, Clear and Destroy", test_failures);
+}
+
+void TestPQExternalErase(void)
+{
+	pqueue_ty *pqueue = CreateQueue(NULL);
+	int *erased = NULL;
+	int in_memory = 25;
+	int run_head = 0;
+	int on_disk = 3;
+	int is_ok = 1;
+	int i = 0;
+
+	for (i = 0; i < 30; ++i)
+	{
+		PQueueEnqueue(pqueue, NewInt(i));
+	}
+
+	erased = (int *)PQueueErase(pqueue, IsSameInt, &in_memory);
+	is_ok &= (NULL != erased && 25 == *erased);
+	FreeInt(erased);
+
+	erased = (int *)PQueueErase(pqueue, IsSameInt, &run_head);
+	is_ok &= (NULL != erased && 0 == *erased);
+	FreeInt(erased);
+
+	/* a record in a file is not searched */
+	is_ok &= (NULL == PQueueErase(pqueue, IsSameInt, &on_disk));
+	is_ok &= (28 == PQueueSize(pqueue));
+	is_ok &= (1 == *(int *)PQueuePeek(pqueue));
+
+	PQueueDestroy(pqueue);
+	is_ok &= (0 == live);
+
+	PRINT_TEST_RESULT(is_ok, "Test Erase", test_failures);
+}
+
+void TestPQExternalDirectory(void)
+{
+	char dir[] = "/tmp/pq_external_testXXXXXX";
+	pqueue_ty *pqueue = NULL;
+	int is_ok = (NULL != mkdtemp(dir));
+	int i = 0;
+
+	pqueue = CreateQueue(dir);
+
+	for (i = 0; i < 100; ++i)
+	{
+		is_ok &= (0 == PQueueEnqueue(pqueue, NewInt(100 - i)));
+	}
+
+	is_ok &= (1 == *(int *)PQueuePeek(pqueue));
+	PQueueDestroy(pqueue);
+
+	/* the runs are unlinked as soon as they are created */
+	is_ok &= (0 == rmdir(dir));
+
+	PRINT_TEST_RESULT(is_ok, "Test Runs directory", test_failures);
+}
+
+void TestPQExternalMergeLevels(void)
+{
+	pqueue_ty *pqueue = CreateQueue(NULL);
+	int prev = -1;
+	int is_ok = 1;
+	int i = 0;
+
+	writes = 0;
+
+	/* 512 runs: two levels of merges above the spilled runs */
+	for (i = 0; i < 4096; ++i)
+	{
+		is_ok &= (0 == PQueueEnqueue(pqueue, NewInt((i * 7919) % 4096)));
+	}
+
+	/* every record is written once per level, not once per merge */
+	is_ok &= (4096 * 3 >= writes);
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		is_ok &= (prev + 1 == *(int *)PQueuePeek(pqueue));
+		prev = *(int *)PQueuePeek(pqueue);
+		FreeInt(PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+	}
+
+	is_ok &= (4095 == prev);
+
+	PRINT_TEST_RESULT(is_ok, "Test Merge by levels", test_failures);
+
+	PQueueDestroy(pqueue);
+}
+
+void TestPQExternalReadFailure(void)
+{
+	pqueue_ty *pqueue = CreateQueue(NULL);
+	int sum = 0;
+	int is_ok = 1;
+	int i = 0;
+
+	/* runs of 0..7 and 8..15, 16..23 in memory */
+	for (i = 0; i < 24; ++i)
+	{
+		PQueueEnqueue(pqueue, NewInt(i));
+	}
+
+	is_ok &= (0 == PQueueError(pqueue));
+
+	/* the runs cannot be read past their heads - they are kept aside */
+	is_read_failing = 1;
+	FreeInt(PQueuePeek(pqueue));
+	PQueueDequeue(pqueue);
+	is_ok &= (1 == PQueueError(pqueue) && 23 == PQueueSize(pqueue));
+	is_ok &= (8 == *(int *)PQueuePeek(pqueue));
+	FreeInt(PQueuePeek(pqueue));
+	PQueueDequeue(pqueue);
+	is_ok &= (16 == *(int *)PQueuePeek(pqueue) && 22 == PQueueSize(pqueue));
+
+	/* they come back on the next Dequeue */
+	is_read_failing = 0;
+	FreeInt(PQueuePeek(pqueue));
+	PQueueDequeue(pqueue);
+	is_ok &= (1 == *(int *)PQueuePeek(pqueue) && 21 == PQueueSize(pqueue));
+
+	/* nothing was lost: 1..7, 9..15 and 17..23 */
+	while (!PQueueIsEmpty(pqueue))
+	{
+		sum += *(int *)PQueuePeek(pqueue);
+		FreeInt(PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+	}
+
+	is_ok &= (23 * 24 / 2 - 24 == sum && 1 == PQueueError(pqueue));
+
+	PQueueClear(pqueue);
+	is_ok &= (0 == PQueueError(pqueue));
+
+	PQueueDestroy(pqueue);
+	is_ok &= (0 == live);
+
+	PRINT_TEST_RESULT(is_ok, "Test Read failure is kept and reported", test_failures);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+	return (*(int *)obj1 - *(int *)obj2);
+}
+
+static int IsSameInt(const void *element_data, const void *param)
+{
+	return (*(int *)element_data == *(int *)param);
+}
+
+static size_t SerializeInt(const void *data, void *buffer, size_t size, void *param)
+{
+	UNUSED(param);
+
+	if (sizeof(int) <= size)
+	{
+		memcpy(buffer, data, sizeof(int));
+		++writes;
+	}
+
+	return sizeof(int);
+}
+
+static void *DeserializeInt(const void *buffer, size_t size, void *param)
+{
+	int value = 0;
+
+	UNUSED(param);
+
+	if (sizeof(int) != size || is_read_failing)
+	{
+		return NULL;
+	}
+
+	memcpy(&value, buffer, sizeof(int));
+
+	return NewInt(value);
+}
+
+static void ReleaseInt(void *data, void *param)
+{
+	UNUSED(param);
+	FreeInt(data);
+}
+
+static int *NewInt(int value)
+{
+	int *data = (int *)malloc(sizeof(int));
+
+	*data = value;
+	++live;
+	max_live = (live > max_live) ? live : max_live;
+
+	return data;
+}
+
+static void FreeInt(void *data)
+{
+	--live;
+	free(data);
+}
+
+static pqueue_ty *CreateQueue(const char *dir)
+{
+	pq_config_ty config = {PQ_ENGINE_EXTERNAL, NULL, 0, MEMORY, NULL, NULL, NULL, NULL};
+
+	config.path = dir;
+	config.serialize_func_p = SerializeInt;
+	config.deserialize_func_p = DeserializeInt;
+	config.release_func_p = ReleaseInt;
+
+	return PQueueCreateEx(CmpInts, NULL, &config);
+}
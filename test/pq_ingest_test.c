@@ -0,0 +1,192 @@
+/*******************************************************************************
+**************************** - PQ INGEST BUFFER - ******************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+#include <pthread.h>	/* pthread_create, pthread_join */
+
+#include "utilities.h"
+#include "pq_ingest.h"
+
+#define NUM_PRODUCERS 4
+#define PER_PRODUCER 10000
+
+typedef struct producer_args
+{
+	pq_ingest_ty *ingest;
+	int *values;
+	int *done_counter;
+} producer_args_ty;
+
+void TestPQIngestPushDrain(void);
+void TestPQIngestFull(void);
+void TestPQIngestProducers(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+static void *ProducerRoutine(void *args);
+
+static int test_failures = 0;
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests PQ Ingest Buffer ---\n);
+
+	TestPQIngestPushDrain();
+	TestPQIngestFull();
+	TestPQIngestProducers();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQIngestPushDrain(void)
+{
+	int nums[] = {40, 7, 19, 3, 88, 7};
+	int expected[] = {3, 7, 7, 19, 40, 88};
+	pqueue_ty *pqueue = PQueueCreate(CmpInts, NULL);
+	pq_ingest_ty *ingest = PQIngestCreate(pqueue, 8);
+	size_t i = 0;
+	int is_ok = 1;
+
+	for (i = 0; i < SIZEOF_ARRAY(nums); ++i)
+	{
+		is_ok &= (0 == PQIngestPush(ingest, &nums[i]));
+	}
+
+	/* producers never touch the sorted structure */
+	is_ok &= PQueueIsEmpty(pqueue);
+
+	for (i = 0; i < SIZEOF_ARRAY(expected); ++i)
+	{
+		is_ok &= (expected[i] == *(int *)PQIngestPeek(ingest));
+		PQIngestDequeue(ingest);
+	}
+
+	is_ok &= PQIngestIsEmpty(ingest);
+	is_ok &= (NULL == PQIngestPeek(ingest));
+
+	PRINT_TEST_RESULT(is_ok, "Test Push and Drain", test_failures);
+
+	PQIngestDestroy(ingest);
+	PQueueDestroy(pqueue);
+}
+
+void TestPQIngestFull(void)
+{
+	int nums[] = {1, 2, 3, 4, 5};
+	pqueue_ty *pqueue = PQueueCreate(CmpInts, NULL);
+	pq_ingest_ty *ingest = PQIngestCreate(pqueue, 4);
+	int is_ok = 1;
+
+	is_ok &= (0 == PQIngestPush(ingest, &nums[0]));
+	is_ok &= (0 == PQIngestPush(ingest, &nums[1]));
+	is_ok &= (0 == PQIngestPush(ingest, &nums[2]));
+	is_ok &= (0 == PQIngestPush(ingest, &nums[3]));
+	is_ok &= (0 != PQIngestPush(ingest, &nums[4]));
+
+	/* a drain frees the ring for the next lap */
+	is_ok &= (0 == PQIngestDrain(ingest));
+	is_ok &= (0 == PQIngestPush(ingest, &nums[4]));
+	is_ok &= (0 == PQIngestDrain(ingest));
+	is_ok &= (5 == PQueueSize(pqueue));
+
+	PRINT_TEST_RESULT(is_ok, "Test Full ring", test_failures);
+
+	PQIngestDestroy(ingest);
+	PQueueDestroy(pqueue);
+}
+
+void TestPQIngestProducers(void)
+{
+	static int values[NUM_PRODUCERS][PER_PRODUCER];
+	producer_args_ty args[NUM_PRODUCERS];
+	pthread_t threads[NUM_PRODUCERS];
+	pqueue_ty *pqueue = PQueueCreate(CmpInts, NULL);
+	pq_ingest_ty *ingest = PQIngestCreate(pqueue, 256);
+	size_t total = NUM_PRODUCERS * PER_PRODUCER;
+	size_t received = 0;
+	int done_counter = 0;
+	int prev = -1;
+	int curr = 0;
+	int is_ok = 1;
+	int i = 0;
+	int j = 0;
+
+	for (i = 0; i < NUM_PRODUCERS; ++i)
+	{
+		for (j = 0; j < PER_PRODUCER; ++j)
+		{
+			values[i][j] = j * NUM_PRODUCERS + i;
+		}
+
+		args[i].ingest = ingest;
+		args[i].values = values[i];
+		args[i].done_counter = &done_counter;
+		pthread_create(&threads[i], NULL, ProducerRoutine, &args[i]);
+	}
+
+	/* consume while producing; order is checked once the producers are done */
+	while (NUM_PRODUCERS != __atomic_load_n(&done_counter, __ATOMIC_ACQUIRE))
+	{
+		if (!PQIngestIsEmpty(ingest))
+		{
+			PQIngestDequeue(ingest);
+			++received;
+		}
+	}
+
+	for (i = 0; i < NUM_PRODUCERS; ++i)
+	{
+		pthread_join(threads[i], NULL);
+	}
+
+	/* whatever is left must come out in priority order */
+	while (!PQIngestIsEmpty(ingest))
+	{
+		curr = *(int *)PQIngestPeek(ingest);
+		is_ok &= (prev <= curr);
+		prev = curr;
+		PQIngestDequeue(ingest);
+		++received;
+	}
+
+	is_ok &= (total == received);
+
+	PRINT_TEST_RESULT(is_ok, "Test Concurrent producers", test_failures);
+
+	PQIngestDestroy(ingest);
+	PQueueDestroy(pqueue);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+	return (*(int *)obj1 - *(int *)obj2);
+}
+
+static void *ProducerRoutine(void *args)
+{
+	producer_args_ty *producer = (producer_args_ty *)args;
+	int i = 0;
+
+	for (i = 0; i < PER_PRODUCER; ++i)
+	{
+		/* the ring is bounded; retry until the consumer makes room */
+		while (0 != PQIngestPush(producer->ingest, &producer->values[i]))
+		{
+		}
+	}
+
+	__atomic_add_fetch(producer->done_counter, 1, __ATOMIC_RELEASE);
+
+	return NULL;
+}
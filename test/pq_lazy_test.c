@@ -0,0 +1,177 @@
+/*******************************************************************************
+************************ - LAZY DELETION PRIORITY QUEUE - **********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "pq_lazy.h"
+
+#define NUM 10000
+
+void TestPQLazyCancel(pq_engine_ty engine, const char *test_name);
+void TestPQLazyCompaction(void);
+void TestPQLazyDestroy(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+static void CountRelease(void *data, void *param);
+
+static int values[NUM];
+static int test_failures = 0;
+
+int main(void)
+{
+	size_t i = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		values[i] = (int)((i * 7919) % NUM);
+	}
+
+	PRINT_MSG(\n--- Tests Lazy Deletion Priority Queue ---\n);
+
+	TestPQLazyCancel(PQ_ENGINE_HEAP, "Cancel heap");
+	TestPQLazyCancel(PQ_ENGINE_LIST, "Cancel list");
+	TestPQLazyCancel(PQ_ENGINE_SEQHEAP, "Cancel sequence heap");
+	TestPQLazyCompaction();
+	TestPQLazyDestroy();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQLazyCancel(pq_engine_ty engine, const char *test_name)
+{
+	pq_config_ty config = {PQ_ENGINE_LIST, NULL, 0, 0, NULL, NULL, NULL, NULL};
+	pq_lazy_ty *lazy = NULL;
+	pq_lazy_handle_ty *handles[NUM];
+	size_t num = (PQ_ENGINE_LIST == engine) ? NUM / 10 : NUM;
+	size_t released = 0;
+	int prev = -1;
+	int *data = NULL;
+	int is_ok = 1;
+	size_t i = 0;
+
+	config.engine = engine;
+	lazy = PQLazyCreate(CmpInts, NULL, &config, 50, CountRelease, &released);
+
+	for (i = 0; i < num; ++i)
+	{
+		handles[i] = PQLazyEnqueue(lazy, &values[i]);
+		is_ok &= (NULL != handles[i]);
+	}
+
+	/* cancel the half - not more, so no compaction yet */
+	for (i = 1; i < num; i += 2)
+	{
+		PQLazyCancel(lazy, handles[i]);
+	}
+
+	is_ok &= (num / 2 == PQLazySize(lazy) && 0 == released);
+
+	while (!PQLazyIsEmpty(lazy))
+	{
+		data = (int *)PQLazyDequeue(lazy);
+		is_ok &= (prev < *data && 0 == (data - values) % 2);
+		prev = *data;
+	}
+
+	/* the dead ones behind the last alive are dropped by Peek */
+	is_ok &= (NULL == PQLazyPeek(lazy) && NULL == PQLazyDequeue(lazy));
+	is_ok &= (num / 2 == released);
+
+	PQLazyDestroy(lazy);
+
+	PRINT_TEST_RESULT(is_ok, test_name, test_failures);
+}
+
+void TestPQLazyCompaction(void)
+{
+	pq_config_ty config = {PQ_ENGINE_HEAP, NULL, 0, 0, NULL, NULL, NULL, NULL};
+	pq_lazy_ty *lazy = NULL;
+	pq_lazy_handle_ty *handles[NUM];
+	size_t released = 0;
+	int prev = -1;
+	int *data = NULL;
+	int is_ok = 1;
+	size_t i = 0;
+
+	lazy = PQLazyCreate(CmpInts, NULL, &config, 25, CountRelease, &released);
+
+	for (i = 0; i < NUM; ++i)
+	{
+		handles[i] = PQLazyEnqueue(lazy, &values[i]);
+	}
+
+	/* a quarter of dead and one more - all dropped at once */
+	for (i = 0; i <= NUM / 4; ++i)
+	{
+		PQLazyCancel(lazy, handles[i]);
+	}
+
+	is_ok &= (NUM / 4 + 1 == released);
+	is_ok &= (NUM - NUM / 4 - 1 == PQLazySize(lazy));
+
+	/* the handles of the alive are still valid */
+	PQLazyCancel(lazy, handles[NUM - 1]);
+
+	while (!PQLazyIsEmpty(lazy))
+	{
+		data = (int *)PQLazyDequeue(lazy);
+		is_ok &= (prev < *data);
+		prev = *data;
+	}
+
+	is_ok &= (NUM / 4 + 2 == released);
+
+	PQLazyDestroy(lazy);
+
+	PRINT_TEST_RESULT(is_ok, "Compaction", test_failures);
+}
+
+void TestPQLazyDestroy(void)
+{
+	pq_lazy_ty *lazy = NULL;
+	pq_lazy_handle_ty *handle = NULL;
+	size_t released = 0;
+	int is_ok = 1;
+
+	lazy = PQLazyCreate(CmpInts, NULL, NULL, 100, CountRelease, &released);
+
+	PQLazyEnqueue(lazy, &values[0]);
+	handle = PQLazyEnqueue(lazy, &values[1]);
+	PQLazyEnqueue(lazy, &values[2]);
+	PQLazyCancel(lazy, handle);
+
+	is_ok &= (2 == PQLazySize(lazy) && 0 == released);
+
+	/* the dead and the alive are released */
+	PQLazyDestroy(lazy);
+
+	is_ok &= (3 == released);
+
+	PRINT_TEST_RESULT(is_ok, "Destroy", test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+
+	return *(const int *)obj1 - *(const int *)obj2;
+}
+
+static void CountRelease(void *data, void *param)
+{
+	UNUSED(data);
+
+	++*(size_t *)param;
+}
@@ -0,0 +1,216 @@
+/*******************************************************************************
+************************** - K-WAY MERGE OF STREAMS - **************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "pq_merge.h"
+
+#define STREAMS 300
+#define LEN 200
+
+/* a sorted array read in pulls */
+typedef struct array_stream
+{
+	int *values;
+	size_t len;
+	size_t pos;
+	size_t pulls;
+} array_stream_ty;
+
+typedef struct output
+{
+	int *prev;
+	size_t count;
+	size_t stop_at;
+	int is_sorted;
+} output_ty;
+
+void TestPQMergeStreams(void);
+void TestPQMergeStable(void);
+void TestPQMergeStop(void);
+void TestPQMergeEmpty(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+static size_t PullArray(void **buffer, size_t capacity, void *stream_param);
+static int EmitCheck(void *data, void *emit_param);
+static void InitStreams(int is_equal);
+
+static int values[STREAMS][LEN];
+static array_stream_ty arrays[STREAMS];
+static pq_stream_ty streams[STREAMS];
+static int test_failures = 0;
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests K-Way Merge ---\n);
+
+	TestPQMergeStreams();
+	TestPQMergeStable();
+	TestPQMergeStop();
+	TestPQMergeEmpty();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQMergeStreams(void)
+{
+	output_ty output = {NULL, 0, 0, 1};
+	size_t pulls = 0;
+	size_t s = 0;
+	int is_ok = 1;
+
+	InitStreams(0);
+
+	is_ok &= (0 == PQMergeStreams(streams, STREAMS, CmpInts, NULL,
+									EmitCheck, &output));
+	is_ok &= output.is_sorted;
+	is_ok &= (STREAMS * LEN == output.count);
+
+	/* records come in batches, not one by one */
+	for (s = 0; s < STREAMS; ++s)
+	{
+		pulls += arrays[s].pulls;
+	}
+
+	is_ok &= (pulls < STREAMS * LEN / 8);
+
+	PRINT_TEST_RESULT(is_ok, "Merge", test_failures);
+}
+
+void TestPQMergeStable(void)
+{
+	output_ty output = {NULL, 0, 0, 1};
+	int is_ok = 1;
+
+	/* equal keys: the addresses tell the stream, which must not go down */
+	InitStreams(1);
+
+	is_ok &= (0 == PQMergeStreams(streams, STREAMS, CmpInts, NULL,
+									EmitCheck, &output));
+	is_ok &= output.is_sorted;
+	is_ok &= (STREAMS * LEN == output.count);
+
+	PRINT_TEST_RESULT(is_ok, "Stable", test_failures);
+}
+
+void TestPQMergeStop(void)
+{
+	output_ty output = {NULL, 0, 1000, 1};
+	int is_ok = 1;
+
+	InitStreams(0);
+
+	is_ok &= (2 == PQMergeStreams(streams, STREAMS, CmpInts, NULL,
+									EmitCheck, &output));
+	is_ok &= (1000 == output.count);
+
+	/* the last record of the first batch stops it - nothing more is pulled */
+	InitStreams(0);
+	output.prev = NULL;
+	output.count = 0;
+	output.stop_at = 64;
+
+	is_ok &= (2 == PQMergeStreams(streams, 1, CmpInts, NULL,
+									EmitCheck, &output));
+	is_ok &= (64 == output.count && 1 == arrays[0].pulls);
+
+	PRINT_TEST_RESULT(is_ok, "Emit stops", test_failures);
+}
+
+void TestPQMergeEmpty(void)
+{
+	output_ty output = {NULL, 0, 0, 1};
+	int is_ok = 1;
+	size_t s = 0;
+
+	is_ok &= (0 == PQMergeStreams(NULL, 0, CmpInts, NULL, EmitCheck, &output));
+	is_ok &= (0 == output.count);
+
+	/* only some streams have records */
+	InitStreams(0);
+
+	for (s = 0; s < STREAMS; s += 2)
+	{
+		arrays[s].len = 0;
+	}
+
+	is_ok &= (0 == PQMergeStreams(streams, STREAMS, CmpInts, NULL,
+									EmitCheck, &output));
+	is_ok &= output.is_sorted;
+	is_ok &= (STREAMS / 2 * LEN == output.count);
+
+	PRINT_TEST_RESULT(is_ok, "Empty streams", test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+
+	return *(const int *)obj1 - *(const int *)obj2;
+}
+
+static size_t PullArray(void **buffer, size_t capacity, void *stream_param)
+{
+	array_stream_ty *stream = (array_stream_ty *)stream_param;
+	size_t n = 0;
+
+	++stream->pulls;
+
+	while (n < capacity && stream->pos < stream->len)
+	{
+		buffer[n++] = &stream->values[stream->pos++];
+	}
+
+	return n;
+}
+
+/* equal records must keep the order of their addresses (stream, position) */
+static int EmitCheck(void *data, void *emit_param)
+{
+	output_ty *output = (output_ty *)emit_param;
+	int *record = (int *)data;
+
+	if (NULL != output->prev && (*output->prev > *record ||
+		(*output->prev == *record && output->prev > record)))
+	{
+		output->is_sorted = 0;
+	}
+
+	output->prev = record;
+	++output->count;
+
+	return (output->count == output->stop_at) ? 2 : 0;
+}
+
+static void InitStreams(int is_equal)
+{
+	size_t s = 0;
+	size_t i = 0;
+
+	for (s = 0; s < STREAMS; ++s)
+	{
+		for (i = 0; i < LEN; ++i)
+		{
+			values[s][i] = is_equal ? 7 : (int)(i * 31 + (s * 7) % 31);
+		}
+
+		arrays[s].values = values[s];
+		arrays[s].len = LEN;
+		arrays[s].pos = 0;
+		arrays[s].pulls = 0;
+		streams[s].pull_func_p = PullArray;
+		streams[s].stream_param = &arrays[s];
+	}
+}
@@ -0,0 +1,325 @@
+/*******************************************************************************
+************************ - MEMORY MAPPED PRIORITY QUEUE - **********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L		/* mkdtemp */
+
+#include <stdio.h>		/* printf, puts, sprintf, remove, tmpfile */
+#include <stdlib.h>		/* malloc, free, mkdtemp */
+#include <stddef.h>		/* size_t */
+#include <string.h>		/* memcpy, memset, strcmp */
+#include <unistd.h>		/* rmdir, lseek */
+
+#include "utilities.h"
+#include "pqueue.h"
+
+typedef struct job
+{
+	int priority;
+	char name[12];
+} job_ty;
+
+void TestPQMmapHeapOrder(void);
+void TestPQMmapReopen(void);
+void TestPQMmapErase(void);
+void TestPQMmapBadFile(void);
+void TestPQMmapSave(void);
+void TestPQMmapSetCmpParam(void);
+
+static int CmpJobs(const void *job1, const void *job2, const void *param);
+static int IsSamePriority(const void *element_data, const void *param);
+static size_t SerializeJob(const void *data, void *buffer, size_t size, void *param);
+static void *DeserializeInt(const void *buffer, size_t size, void *param);
+static pqueue_ty *OpenQueue(size_t elem_size, size_t capacity);
+
+static char dir[] = "/tmp/pq_mmap_testXXXXXX";
+static char path[64];
+static int test_failures = 0;
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Memory Mapped Priority Queue ---\n);
+
+	if (NULL == mkdtemp(dir))
+	{
+		perror("mkdtemp");
+		return 1;
+	}
+
+	sprintf(path, "%s/jobs.heap", dir);
+
+	TestPQMmapHeapOrder();
+	TestPQMmapReopen();
+	TestPQMmapErase();
+	TestPQMmapBadFile();
+	TestPQMmapSave();
+	TestPQMmapSetCmpParam();
+
+	rmdir(dir);
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQMmapHeapOrder(void)
+{
+	pqueue_ty *pqueue = OpenQueue(sizeof(job_ty), 4);
+	job_ty job = {0, "job"};
+	int prev = -1;
+	int is_ok = (NULL != pqueue && PQueueIsEmpty(pqueue));
+	int i = 0;
+
+	/* grows past the initial capacity */
+	for (i = 0; i < 1000; ++i)
+	{
+		job.priority = (i * 7919) % 1000;
+		is_ok &= (0 == PQueueEnqueue(pqueue, &job));
+	}
+
+	is_ok &= (1000 == PQueueSize(pqueue));
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		is_ok &= (prev < ((job_ty *)PQueuePeek(pqueue))->priority);
+		prev = ((job_ty *)PQueuePeek(pqueue))->priority;
+		PQueueDequeue(pqueue);
+	}
+
+	is_ok &= (NULL == PQueuePeek(pqueue) && 999 == prev);
+
+	PRINT_TEST_RESULT(is_ok, "Test Heap order and growth", test_failures);
+
+	PQueueDestroy(pqueue);
+	remove(path);
+}
+
+void TestPQMmapReopen(void)
+{
+	pqueue_ty *pqueue = OpenQueue(sizeof(job_ty), 0);
+	job_ty jobs[] = {{30, "backup"}, {10, "deploy"}, {20, "report"}};
+	job_ty *top = NULL;
+	size_t i = 0;
+	int is_ok = 1;
+
+	for (i = 0; i < SIZEOF_ARRAY(jobs); ++i)
+	{
+		PQueueEnqueue(pqueue, &jobs[i]);
+	}
+
+	/* the payloads are copied - the originals may go away */
+	memset(jobs, 0, sizeof(jobs));
+	PQueueDestroy(pqueue);
+
+	/* elem_size 0 takes the size from the file */
+	pqueue = OpenQueue(0, 0);
+	is_ok &= (NULL != pqueue && 3 == PQueueSize(pqueue));
+
+	top = (job_ty *)PQueuePeek(pqueue);
+	is_ok &= (10 == top->priority && 0 == strcmp("deploy", top->name));
+	PQueueDequeue(pqueue);
+	PQueueDestroy(pqueue);
+
+	pqueue = OpenQueue(sizeof(job_ty), 0);
+	top = (job_ty *)PQueuePeek(pqueue);
+	is_ok &= (2 == PQueueSize(pqueue));
+	is_ok &= (20 == top->priority && 0 == strcmp("report", top->name));
+
+	PRINT_TEST_RESULT(is_ok, "Test Reopen keeps the heap", test_failures);
+
+	PQueueDestroy(pqueue);
+	remove(path);
+}
+
+void TestPQMmapErase(void)
+{
+	pqueue_ty *pqueue = OpenQueue(sizeof(job_ty), 0);
+	job_ty job = {0, "job"};
+	job_ty *erased = NULL;
+	int to_erase = 13;
+	int missing = 100;
+	int prev = -1;
+	int is_ok = 1;
+	int i = 0;
+
+	for (i = 19; i >= 0; --i)
+	{
+		job.priority = i;
+		PQueueEnqueue(pqueue, &job);
+	}
+
+	erased = (job_ty *)PQueueErase(pqueue, IsSamePriority, &to_erase);
+	is_ok &= (NULL != erased && 13 == erased->priority);
+	is_ok &= (NULL == PQueueErase(pqueue, IsSamePriority, &missing));
+	is_ok &= (19 == PQueueSize(pqueue));
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		is_ok &= (prev < ((job_ty *)PQueuePeek(pqueue))->priority);
+		is_ok &= (13 != ((job_ty *)PQueuePeek(pqueue))->priority);
+		prev = ((job_ty *)PQueuePeek(pqueue))->priority;
+		PQueueDequeue(pqueue);
+	}
+
+	PRINT_TEST_RESULT(is_ok, "Test Erase", test_failures);
+
+	PQueueDestroy(pqueue);
+	remove(path);
+}
+
+void TestPQMmapSetCmpParam(void)
+{
+	pqueue_ty *pqueue = OpenQueue(sizeof(job_ty), 0);
+	job_ty job = {0, "job"};
+	int descending = -1;
+	int prev = 1000;
+	int is_ok = 1;
+	int i = 0;
+
+	for (i = 0; i < 1000; ++i)
+	{
+		job.priority = (i * 7919) % 1000;
+		PQueueEnqueue(pqueue, &job);
+	}
+
+	/* the file is heapified again in place */
+	is_ok &= (0 == PQueueSetCmpParam(pqueue, &descending));
+	is_ok &= (1000 == PQueueSize(pqueue));
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		is_ok &= (prev > ((job_ty *)PQueuePeek(pqueue))->priority);
+		prev = ((job_ty *)PQueuePeek(pqueue))->priority;
+		PQueueDequeue(pqueue);
+	}
+
+	is_ok &= (0 == prev);
+
+	PRINT_TEST_RESULT(is_ok, "Test SetCmpParam", test_failures);
+
+	PQueueDestroy(pqueue);
+	remove(path);
+}
+
+void TestPQMmapBadFile(void)
+{
+	FILE *file = fopen(path, "wb");
+	int is_ok = 1;
+
+	fputs("not a heap file, not a heap file, not a heap file, not a heap", file);
+	fclose(file);
+
+	is_ok &= (NULL == OpenQueue(sizeof(job_ty), 0));
+	remove(path);
+
+	/* a new file needs the element size */
+	is_ok &= (NULL == OpenQueue(0, 0));
+	remove(path);
+
+	PRINT_TEST_RESULT(is_ok, "Test Foreign file is rejected", test_failures);
+}
+
+void TestPQMmapSave(void)
+{
+	pqueue_ty *pqueue = OpenQueue(sizeof(job_ty), 0);
+	pqueue_ty *loaded = PQueueCreate(CmpJobs, NULL);
+	job_ty job = {0, "job"};
+	FILE *file = tmpfile();
+	int fd = fileno(file);
+	int prev = -1;
+	int is_ok = 1;
+	int i = 0;
+
+	for (i = 0; i < 50; ++i)
+	{
+		job.priority = (i * 31) % 50;
+		PQueueEnqueue(pqueue, &job);
+	}
+
+	/* Save is in priority order and leaves the heap as is */
+	is_ok &= (0 == PQueueSave(pqueue, fd, SerializeJob, NULL));
+	is_ok &= (50 == PQueueSize(pqueue));
+
+	lseek(fd, 0, SEEK_SET);
+	is_ok &= (0 == PQueueLoad(loaded, fd, DeserializeInt, NULL));
+	is_ok &= (50 == PQueueSize(loaded));
+
+	while (!PQueueIsEmpty(loaded))
+	{
+		is_ok &= (prev + 1 == *(int *)PQueuePeek(loaded));
+		prev = *(int *)PQueuePeek(loaded);
+		free(PQueuePeek(loaded));
+		PQueueDequeue(loaded);
+	}
+
+	/* elements are copies owned by the file - nothing to load into */
+	PQueueClear(pqueue);
+	lseek(fd, 0, SEEK_SET);
+	is_ok &= (0 != PQueueLoad(pqueue, fd, DeserializeInt, NULL));
+
+	PRINT_TEST_RESULT(is_ok, "Test Save", test_failures);
+
+	fclose(file);
+	PQueueDestroy(pqueue);
+	PQueueDestroy(loaded);
+	remove(path);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+/* param (may be NULL) points to the sign of the order */
+static int CmpJobs(const void *job1, const void *job2, const void *param)
+{
+	int sign = (NULL == param) ? 1 : *(const int *)param;
+
+	return sign * (((job_ty *)job1)->priority - ((job_ty *)job2)->priority);
+}
+
+static int IsSamePriority(const void *element_data, const void *param)
+{
+	return (((job_ty *)element_data)->priority == *(int *)param);
+}
+
+/* only the priority is kept */
+static size_t SerializeJob(const void *data, void *buffer, size_t size, void *param)
+{
+	UNUSED(param);
+
+	if (sizeof(int) <= size)
+	{
+		memcpy(buffer, &((job_ty *)data)->priority, sizeof(int));
+	}
+
+	return sizeof(int);
+}
+
+static void *DeserializeInt(const void *buffer, size_t size, void *param)
+{
+	int *data = (int *)malloc(sizeof(int));
+
+	UNUSED(param);
+
+	if (NULL != data && sizeof(int) == size)
+	{
+		memcpy(data, buffer, sizeof(int));
+	}
+
+	return data;
+}
+
+static pqueue_ty *OpenQueue(size_t elem_size, size_t capacity)
+{
+	pq_config_ty config;
+
+	config.engine = PQ_ENGINE_MMAP;
+	config.path = path;
+	config.elem_size = elem_size;
+	config.capacity = capacity;
+
+	return PQueueCreateEx(CmpJobs, NULL, &config);
+}
@@ -0,0 +1,428 @@
+/*******************************************************************************
+************************* - SEQUENCE HEAP PRIORITY QUEUE - *********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests of the heap and sequence heap engines
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L		/* fileno */
+
+#include <stdio.h>		/* printf, puts, tmpfile, fileno */
+#include <stdlib.h>		/* malloc, free */
+#include <stddef.h>		/* size_t */
+#include <string.h>		/* memcpy */
+#include <unistd.h>		/* lseek */
+
+#include "utilities.h"
+#include "pqueue.h"
+
+/* enough to fill the first groups of the sequence heap */
+#define NUM 200000
+
+void TestPQEngineOrder(pq_engine_ty engine, const char *test_name);
+void TestPQEngineInterleaved(pq_engine_ty engine, const char *test_name);
+void TestPQEngineErase(pq_engine_ty engine, const char *test_name);
+void TestPQEngineSave(pq_engine_ty engine, const char *test_name);
+void TestPQEngineKeyIndex(pq_engine_ty engine, const char *test_name);
+void TestPQEngineEraseIf(pq_engine_ty engine, const char *test_name);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+static int IsSameInt(const void *element_data, const void *param);
+static const void *IntKey(const void *data, void *param);
+static size_t HashInt(const void *key, void *param);
+static int IsMultipleOf(const void *data, const void *param);
+static void CountRemoved(void *data, void *param);
+static size_t SerializeInt(const void *data, void *buffer, size_t size, void *param);
+static void *DeserializeInt(const void *buffer, size_t size, void *param);
+static pqueue_ty *CreateQueue(pq_engine_ty engine);
+
+static int values[NUM];
+static size_t removed_count = 0;
+static int test_failures = 0;
+
+int main(void)
+{
+	size_t i = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		values[i] = (int)((i * 7919) % NUM);
+	}
+
+	PRINT_MSG(\n--- Tests Heap Priority Queue ---\n);
+
+	TestPQEngineOrder(PQ_ENGINE_HEAP, "Order");
+	TestPQEngineInterleaved(PQ_ENGINE_HEAP, "Interleaved");
+	TestPQEngineErase(PQ_ENGINE_HEAP, "Erase");
+	TestPQEngineSave(PQ_ENGINE_HEAP, "Save Load");
+	TestPQEngineKeyIndex(PQ_ENGINE_HEAP, "Key index");
+	TestPQEngineEraseIf(PQ_ENGINE_HEAP, "EraseIf");
+
+	PRINT_MSG(\n--- Tests Sequence Heap Priority Queue ---\n);
+
+	TestPQEngineOrder(PQ_ENGINE_SEQHEAP, "Order");
+	TestPQEngineInterleaved(PQ_ENGINE_SEQHEAP, "Interleaved");
+	TestPQEngineErase(PQ_ENGINE_SEQHEAP, "Erase");
+	TestPQEngineSave(PQ_ENGINE_SEQHEAP, "Save Load");
+	TestPQEngineKeyIndex(PQ_ENGINE_SEQHEAP, "Key index not supported");
+	TestPQEngineEraseIf(PQ_ENGINE_SEQHEAP, "EraseIf");
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQEngineOrder(pq_engine_ty engine, const char *test_name)
+{
+	pqueue_ty *pqueue = CreateQueue(engine);
+	int is_ok = 1;
+	int i = 0;
+
+	is_ok &= PQueueIsEmpty(pqueue);
+
+	for (i = 0; i < NUM; ++i)
+	{
+		is_ok &= (0 == PQueueEnqueue(pqueue, &values[i]));
+	}
+
+	is_ok &= (NUM == PQueueSize(pqueue));
+
+	for (i = 0; i < NUM && is_ok; ++i)
+	{
+		is_ok &= (i == *(int *)PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+	}
+
+	is_ok &= PQueueIsEmpty(pqueue);
+
+	/* cleared queue is usable again */
+	for (i = 0; i < 5000; ++i)
+	{
+		PQueueEnqueue(pqueue, &values[i]);
+	}
+
+	PQueueClear(pqueue);
+	is_ok &= PQueueIsEmpty(pqueue);
+	PQueueEnqueue(pqueue, &values[0]);
+	is_ok &= (&values[0] == PQueuePeek(pqueue));
+
+	PQueueDestroy(pqueue);
+
+	PRINT_TEST_RESULT(is_ok, test_name, test_failures);
+}
+
+void TestPQEngineInterleaved(pq_engine_ty engine, const char *test_name)
+{
+	pqueue_ty *pqueue = CreateQueue(engine);
+	int *data = NULL;
+	int prev = -1;
+	int is_ok = 1;
+	int i = 0;
+
+	/* three in, one out - the top is freed before it is dequeued */
+	for (i = 0; i < NUM; ++i)
+	{
+		data = (int *)malloc(sizeof(int));
+		*data = values[i];
+		PQueueEnqueue(pqueue, data);
+
+		if (2 == i % 3)
+		{
+			free(PQueuePeek(pqueue));
+			PQueueDequeue(pqueue);
+		}
+	}
+
+	is_ok &= (NUM - NUM / 3 == PQueueSize(pqueue));
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		is_ok &= (prev <= *(int *)PQueuePeek(pqueue));
+		prev = *(int *)PQueuePeek(pqueue);
+		free(PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+	}
+
+	PQueueDestroy(pqueue);
+
+	PRINT_TEST_RESULT(is_ok, test_name, test_failures);
+}
+
+void TestPQEngineErase(pq_engine_ty engine, const char *test_name)
+{
+	pqueue_ty *pqueue = CreateQueue(engine);
+	int is_ok = 1;
+	int key = 0;
+	int i = 0;
+
+	for (i = 0; i < NUM / 10; ++i)
+	{
+		PQueueEnqueue(pqueue, &values[i * 10]);
+	}
+
+	/* every fifth element, found wherever it is kept */
+	for (key = 0; key < NUM; key += 50)
+	{
+		is_ok &= (key == *(int *)PQueueErase(pqueue, IsSameInt, &key));
+	}
+
+	key = 50;
+	is_ok &= (NULL == PQueueErase(pqueue, IsSameInt, &key));
+	is_ok &= (NUM / 10 - NUM / 50 == PQueueSize(pqueue));
+
+	for (key = 0; key < NUM && is_ok; key += 10)
+	{
+		if (0 != key % 50)
+		{
+			is_ok &= (key == *(int *)PQueuePeek(pqueue));
+			PQueueDequeue(pqueue);
+		}
+	}
+
+	is_ok &= PQueueIsEmpty(pqueue);
+
+	PQueueDestroy(pqueue);
+
+	PRINT_TEST_RESULT(is_ok, test_name, test_failures);
+}
+
+void TestPQEngineSave(pq_engine_ty engine, const char *test_name)
+{
+	pqueue_ty *pqueue = CreateQueue(engine);
+	pqueue_ty *loaded = CreateQueue(engine);
+	FILE *file = tmpfile();
+	int fd = fileno(file);
+	int is_ok = 1;
+	int i = 0;
+
+	for (i = 0; i < NUM / 4; ++i)
+	{
+		PQueueEnqueue(pqueue, &values[i]);
+	}
+
+	/* Save leaves the queue as is */
+	is_ok &= (0 == PQueueSave(pqueue, fd, SerializeInt, NULL));
+	is_ok &= (NUM / 4 == PQueueSize(pqueue));
+
+	lseek(fd, 0, SEEK_SET);
+	is_ok &= (0 == PQueueLoad(loaded, fd, DeserializeInt, NULL));
+	is_ok &= (NUM / 4 == PQueueSize(loaded));
+
+	while (!PQueueIsEmpty(loaded) && is_ok)
+	{
+		is_ok &= (0 == CmpInts(PQueuePeek(pqueue), PQueuePeek(loaded), NULL));
+		free(PQueuePeek(loaded));
+		PQueueDequeue(loaded);
+		PQueueDequeue(pqueue);
+	}
+
+	is_ok &= PQueueIsEmpty(pqueue);
+
+	PQueueDestroy(pqueue);
+	PQueueDestroy(loaded);
+	fclose(file);
+
+	PRINT_TEST_RESULT(is_ok, test_name, test_failures);
+}
+
+void TestPQEngineKeyIndex(pq_engine_ty engine, const char *test_name)
+{
+	pqueue_ty *pqueue = CreateQueue(engine);
+	void **batch = (void **)malloc(NUM / 2 * sizeof(void *));
+	int prev = -1;
+	int key = 0;
+	int is_ok = 1;
+	int i = 0;
+
+	if (0 != PQueueSetKeyIndex(pqueue, IntKey, HashInt, IsSameInt, NULL))
+	{
+		PQueueDestroy(pqueue);
+		free(batch);
+		PRINT_TEST_RESULT(PQ_ENGINE_SEQHEAP == engine, test_name, test_failures);
+		return;
+	}
+
+	for (i = 0; i < NUM / 2; ++i)
+	{
+		is_ok &= (0 == PQueueEnqueue(pqueue, &values[i]));
+		batch[i] = &values[NUM / 2 + i];
+	}
+
+	is_ok &= (NUM / 2 == PQueueEnqueueBatch(pqueue, batch, NUM / 2));
+
+	/* the values are 0 to NUM - 1 - erase the multiples of 3 by key */
+	for (key = 0; key < NUM; key += 3)
+	{
+		is_ok &= (key == *(int *)PQueueEraseKey(pqueue, &key));
+	}
+
+	key = 3;
+	is_ok &= (NULL == PQueueEraseKey(pqueue, &key));
+	is_ok &= !PQueueContains(pqueue, &key);
+	key = 4;
+	is_ok &= PQueueContains(pqueue, &key);
+
+	/* Erase and Dequeue keep the index */
+	is_ok &= (4 == *(int *)PQueueErase(pqueue, IsSameInt, &key));
+	is_ok &= !PQueueContains(pqueue, &key);
+
+	while (!PQueueIsEmpty(pqueue) && is_ok)
+	{
+		key = *(int *)PQueuePeek(pqueue);
+		is_ok &= (prev < key && 0 != key % 3);
+		prev = key;
+		PQueueDequeue(pqueue);
+		is_ok &= !PQueueContains(pqueue, &key);
+	}
+
+	is_ok &= (NUM - 1 == prev);
+
+	PQueueDestroy(pqueue);
+	free(batch);
+
+	PRINT_TEST_RESULT(is_ok, test_name, test_failures);
+}
+
+void TestPQEngineEraseIf(pq_engine_ty engine, const char *test_name)
+{
+	pqueue_ty *pqueue = CreateQueue(engine);
+	size_t left = NUM - NUM / 10;
+	size_t removed = 0;
+	int divisor = 5;
+	int prev = -1;
+	int key = 0;
+	int is_ok = 1;
+	int i = 0;
+
+	/* the index follows the elements the heap moves */
+	if (PQ_ENGINE_HEAP == engine)
+	{
+		PQueueSetKeyIndex(pqueue, IntKey, HashInt, IsSameInt, NULL);
+	}
+
+	for (i = 0; i < NUM; ++i)
+	{
+		PQueueEnqueue(pqueue, &values[i]);
+	}
+
+	/* some in the groups, some in the buffers and the insertion heap */
+	for (i = 0; i < NUM / 10; ++i)
+	{
+		PQueueDequeue(pqueue);
+	}
+
+	is_ok &= (left / 5 == PQueueEraseIf(pqueue, IsMultipleOf, &divisor, NULL));
+	left -= left / 5;
+
+	divisor = 7;
+	removed_count = 0;
+	removed = PQueueEraseIf(pqueue, IsMultipleOf, &divisor, CountRemoved);
+	is_ok &= (0 < removed && removed_count == removed);
+	is_ok &= (left - removed == PQueueSize(pqueue));
+
+	if (PQ_ENGINE_HEAP == engine)
+	{
+		key = 7 * (NUM / 7);
+		is_ok &= !PQueueContains(pqueue, &key);
+		key = NUM - 1;
+		is_ok &= (key == *(int *)PQueueEraseKey(pqueue, &key));
+	}
+
+	while (!PQueueIsEmpty(pqueue) && is_ok)
+	{
+		key = *(int *)PQueuePeek(pqueue);
+		is_ok &= (prev < key && 0 != key % 5 && 0 != key % 7);
+		prev = key;
+		PQueueDequeue(pqueue);
+	}
+
+	PQueueDestroy(pqueue);
+
+	PRINT_TEST_RESULT(is_ok, test_name, test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+
+	return *(const int *)obj1 - *(const int *)obj2;
+}
+
+static int IsSameInt(const void *element_data, const void *param)
+{
+	return *(const int *)element_data == *(const int *)param;
+}
+
+static const void *IntKey(const void *data, void *param)
+{
+	UNUSED(param);
+
+	return data;
+}
+
+static size_t HashInt(const void *key, void *param)
+{
+	UNUSED(param);
+
+	return (size_t)*(const int *)key;
+}
+
+static int IsMultipleOf(const void *data, const void *param)
+{
+	return 0 == *(const int *)data % *(const int *)param;
+}
+
+/* param is the divisor - the count is kept in removed_count */
+static void CountRemoved(void *data, void *param)
+{
+	UNUSED(data);
+	UNUSED(param);
+
+	++removed_count;
+}
+
+static size_t SerializeInt(const void *data, void *buffer, size_t size, void *param)
+{
+	UNUSED(param);
+
+	if (sizeof(int) <= size)
+	{
+		memcpy(buffer, data, sizeof(int));
+	}
+
+	return sizeof(int);
+}
+
+static void *DeserializeInt(const void *buffer, size_t size, void *param)
+{
+	int *data = NULL;
+
+	UNUSED(param);
+
+	if (sizeof(int) != size)
+	{
+		return NULL;
+	}
+
+	data = (int *)malloc(sizeof(int));
+
+	if (NULL != data)
+	{
+		memcpy(data, buffer, sizeof(int));
+	}
+
+	return data;
+}
+
+static pqueue_ty *CreateQueue(pq_engine_ty engine)
+{
+	pq_config_ty config = {PQ_ENGINE_LIST, NULL, 0, 0, NULL, NULL, NULL, NULL};
+
+	config.engine = engine;
+
+	return PQueueCreateEx(CmpInts, NULL, &config);
+}
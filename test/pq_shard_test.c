@@ -0,0 +1,148 @@
+/*******************************************************************************
+*************************** - SHARDED PRIORITY QUEUE - *************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "pq_shard.h"
+
+void TestPQShardDetected(void);
+void TestPQShardLocalFirst(void);
+void TestPQShardThreshold(void);
+void TestPQShardRemoteWhenEmpty(void);
+
+static long KeyOfInt(const void *data, const void *key_param);
+static size_t SimulatedNode(void *node_param);
+static pq_shard_ty *CreateTwoNodes(long threshold, size_t *current_node);
+
+static int nums[] = {10, 20, 5, 100};
+static int test_failures = 0;
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Sharded Priority Queue ---\n);
+
+	TestPQShardDetected();
+	TestPQShardLocalFirst();
+	TestPQShardThreshold();
+	TestPQShardRemoteWhenEmpty();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQShardDetected(void)
+{
+	pq_shard_ty *pq_shard = PQShardCreate(KeyOfInt, NULL, NULL, 0);
+	int is_ok = 1;
+
+	is_ok &= (0 < PQShardNumNodes(pq_shard));
+	is_ok &= (0 == PQShardEnqueue(pq_shard, &nums[1]));
+	is_ok &= (0 == PQShardEnqueue(pq_shard, &nums[0]));
+	is_ok &= (&nums[0] == PQShardDequeue(pq_shard));
+	is_ok &= (&nums[1] == PQShardDequeue(pq_shard));
+	is_ok &= (NULL == PQShardDequeue(pq_shard));
+
+	PRINT_TEST_RESULT(is_ok, "Test Detected topology", test_failures);
+
+	PQShardDestroy(pq_shard);
+}
+
+void TestPQShardLocalFirst(void)
+{
+	size_t current_node = 0;
+	pq_shard_ty *pq_shard = CreateTwoNodes(1000, &current_node);
+	int is_ok = 1;
+
+	/* remote 5 is ahead of local 10, but not by more than the threshold */
+	current_node = 0;
+	is_ok &= (&nums[0] == PQShardDequeue(pq_shard));
+	is_ok &= (&nums[1] == PQShardDequeue(pq_shard));
+	is_ok &= (2 == PQShardSize(pq_shard));
+
+	PRINT_TEST_RESULT(is_ok, "Test Local shard first", test_failures);
+
+	PQShardDestroy(pq_shard);
+}
+
+void TestPQShardThreshold(void)
+{
+	size_t current_node = 0;
+	pq_shard_ty *pq_shard = CreateTwoNodes(3, &current_node);
+	int is_ok = 1;
+
+	/* local 10 falls behind remote 5 by more than 3 */
+	current_node = 0;
+	is_ok &= (&nums[2] == PQShardDequeue(pq_shard));
+	is_ok &= (&nums[0] == PQShardDequeue(pq_shard));
+	is_ok &= (&nums[1] == PQShardDequeue(pq_shard));
+
+	PRINT_TEST_RESULT(is_ok, "Test Threshold", test_failures);
+
+	PQShardDestroy(pq_shard);
+}
+
+void TestPQShardRemoteWhenEmpty(void)
+{
+	size_t current_node = 0;
+	pq_shard_ty *pq_shard = CreateTwoNodes(1000, &current_node);
+	int is_ok = 1;
+
+	current_node = 1;
+	is_ok &= (&nums[2] == PQShardDequeue(pq_shard));
+	is_ok &= (&nums[3] == PQShardDequeue(pq_shard));
+
+	/* node 1 is empty, its thread is served from node 0 */
+	is_ok &= (&nums[0] == PQShardDequeue(pq_shard));
+	is_ok &= (&nums[1] == PQShardDequeue(pq_shard));
+	is_ok &= (NULL == PQShardDequeue(pq_shard));
+	is_ok &= (0 == PQShardSize(pq_shard));
+
+	PRINT_TEST_RESULT(is_ok, "Test Remote when local is empty", test_failures);
+
+	PQShardDestroy(pq_shard);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+static long KeyOfInt(const void *data, const void *key_param)
+{
+	UNUSED(key_param);
+	return *(int *)data;
+}
+
+static size_t SimulatedNode(void *node_param)
+{
+	return *(size_t *)node_param;
+}
+
+/* node 0 holds 10, 20; node 1 holds 5, 100 */
+static pq_shard_ty *CreateTwoNodes(long threshold, size_t *current_node)
+{
+	pq_shard_topology_ty topology = {0};
+	pq_shard_ty *pq_shard = NULL;
+
+	topology.num_nodes = 2;
+	topology.current_node = SimulatedNode;
+	topology.node_param = current_node;
+
+	pq_shard = PQShardCreate(KeyOfInt, NULL, &topology, threshold);
+
+	*current_node = 0;
+	PQShardEnqueue(pq_shard, &nums[1]);
+	PQShardEnqueue(pq_shard, &nums[0]);
+
+	*current_node = 1;
+	PQShardEnqueue(pq_shard, &nums[3]);
+	PQShardEnqueue(pq_shard, &nums[2]);
+
+	return pq_shard;
+}
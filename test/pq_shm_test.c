@@ -0,0 +1,303 @@
+/*******************************************************************************
+************************* - SHARED MEMORY PRIORITY QUEUE - *********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L		/* shm_open, fork */
+
+#include <stdio.h>		/* printf, puts, sprintf */
+#include <stdlib.h>		/* exit */
+#include <stddef.h>		/* size_t */
+#include <fcntl.h>		/* O_CREAT */
+#include <unistd.h>		/* fork, ftruncate, getpid */
+#include <sys/mman.h>	/* shm_open, mmap */
+#include <sys/wait.h>	/* waitpid */
+
+#include "utilities.h"
+#include "pq_shm.h"
+
+#define CAPACITY 256
+#define PER_CHILD 100
+#define BEFORE_DEATH 63
+
+typedef struct job
+{
+	int priority;
+	int producer;
+} job_ty;
+
+void TestPQShmFormatAttach(void);
+void TestPQShmTwoMappings(void);
+void TestPQShmProcesses(void);
+void TestPQShmOwnerDied(void);
+
+static int CmpJobs(const void *job1, const void *job2, const void *param);
+static int CmpJobsDying(const void *job1, const void *job2, const void *param);
+static void *MapRegion(int fd, size_t size);
+static int OpenRegion(size_t size);
+
+static char shm_name[64];
+static int cmps_to_death = 0;
+static int test_failures = 0;
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Shared Memory Priority Queue ---\n);
+
+	sprintf(shm_name, "/pq_shm_test_%ld", (long)getpid());
+
+	TestPQShmFormatAttach();
+	TestPQShmTwoMappings();
+	TestPQShmProcesses();
+	TestPQShmOwnerDied();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQShmFormatAttach(void)
+{
+	size_t size = PQShmRegionSize(2, sizeof(job_ty));
+	int fd = OpenRegion(size);
+	void *region = MapRegion(fd, size);
+	job_ty jobs[] = {{7, 0}, {3, 0}, {5, 0}};
+	job_ty out = {0, 0};
+	pq_shm_ty *pq_shm = NULL;
+	int is_ok = 1;
+
+	is_ok &= (0 != PQShmFormat(region, size - 1, 2, sizeof(job_ty)));
+	is_ok &= (0 == PQShmFormat(region, size, 2, sizeof(job_ty)));
+
+	pq_shm = PQShmAttach(region, CmpJobs, NULL);
+	is_ok &= (NULL != pq_shm);
+
+	is_ok &= (0 != PQShmPeek(pq_shm, &out));
+	is_ok &= (0 == PQShmEnqueue(pq_shm, &jobs[0]));
+	is_ok &= (0 == PQShmEnqueue(pq_shm, &jobs[1]));
+	is_ok &= (0 != PQShmEnqueue(pq_shm, &jobs[2]));
+	is_ok &= (2 == PQShmSize(pq_shm));
+
+	is_ok &= (0 == PQShmPeek(pq_shm, &out) && 3 == out.priority);
+	is_ok &= (0 == PQShmDequeue(pq_shm, &out) && 3 == out.priority);
+	is_ok &= (0 == PQShmEnqueue(pq_shm, &jobs[2]));
+	is_ok &= (0 == PQShmDequeue(pq_shm, &out) && 5 == out.priority);
+	is_ok &= (0 == PQShmDequeue(pq_shm, NULL));
+	is_ok &= (0 != PQShmDequeue(pq_shm, &out));
+
+	PRINT_TEST_RESULT(is_ok, "Test Format and Attach", test_failures);
+
+	PQShmDetach(pq_shm);
+	munmap(region, size);
+	close(fd);
+	shm_unlink(shm_name);
+}
+
+void TestPQShmTwoMappings(void)
+{
+	size_t size = PQShmRegionSize(CAPACITY, sizeof(job_ty));
+	int fd = OpenRegion(size);
+	void *region1 = MapRegion(fd, size);
+	void *region2 = MapRegion(fd, size);
+	job_ty job = {42, 1};
+	job_ty out = {0, 0};
+	pq_shm_ty *pq_shm1 = NULL;
+	pq_shm_ty *pq_shm2 = NULL;
+	int is_ok = (region1 != region2);
+
+	PQShmFormat(region1, size, CAPACITY, sizeof(job_ty));
+	pq_shm1 = PQShmAttach(region1, CmpJobs, NULL);
+	pq_shm2 = PQShmAttach(region2, CmpJobs, NULL);
+
+	/* offsets, not pointers, are stored in the region */
+	is_ok &= (0 == PQShmEnqueue(pq_shm1, &job));
+	is_ok &= (0 == PQShmDequeue(pq_shm2, &out));
+	is_ok &= (42 == out.priority && 1 == out.producer);
+
+	PRINT_TEST_RESULT(is_ok, "Test Two mappings", test_failures);
+
+	PQShmDetach(pq_shm1);
+	PQShmDetach(pq_shm2);
+	munmap(region1, size);
+	munmap(region2, size);
+	close(fd);
+	shm_unlink(shm_name);
+}
+
+void TestPQShmProcesses(void)
+{
+	size_t size = PQShmRegionSize(CAPACITY, sizeof(job_ty));
+	int fd = OpenRegion(size);
+	void *region = MapRegion(fd, size);
+	pq_shm_ty *pq_shm = NULL;
+	pid_t children[2] = {0};
+	job_ty job = {0, 0};
+	int prev = -1;
+	int child_status = 0;
+	int is_ok = 1;
+	int i = 0;
+	int j = 0;
+
+	PQShmFormat(region, size, CAPACITY, sizeof(job_ty));
+
+	/* the children must not print the buffered output again */
+	fflush(stdout);
+
+	for (i = 0; i < 2; ++i)
+	{
+		children[i] = fork();
+
+		if (0 == children[i])
+		{
+			/* every child maps and attaches on its own */
+			void *child_region = MapRegion(fd, size);
+			pq_shm_ty *child_shm = PQShmAttach(child_region, CmpJobs, NULL);
+
+			for (j = 0; j < PER_CHILD; ++j)
+			{
+				job.priority = (j * 7919 + i) % 1000;
+				job.producer = i;
+				PQShmEnqueue(child_shm, &job);
+			}
+
+			PQShmDetach(child_shm);
+			exit(0);
+		}
+	}
+
+	for (i = 0; i < 2; ++i)
+	{
+		waitpid(children[i], &child_status, 0);
+		is_ok &= (0 == child_status);
+	}
+
+	pq_shm = PQShmAttach(region, CmpJobs, NULL);
+	is_ok &= (2 * PER_CHILD == PQShmSize(pq_shm));
+
+	while (0 == PQShmDequeue(pq_shm, &job))
+	{
+		is_ok &= (prev <= job.priority);
+		prev = job.priority;
+	}
+
+	PRINT_TEST_RESULT(is_ok, "Test Producer processes", test_failures);
+
+	PQShmDetach(pq_shm);
+	munmap(region, size);
+	close(fd);
+	shm_unlink(shm_name);
+}
+
+void TestPQShmOwnerDied(void)
+{
+	size_t size = PQShmRegionSize(CAPACITY, sizeof(job_ty));
+	int fd = OpenRegion(size);
+	void *region = MapRegion(fd, size);
+	pq_shm_ty *pq_shm = NULL;
+	pid_t child = 0;
+	job_ty job = {0, 0};
+	int prev = -2;
+	long sum = 0;
+	int child_status = 0;
+	int is_ok = 1;
+	int i = 0;
+
+	PQShmFormat(region, size, CAPACITY, sizeof(job_ty));
+	pq_shm = PQShmAttach(region, CmpJobs, NULL);
+
+	for (i = 0; i < BEFORE_DEATH; ++i)
+	{
+		job.priority = i;
+		PQShmEnqueue(pq_shm, &job);
+	}
+
+	fflush(stdout);
+
+	child = fork();
+
+	if (0 == child)
+	{
+		pq_shm_ty *child_shm = PQShmAttach(region, CmpJobsDying, NULL);
+
+		/* dies in the middle of sifting up, holding the lock */
+		cmps_to_death = 3;
+		job.priority = -1;
+		PQShmEnqueue(child_shm, &job);
+		_exit(1);
+	}
+
+	waitpid(child, &child_status, 0);
+	is_ok &= (WIFEXITED(child_status) && 0 == WEXITSTATUS(child_status));
+
+	/* the heap is rebuilt from the slots - the element of the child is in */
+	is_ok &= (BEFORE_DEATH + 1 == PQShmSize(pq_shm));
+	is_ok &= (0 == PQShmPeek(pq_shm, &job) && -1 == job.priority);
+
+	while (0 == PQShmDequeue(pq_shm, &job))
+	{
+		is_ok &= (prev < job.priority);
+		prev = job.priority;
+		sum += job.priority;
+	}
+
+	is_ok &= (BEFORE_DEATH - 1 == prev);
+	is_ok &= ((long)BEFORE_DEATH * (BEFORE_DEATH - 1) / 2 - 1 == sum);
+
+	/* and the lock is usable again */
+	is_ok &= (0 == PQShmEnqueue(pq_shm, &job) && 1 == PQShmSize(pq_shm));
+
+	PRINT_TEST_RESULT(is_ok, "Test Owner died", test_failures);
+
+	PQShmDetach(pq_shm);
+	munmap(region, size);
+	close(fd);
+	shm_unlink(shm_name);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+static int CmpJobs(const void *job1, const void *job2, const void *param)
+{
+	UNUSED(param);
+	return (((job_ty *)job1)->priority - ((job_ty *)job2)->priority);
+}
+
+static int CmpJobsDying(const void *job1, const void *job2, const void *param)
+{
+	if (0 == --cmps_to_death)
+	{
+		_exit(0);
+	}
+
+	return CmpJobs(job1, job2, param);
+}
+
+static int OpenRegion(size_t size)
+{
+	int fd = shm_open(shm_name, O_CREAT | O_RDWR, 0600);
+
+	if (-1 == fd || 0 != ftruncate(fd, (off_t)size))
+	{
+		perror("shm_open");
+		exit(1);
+	}
+
+	return fd;
+}
+
+static void *MapRegion(int fd, size_t size)
+{
+	void *region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if (MAP_FAILED == region)
+	{
+		perror("mmap");
+		exit(1);
+	}
+
+	return region;
+}
@@ -0,0 +1,475 @@
+/*******************************************************************************
+************************** - DURABLE PRIORITY QUEUE - **************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L		/* mkdtemp */
+
+#include <stdio.h>		/* printf, puts, sprintf, remove */
+#include <stdlib.h>		/* malloc, free, mkdtemp */
+#include <stddef.h>		/* size_t */
+#include <string.h>		/* memcpy */
+#include <sys/stat.h>	/* stat */
+#include <unistd.h>		/* rmdir */
+
+#include "utilities.h"
+#include "pq_wal.h"
+
+void TestPQWalReopen(void);
+void TestPQWalGroupCommit(void);
+void TestPQWalCompaction(void);
+void TestPQWalTornRecord(void);
+void TestPQWalDequeueTies(void);
+void TestPQWalBadImage(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+static int CmpTens(const void *obj1, const void *obj2, const void *param);
+static int IsSameInt(const void *element_data, const void *param);
+static size_t SerializeInt(const void *data, void *buffer, size_t size, void *param);
+static void *DeserializeInt(const void *buffer, size_t size, void *param);
+static size_t SerializeBad(const void *data, void *buffer, size_t size, void *param);
+static void ReleaseInt(void *data, void *param);
+static int *NewInt(int value);
+static void InitCfg(pq_wal_cfg_ty *cfg, size_t group_commit, size_t compact_bytes);
+static long FileSize(const char *suffix);
+static void RemoveFiles(void);
+static int DrainAndCheck(pqueue_ty *pqueue, const int *expected, size_t count);
+
+static char dir[] = "/tmp/pq_wal_testXXXXXX";
+static char base_path[64];
+static int test_failures = 0;
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Durable Priority Queue ---\n);
+
+	if (NULL == mkdtemp(dir))
+	{
+		perror("mkdtemp");
+		return 1;
+	}
+
+	sprintf(base_path, "%s/jobs", dir);
+
+	TestPQWalReopen();
+	TestPQWalGroupCommit();
+	TestPQWalCompaction();
+	TestPQWalTornRecord();
+	TestPQWalDequeueTies();
+	TestPQWalBadImage();
+
+	rmdir(dir);
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQWalReopen(void)
+{
+	int values[] = {40, 10, 30, 20, 50};
+	int erased = 30;
+	int expected[] = {20, 40, 50};
+	pqueue_ty *pqueue = PQueueCreate(CmpInts, NULL);
+	pqueue_ty *reopened = PQueueCreate(CmpInts, NULL);
+	pq_wal_cfg_ty cfg;
+	pq_wal_ty *wal = NULL;
+	void *data = NULL;
+	size_t i = 0;
+	int is_ok = 1;
+
+	InitCfg(&cfg, 4, 0);
+
+	wal = PQWalOpen(pqueue, &cfg);
+	is_ok &= (NULL != wal);
+
+	for (i = 0; i < SIZEOF_ARRAY(values); ++i)
+	{
+		is_ok &= (0 == PQWalEnqueue(wal, NewInt(values[i])));
+	}
+
+	data = PQWalDequeue(wal);
+	is_ok &= (10 == *(int *)data);
+	free(data);
+
+	data = PQWalErase(wal, IsSameInt, &erased);
+	is_ok &= (30 == *(int *)data);
+	free(data);
+
+	is_ok &= (0 == PQWalClose(wal));
+
+	/* a new process: the queue comes back from the log */
+	wal = PQWalOpen(reopened, &cfg);
+	is_ok &= (NULL != wal);
+	is_ok &= DrainAndCheck(reopened, expected, SIZEOF_ARRAY(expected));
+	PQWalClose(wal);
+
+	PRINT_TEST_RESULT(is_ok, "Test Reopen replays the log", test_failures);
+
+	DrainAndCheck(pqueue, expected, SIZEOF_ARRAY(expected));
+	PQueueDestroy(pqueue);
+	PQueueDestroy(reopened);
+	RemoveFiles();
+}
+
+void TestPQWalGroupCommit(void)
+{
+	pqueue_ty *pqueue = PQueueCreate(CmpInts, NULL);
+	pq_wal_cfg_ty cfg;
+	pq_wal_ty *wal = NULL;
+	long header_size = 0;
+	int is_ok = 1;
+
+	InitCfg(&cfg, 3, 0);
+
+	wal = PQWalOpen(pqueue, &cfg);
+	header_size = FileSize(".log");
+
+	/* nothing reaches the file before a group is complete */
+	PQWalEnqueue(wal, NewInt(1));
+	PQWalEnqueue(wal, NewInt(2));
+	is_ok &= (header_size == FileSize(".log"));
+
+	PQWalEnqueue(wal, NewInt(3));
+	is_ok &= (header_size < FileSize(".log"));
+
+	PQWalEnqueue(wal, NewInt(4));
+	header_size = FileSize(".log");
+	is_ok &= (0 == PQWalSync(wal));
+	is_ok &= (header_size < FileSize(".log"));
+
+	PQWalClose(wal);
+
+	PRINT_TEST_RESULT(is_ok, "Test Group commit", test_failures);
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		free(PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+	}
+
+	PQueueDestroy(pqueue);
+	RemoveFiles();
+}
+
+void TestPQWalCompaction(void)
+{
+	int expected[] = {197, 198, 199};
+	pqueue_ty *pqueue = PQueueCreate(CmpInts, NULL);
+	pqueue_ty *reopened = PQueueCreate(CmpInts, NULL);
+	pq_wal_cfg_ty cfg;
+	pq_wal_ty *wal = NULL;
+	int is_ok = 1;
+	int i = 0;
+
+	InitCfg(&cfg, 1, 256);
+
+	wal = PQWalOpen(pqueue, &cfg);
+
+	for (i = 0; i < 200; ++i)
+	{
+		PQWalEnqueue(wal, NewInt(i));
+
+		if (3 <= i)
+		{
+			free(PQWalDequeue(wal));
+		}
+	}
+
+	/* the log is truncated into a snapshot once it passes 256 bytes */
+	is_ok &= (256 >= FileSize(".log"));
+	is_ok &= (0 < FileSize(".snap"));
+
+	PQWalClose(wal);
+
+	wal = PQWalOpen(reopened, &cfg);
+	is_ok &= DrainAndCheck(reopened, expected, SIZEOF_ARRAY(expected));
+	PQWalClose(wal);
+
+	PRINT_TEST_RESULT(is_ok, "Test Snapshot compaction", test_failures);
+
+	DrainAndCheck(pqueue, expected, SIZEOF_ARRAY(expected));
+	PQueueDestroy(pqueue);
+	PQueueDestroy(reopened);
+	RemoveFiles();
+}
+
+void TestPQWalTornRecord(void)
+{
+	int expected[] = {5, 6};
+	unsigned char garbage[] = {'E', 4, 0, 0, 0, 7};
+	pqueue_ty *pqueue = PQueueCreate(CmpInts, NULL);
+	pqueue_ty *reopened = PQueueCreate(CmpInts, NULL);
+	pq_wal_cfg_ty cfg;
+	pq_wal_ty *wal = NULL;
+	FILE *log = NULL;
+	char log_path[80] = {0};
+	long valid_size = 0;
+	int is_ok = 1;
+
+	InitCfg(&cfg, 1, 0);
+
+	wal = PQWalOpen(pqueue, &cfg);
+	PQWalEnqueue(wal, NewInt(6));
+	PQWalEnqueue(wal, NewInt(5));
+	PQWalClose(wal);
+
+	/* a crash in the middle of a write leaves half a record */
+	valid_size = FileSize(".log");
+	sprintf(log_path, "%s.log", base_path);
+	log = fopen(log_path, "ab");
+	fwrite(garbage, sizeof(garbage), 1, log);
+	fclose(log);
+
+	wal = PQWalOpen(reopened, &cfg);
+	is_ok &= (NULL != wal);
+	is_ok &= (valid_size == FileSize(".log"));
+	is_ok &= DrainAndCheck(reopened, expected, SIZEOF_ARRAY(expected));
+	PQWalClose(wal);
+
+	PRINT_TEST_RESULT(is_ok, "Test Torn record", test_failures);
+
+	DrainAndCheck(pqueue, expected, SIZEOF_ARRAY(expected));
+	PQueueDestroy(pqueue);
+	PQueueDestroy(reopened);
+	RemoveFiles();
+}
+
+void TestPQWalDequeueTies(void)
+{
+	pq_config_ty config = {PQ_ENGINE_HEAP, NULL, 0, 0, NULL, NULL, NULL, NULL};
+	pqueue_ty *pqueue = PQueueCreate(CmpTens, NULL);
+	pqueue_ty *reopened = PQueueCreateEx(CmpTens, NULL, &config);
+	pq_wal_cfg_ty cfg;
+	pq_wal_ty *wal = NULL;
+	int dequeued[2] = {0};
+	int *data = NULL;
+	int i = 0;
+	int is_ok = 1;
+
+	InitCfg(&cfg, 1, 0);
+
+	/* all equal by the tens - each engine breaks the tie its own way */
+	wal = PQWalOpen(pqueue, &cfg);
+
+	for (i = 34; i >= 31; --i)
+	{
+		is_ok &= (PQ_WAL_SUCCESS == PQWalEnqueue(wal, NewInt(i)));
+	}
+
+	for (i = 0; i < 2; ++i)
+	{
+		data = (int *)PQWalDequeue(wal);
+		dequeued[i] = *data;
+		free(data);
+	}
+
+	is_ok &= (PQ_WAL_SUCCESS == PQWalClose(wal));
+
+	/* the replay removes the same elements from a heap */
+	wal = PQWalOpen(reopened, &cfg);
+	is_ok &= (NULL != wal && 2 == PQueueSize(reopened));
+
+	while (!PQueueIsEmpty(reopened))
+	{
+		data = (int *)PQueuePeek(reopened);
+		is_ok &= (dequeued[0] != *data && dequeued[1] != *data);
+		PQueueDequeue(reopened);
+		free(data);
+	}
+
+	PQWalClose(wal);
+
+	PRINT_TEST_RESULT(is_ok, "Test Dequeue replays the same element", test_failures);
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		free(PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+	}
+
+	PQueueDestroy(pqueue);
+	PQueueDestroy(reopened);
+	RemoveFiles();
+}
+
+void TestPQWalBadImage(void)
+{
+	pqueue_ty *pqueue = PQueueCreate(CmpInts, NULL);
+	pq_wal_cfg_ty cfg;
+	pq_wal_ty *wal = NULL;
+	int *growing = NewInt(-2);
+	int *huge = NewInt(-1);
+	int is_ok = 1;
+
+	InitCfg(&cfg, 1, 0);
+	cfg.serialize_func_p = SerializeBad;
+
+	wal = PQWalOpen(pqueue, &cfg);
+	is_ok &= (PQ_WAL_SUCCESS == PQWalEnqueue(wal, NewInt(1)));
+
+	/* an image which cannot be written whole is not logged, nor enqueued */
+	is_ok &= (PQ_WAL_NOT_DONE == PQWalEnqueue(wal, growing));
+
+	if (sizeof(size_t) > 4)
+	{
+		is_ok &= (PQ_WAL_NOT_DONE == PQWalEnqueue(wal, huge));
+	}
+
+	is_ok &= (1 == PQueueSize(pqueue));
+	PQWalClose(wal);
+
+	free(growing);
+	free(huge);
+
+	PRINT_TEST_RESULT(is_ok, "Test Image too big to log", test_failures);
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		free(PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+	}
+
+	PQueueDestroy(pqueue);
+	RemoveFiles();
+}
+
+/*-------------------------------Side Function ------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+	return (*(int *)obj1 - *(int *)obj2);
+}
+
+static int CmpTens(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+	return (*(int *)obj1 / 10 - *(int *)obj2 / 10);
+}
+
+static int IsSameInt(const void *element_data, const void *param)
+{
+	return (*(int *)element_data == *(int *)param);
+}
+
+static size_t SerializeInt(const void *data, void *buffer, size_t size, void *param)
+{
+	UNUSED(param);
+
+	if (sizeof(int) <= size)
+	{
+		memcpy(buffer, data, sizeof(int));
+	}
+
+	return sizeof(int);
+}
+
+static void *DeserializeInt(const void *buffer, size_t size, void *param)
+{
+	int *data = NULL;
+
+	UNUSED(param);
+
+	if (sizeof(int) != size)
+	{
+		return NULL;
+	}
+
+	data = (int *)malloc(sizeof(int));
+
+	if (NULL != data)
+	{
+		memcpy(data, buffer, sizeof(int));
+	}
+
+	return data;
+}
+
+/* -2 needs more than it is given every time, -1 needs 4 GiB */
+static size_t SerializeBad(const void *data, void *buffer, size_t size, void *param)
+{
+	if (-2 == *(const int *)data)
+	{
+		return size + 1;
+	}
+
+	if (-1 == *(const int *)data)
+	{
+		return (size_t)0xFFFFFFFFUL + 1;
+	}
+
+	return SerializeInt(data, buffer, size, param);
+}
+
+static void ReleaseInt(void *data, void *param)
+{
+	UNUSED(param);
+	free(data);
+}
+
+static int *NewInt(int value)
+{
+	int *data = (int *)malloc(sizeof(int));
+
+	*data = value;
+
+	return data;
+}
+
+static void InitCfg(pq_wal_cfg_ty *cfg, size_t group_commit, size_t compact_bytes)
+{
+	cfg->path = base_path;
+	cfg->serialize_func_p = SerializeInt;
+	cfg->deserialize_func_p = DeserializeInt;
+	cfg->release_func_p = ReleaseInt;
+	cfg->param = NULL;
+	cfg->group_commit = group_commit;
+	cfg->compact_bytes = compact_bytes;
+}
+
+static long FileSize(const char *suffix)
+{
+	char path[80] = {0};
+	struct stat st;
+
+	sprintf(path, "%s%s", base_path, suffix);
+
+	if (0 != stat(path, &st))
+	{
+		return -1;
+	}
+
+	return (long)st.st_size;
+}
+
+static void RemoveFiles(void)
+{
+	char path[80] = {0};
+
+	sprintf(path, "%s.log", base_path);
+	remove(path);
+	sprintf(path, "%s.snap", base_path);
+	remove(path);
+}
+
+/* dequeue everything, compare with expected and free the elements */
+static int DrainAndCheck(pqueue_ty *pqueue, const int *expected, size_t count)
+{
+	int is_ok = (count == PQueueSize(pqueue));
+	size_t i = 0;
+
+	while (!PQueueIsEmpty(pqueue))
+	{
+		is_ok &= (i < count && expected[i] == *(int *)PQueuePeek(pqueue));
+		free(PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+		++i;
+	}
+
+	return is_ok;
+}
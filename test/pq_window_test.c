@@ -0,0 +1,157 @@
+/*******************************************************************************
+************************ - SLIDING WINDOW PRIORITY QUEUE - *********************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* malloc, free */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "pq_window.h"
+
+#define EVENTS 20000
+#define WINDOW 100
+
+void TestPQWindowMaxInWindow(void);
+void TestPQWindowDequeue(void);
+void TestPQWindowDestroy(void);
+
+static int CmpIntsDesc(const void *obj1, const void *obj2, const void *param);
+static void ReleaseInt(void *data, void *param);
+static int *NewInt(int value);
+
+static int values[EVENTS];
+static int test_failures = 0;
+
+int main(void)
+{
+	size_t i = 0;
+
+	for (i = 0; i < EVENTS; ++i)
+	{
+		values[i] = (int)((i * 7919) % 1000);
+	}
+
+	PRINT_MSG(\n--- Tests Sliding Window Priority Queue ---\n);
+
+	TestPQWindowMaxInWindow();
+	TestPQWindowDequeue();
+	TestPQWindowDestroy();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPQWindowMaxInWindow(void)
+{
+	size_t released = 0;
+	pq_window_ty *window = PQWindowCreate(CmpIntsDesc, NULL, ReleaseInt, &released);
+	int is_ok = 1;
+	int max = 0;
+	size_t t = 0;
+	size_t i = 0;
+
+	/* one event per tick, alive for WINDOW ticks */
+	for (t = 0; t < EVENTS; ++t)
+	{
+		is_ok &= (0 == PQWindowEnqueue(window, NewInt(values[t]), t + WINDOW));
+
+		max = values[t];
+
+		for (i = (t < WINDOW) ? 0 : t - WINDOW + 1; i < t; ++i)
+		{
+			max = (values[i] > max) ? values[i] : max;
+		}
+
+		is_ok &= (max == *(int *)PQWindowPeek(window, t));
+		is_ok &= (((t < WINDOW) ? t + 1 : WINDOW) == PQWindowSize(window));
+	}
+
+	is_ok &= (EVENTS - WINDOW == released);
+
+	/* all of them expire at once */
+	is_ok &= (WINDOW == PQWindowExpire(window, EVENTS + WINDOW));
+	is_ok &= PQWindowIsEmpty(window);
+	is_ok &= (NULL == PQWindowPeek(window, EVENTS + WINDOW));
+	is_ok &= (EVENTS == released);
+
+	PQWindowDestroy(window);
+
+	PRINT_TEST_RESULT(is_ok, "Max in window", test_failures);
+}
+
+void TestPQWindowDequeue(void)
+{
+	size_t released = 0;
+	pq_window_ty *window = PQWindowCreate(CmpIntsDesc, NULL, ReleaseInt, &released);
+	int is_ok = 1;
+	int prev = 1000;
+	size_t t = 0;
+
+	for (t = 0; t < 1000; ++t)
+	{
+		PQWindowEnqueue(window, NewInt(values[t]), (t % 2) ? 10 : 20);
+	}
+
+	/* the odd ones expire; the rest come out in order, freed by the user */
+	while (NULL != PQWindowPeek(window, 15))
+	{
+		is_ok &= (prev >= *(int *)PQWindowPeek(window, 15));
+		prev = *(int *)PQWindowPeek(window, 15);
+		free(PQWindowPeek(window, 15));
+		PQWindowDequeue(window);
+	}
+
+	is_ok &= (500 == released);
+
+	PQWindowDestroy(window);
+
+	PRINT_TEST_RESULT(is_ok, "Dequeue", test_failures);
+}
+
+void TestPQWindowDestroy(void)
+{
+	size_t released = 0;
+	pq_window_ty *window = PQWindowCreate(CmpIntsDesc, NULL, ReleaseInt, &released);
+	size_t t = 0;
+
+	for (t = 0; t < 100; ++t)
+	{
+		PQWindowEnqueue(window, NewInt(values[t]), t);
+	}
+
+	/* nothing peeked - Destroy releases them all */
+	PQWindowDestroy(window);
+
+	PRINT_TEST_RESULT(100 == released, "Destroy releases", test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+static int CmpIntsDesc(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+
+	return *(const int *)obj2 - *(const int *)obj1;
+}
+
+static void ReleaseInt(void *data, void *param)
+{
+	++*(size_t *)param;
+	free(data);
+}
+
+static int *NewInt(int value)
+{
+	int *data = (int *)malloc(sizeof(int));
+
+	*data = value;
+
+	return data;
+}
@@ -7,10 +7,13 @@
 * 
 *******************************************************************************/
 
-#include <stdio.h>		/* printf, puts */
+#define _POSIX_C_SOURCE 200112L		/* fileno */
+
+#include <stdio.h>		/* printf, puts, tmpfile */
 #include <stdlib.h>		/* abort */
 #include <stddef.h>		/* size_t */
-#include <string.h>		/* strcmp */
+#include <string.h>		/* strcmp, strlen, memcpy */
+#include <unistd.h>		/* lseek */
 
 #include "utilities.h"
 #include "pqueue.h"
@@ -27,6 +30,11 @@ celebs_ty brittney = {"Britney Spears", 39, 2};
 celebs_ty sponge_bob = {"Sponge Bob", 5, 1};
 celebs_ty james = {"James Bond", 42, 5};
 celebs_ty chan = {"Jackie Chan", 67, 8};
+size_t removed_count = 0;
+
+#define BULK_NUM 50000
+int bulk_values[BULK_NUM];
+void *bulk_items[BULK_NUM];
 
 
 void TestPQueueCreate(void);
@@ -37,10 +45,28 @@ void TestPQueueIsEmpty(void);
 void TestPQueueSize(void);
 void TestPQueueClear(void);
 void TestPQueueErase(void);
+void TestPQueueEnqueueBatch(void);
+void TestPQueueSaveLoad(void);
+void TestPQueueEraseKey(void);
+void TestPQueueEraseIf(void);
+void TestPQueueSetCmpParam(void);
+void TestPQueueEnqueueBulkParallel(void);
+void TestPQueueHeadChurn(void);
 
 static int PQCmpObjs(const void *obj1, const void *obj2, const void *priority);
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+static int CmpCounted(const void *obj1, const void *obj2, const void *counter);
+static int IsBulkInOrder(pqueue_ty *pqueue, size_t size);
 static int AreNamesMatch(const void *struct_name, const void *looked_for_name);
+static const void *CelebName(const void *data, void *param);
+static size_t HashName(const void *name, void *param);
+static int IsOlderThan(const void *celeb, const void *age);
+static void CountRemoved(void *celeb, void *age);
 static pqueue_ty *CreatePQueue(void);
+static size_t SerializeCeleb(const void *data, void *buffer, size_t size, void *param);
+static void *DeserializeCeleb(const void *buffer, size_t size, void *param);
+static size_t SerializeGrowing(const void *data, void *buffer, size_t size, void *param);
+static size_t SerializeHuge(const void *data, void *buffer, size_t size, void *param);
 static void PrintPQueue(pqueue_ty *pqueue);
 
 int main(void)
@@ -59,6 +85,13 @@ int main(void)
 	TestPQueueSize();
 	TestPQueueClear();
 	TestPQueueErase();
+	TestPQueueEnqueueBatch();
+	TestPQueueSaveLoad();
+	TestPQueueEraseKey();
+	TestPQueueEraseIf();
+	TestPQueueSetCmpParam();
+	TestPQueueEnqueueBulkParallel();
+	TestPQueueHeadChurn();
 	
 	return 0;
 }
@@ -267,8 +300,370 @@ void TestPQueueErase(void)
 	PQueueDestroy(pqueue);
 }
 
+void TestPQueueEnqueueBatch(void)
+{
+	pqueue_ty *pqueue = PQueueCreate(PQCmpObjs, OFFSETOF(celebs_ty, priority));
+	void *batch[] = {&chan, &brittney, &james, &sponge_bob};
+	size_t added = 0;
+	
+	added = PQueueEnqueueBatch(pqueue, batch, 4);
+	
+	if (4 == added && 4 == PQueueSize(pqueue) && 
+		&sponge_bob == PQueuePeek(pqueue))
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test EnqueueBatch: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test EnqueueBatch: FAILED);
+		DEFAULT;
+	}
+	
+	PQueueDestroy(pqueue);
+}
+
+void TestPQueueSaveLoad(void)
+{
+	pqueue_ty *pqueue = CreatePQueue();
+	pqueue_ty *loaded = PQueueCreate(PQCmpObjs, OFFSETOF(celebs_ty, priority));
+	pqueue_ty *corrupted = PQueueCreate(PQCmpObjs, OFFSETOF(celebs_ty, priority));
+	celebs_ty *expected[] = {&sponge_bob, &brittney, &james, &chan};
+	FILE *file = tmpfile();
+	int fd = fileno(file);
+	int is_ok = 1;
+	size_t i = 0;
+	
+	is_ok &= (0 == PQueueSave(pqueue, fd, SerializeCeleb, NULL));
+	
+	lseek(fd, 0, SEEK_SET);
+	is_ok &= (0 == PQueueLoad(loaded, fd, DeserializeCeleb, NULL));
+	is_ok &= (4 == PQueueSize(loaded));
+	
+	for (i = 0; i < 4 && !PQueueIsEmpty(loaded); ++i)
+	{
+		is_ok &= (expected[i] == PQueuePeek(loaded));
+		PQueueDequeue(loaded);
+	}
+	
+	/* a truncated snapshot is reported */
+	is_ok &= (0 == ftruncate(fd, 20));
+	lseek(fd, 0, SEEK_SET);
+	is_ok &= (0 != PQueueLoad(corrupted, fd, DeserializeCeleb, NULL));
+	
+	/* records which cannot be written whole are refused */
+	is_ok &= (0 != PQueueSave(pqueue, fd, SerializeGrowing, NULL));
+	
+	if (sizeof(size_t) > 4)
+	{
+		is_ok &= (0 != PQueueSave(pqueue, fd, SerializeHuge, NULL));
+	}
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Save and Load: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Save and Load: FAILED);
+		DEFAULT;
+	}
+	
+	fclose(file);
+	PQueueDestroy(pqueue);
+	PQueueDestroy(loaded);
+	PQueueDestroy(corrupted);
+}
+
+void TestPQueueEraseKey(void)
+{
+	pqueue_ty *pqueue = PQueueCreate(PQCmpObjs, OFFSETOF(celebs_ty, priority));
+	void *batch[] = {&chan, &james};
+	int is_ok = 1;
+	
+	is_ok &= (0 == PQueueSetKeyIndex(pqueue, CelebName, HashName, 
+									 AreNamesMatch, NULL));
+	
+	PQueueEnqueue(pqueue, &brittney);
+	PQueueEnqueue(pqueue, &sponge_bob);
+	PQueueEnqueueBatch(pqueue, batch, 2);
+	
+	is_ok &= PQueueContains(pqueue, "James Bond");
+	is_ok &= !PQueueContains(pqueue, "Liad");
+	is_ok &= (&james == PQueueEraseKey(pqueue, "James Bond"));
+	is_ok &= (NULL == PQueueEraseKey(pqueue, "James Bond"));
+	is_ok &= (NULL == PQueueEraseKey(pqueue, "Liad"));
+	
+	PQueueDequeue(pqueue);
+	is_ok &= !PQueueContains(pqueue, "Sponge Bob");
+	is_ok &= (&chan == PQueueEraseKey(pqueue, "Jackie Chan"));
+	is_ok &= (&brittney == PQueuePeek(pqueue) && 1 == PQueueSize(pqueue));
+	
+	PQueueClear(pqueue);
+	is_ok &= !PQueueContains(pqueue, "Britney Spears");
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test EraseKey: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test EraseKey: FAILED);
+		DEFAULT;
+	}
+	
+	PQueueDestroy(pqueue);
+}
+
+void TestPQueueEraseIf(void)
+{
+	pqueue_ty *pqueue = CreatePQueue();
+	int age = 40;
+	int is_ok = 1;
+	
+	removed_count = 0;
+	
+	/* James Bond and Jackie Chan */
+	is_ok &= (2 == PQueueEraseIf(pqueue, IsOlderThan, &age, CountRemoved));
+	is_ok &= (2 == removed_count && 2 == PQueueSize(pqueue));
+	is_ok &= (&sponge_bob == PQueuePeek(pqueue));
+	
+	age = 0;
+	is_ok &= (2 == PQueueEraseIf(pqueue, IsOlderThan, &age, NULL));
+	is_ok &= PQueueIsEmpty(pqueue);
+	is_ok &= (0 == PQueueEraseIf(pqueue, IsOlderThan, &age, NULL));
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test EraseIf: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test EraseIf: FAILED);
+		DEFAULT;
+	}
+	
+	PQueueDestroy(pqueue);
+}
+
+void TestPQueueSetCmpParam(void)
+{
+	pq_config_ty config = {PQ_ENGINE_HEAP, NULL, 0, 0, NULL, NULL, NULL, NULL};
+	pqueue_ty *pqueue = PQueueCreate(PQCmpObjs, OFFSETOF(celebs_ty, priority));
+	pqueue_ty *heap_pqueue = NULL;
+	int is_ok = 1;
+	
+	PQueueSetKeyIndex(pqueue, CelebName, HashName, AreNamesMatch, NULL);
+	PQueueEnqueue(pqueue, &brittney);
+	PQueueEnqueue(pqueue, &sponge_bob);
+	PQueueEnqueue(pqueue, &james);
+	PQueueEnqueue(pqueue, &chan);
+	
+	heap_pqueue = PQueueCreateEx(PQCmpObjs, OFFSETOF(celebs_ty, priority), &config);
+	PQueueEnqueue(heap_pqueue, &brittney);
+	PQueueEnqueue(heap_pqueue, &sponge_bob);
+	PQueueEnqueue(heap_pqueue, &james);
+	PQueueEnqueue(heap_pqueue, &chan);
+	
+	/* by age - the same order as by priority */
+	is_ok &= (0 == PQueueSetCmpParam(pqueue, OFFSETOF(celebs_ty, age)));
+	is_ok &= (0 == PQueueSetCmpParam(heap_pqueue, OFFSETOF(celebs_ty, age)));
+	
+	/* the ages change in place - the oldest comes first now */
+	brittney.age = -brittney.age;
+	sponge_bob.age = -sponge_bob.age;
+	james.age = -james.age;
+	chan.age = -chan.age;
+	
+	PQueueSetCmpParam(pqueue, OFFSETOF(celebs_ty, age));
+	PQueueSetCmpParam(heap_pqueue, OFFSETOF(celebs_ty, age));
+	
+	is_ok &= (&chan == PQueuePeek(pqueue) && &chan == PQueuePeek(heap_pqueue));
+	
+	/* the key index follows the elements */
+	is_ok &= (&james == PQueueEraseKey(pqueue, "James Bond"));
+	is_ok &= (&chan == PQueueEraseKey(pqueue, "Jackie Chan"));
+	is_ok &= (&brittney == PQueuePeek(pqueue) && 2 == PQueueSize(pqueue));
+	
+	PQueueDequeue(heap_pqueue);
+	is_ok &= (&james == PQueuePeek(heap_pqueue));
+	
+	brittney.age = -brittney.age;
+	sponge_bob.age = -sponge_bob.age;
+	james.age = -james.age;
+	chan.age = -chan.age;
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test SetCmpParam: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test SetCmpParam: FAILED);
+		DEFAULT;
+	}
+	
+	PQueueDestroy(pqueue);
+	PQueueDestroy(heap_pqueue);
+}
+
+void TestPQueueEnqueueBulkParallel(void)
+{
+	pq_config_ty config = {PQ_ENGINE_HEAP, NULL, 0, 0, NULL, NULL, NULL, NULL};
+	pqueue_ty *pqueue = PQueueCreate(CmpInts, NULL);
+	pqueue_ty *heap_pqueue = PQueueCreateEx(CmpInts, NULL, &config);
+	pqueue_ty *counted = NULL;
+	size_t counter = 0;
+	size_t batch_cmps = 0;
+	size_t i = 0;
+	int is_ok = 1;
+	
+	for (i = 0; i < BULK_NUM; ++i)
+	{
+		bulk_values[i] = (int)((i * 7919) % (BULK_NUM / 2));
+		bulk_items[i] = &bulk_values[i];
+	}
+	
+	/* empty - sorted on 4 threads, then appended */
+	is_ok &= (BULK_NUM == PQueueEnqueueBulkParallel(pqueue, bulk_items, BULK_NUM, 4));
+	is_ok &= IsBulkInOrder(pqueue, BULK_NUM);
+	
+	/* chunks of different sizes */
+	is_ok &= (BULK_NUM == PQueueEnqueueBulkParallel(heap_pqueue, bulk_items, 
+													BULK_NUM, 3));
+	is_ok &= IsBulkInOrder(heap_pqueue, BULK_NUM);
+	
+	/* not empty - merged into the elements stored */
+	PQueueEnqueue(pqueue, &bulk_values[0]);
+	PQueueEnqueue(pqueue, &bulk_values[1]);
+	is_ok &= (BULK_NUM == PQueueEnqueueBulkParallel(pqueue, bulk_items, BULK_NUM, 8));
+	is_ok &= IsBulkInOrder(pqueue, BULK_NUM + 2);
+	
+	/* too few for a second thread */
+	is_ok &= (100 == PQueueEnqueueBulkParallel(heap_pqueue, bulk_items, 100, 4));
+	is_ok &= IsBulkInOrder(heap_pqueue, 100);
+	
+	/* not empty, no merge path - not sorted before the batch */
+	counted = PQueueCreateEx(CmpCounted, &counter, &config);
+	PQueueEnqueue(counted, &bulk_values[0]);
+	PQueueEnqueueBatch(counted, bulk_items, BULK_NUM);
+	batch_cmps = counter;
+	PQueueClear(counted);
+	counter = 0;
+	PQueueEnqueue(counted, &bulk_values[0]);
+	PQueueEnqueueBulkParallel(counted, bulk_items, BULK_NUM, 4);
+	is_ok &= (batch_cmps == counter);
+	is_ok &= IsBulkInOrder(counted, BULK_NUM + 1);
+	PQueueDestroy(counted);
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test EnqueueBulkParallel: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test EnqueueBulkParallel: FAILED);
+		DEFAULT;
+	}
+	
+	PQueueDestroy(pqueue);
+	PQueueDestroy(heap_pqueue);
+}
+
+void TestPQueueHeadChurn(void)
+{
+	size_t counter = 0;
+	pqueue_ty *pqueue = PQueueCreate(CmpCounted, &counter);
+	int head = 0;
+	size_t i = 0;
+	int is_ok = 1;
+	
+	/* long lived elements, e.g. far timers */
+	for (i = 0; i < BULK_NUM / 2; ++i)
+	{
+		bulk_values[i] = (int)i + 1;
+		PQueueEnqueue(pqueue, &bulk_values[i]);
+	}
+	
+	counter = 0;
+	
+	/* a near timer is added and fires - the list is never walked */
+	for (i = 0; i < BULK_NUM / 2; ++i)
+	{
+		PQueueEnqueue(pqueue, &head);
+		is_ok &= (&head == PQueuePeek(pqueue));
+		PQueueDequeue(pqueue);
+	}
+	
+	is_ok &= (2 * (BULK_NUM / 2) >= counter);
+	is_ok &= (1 == *(int *)PQueuePeek(pqueue));
+	is_ok &= (BULK_NUM / 2 == PQueueSize(pqueue));
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Enqueue head and Dequeue: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Enqueue head and Dequeue: FAILED);
+		DEFAULT;
+	}
+	
+	PQueueDestroy(pqueue);
+}
+
 /*-------------------------------Side Functions ------------------------------*/
 
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+	
+	return (*(int *)obj1 - *(int *)obj2);
+}
+
+static int CmpCounted(const void *obj1, const void *obj2, const void *counter)
+{
+	++*(size_t *)counter;
+	
+	return (*(int *)obj1 - *(int *)obj2);
+}
+
+/* dequeue all; true when there were size elements, in order */
+static int IsBulkInOrder(pqueue_ty *pqueue, size_t size)
+{
+	int prev = -1;
+	int is_ok = (size == PQueueSize(pqueue));
+	
+	while (!PQueueIsEmpty(pqueue))
+	{
+		is_ok &= (prev <= *(int *)PQueuePeek(pqueue));
+		prev = *(int *)PQueuePeek(pqueue);
+		PQueueDequeue(pqueue);
+	}
+	
+	return is_ok;
+}
+
 static int PQCmpObjs(const void *obj1, const void *obj2, const void *priority)
 {
 	size_t priority1 = (size_t)obj1 + (size_t)priority;
@@ -283,6 +678,98 @@ static int AreNamesMatch(const void *struct_name, const void *looking_for)
 	return !strcmp(((celebs_ty *)struct_name)->name, looking_for);
 }
 
+static const void *CelebName(const void *data, void *param)
+{
+	UNUSED(param);
+	
+	return ((const celebs_ty *)data)->name;
+}
+
+static size_t HashName(const void *name, void *param)
+{
+	const char *runner = (const char *)name;
+	size_t hash = 5381;
+	
+	UNUSED(param);
+	
+	while ('\0' != *runner)
+	{
+		hash = hash * 33 + (unsigned char)*runner;
+		++runner;
+	}
+	
+	return hash;
+}
+
+static int IsOlderThan(const void *celeb, const void *age)
+{
+	return ((const celebs_ty *)celeb)->age > *(const int *)age;
+}
+
+static void CountRemoved(void *celeb, void *age)
+{
+	UNUSED(celeb);
+	UNUSED(age);
+	
+	++removed_count;
+}
+
+/* a celeb is saved by name, and restored to the global with the same name */
+static size_t SerializeCeleb(const void *data, void *buffer, size_t size, void *param)
+{
+	const char *name = ((celebs_ty *)data)->name;
+	size_t needed = strlen(name);
+	
+	UNUSED(param);
+	
+	if (needed <= size)
+	{
+		memcpy(buffer, name, needed);
+	}
+	
+	return needed;
+}
+
+static void *DeserializeCeleb(const void *buffer, size_t size, void *param)
+{
+	celebs_ty *celebs[] = {&brittney, &sponge_bob, &james, &chan};
+	size_t i = 0;
+	
+	UNUSED(param);
+	
+	for (i = 0; i < 4; ++i)
+	{
+		if (size == strlen(celebs[i]->name) && 
+			0 == memcmp(buffer, celebs[i]->name, size))
+		{
+			return celebs[i];
+		}
+	}
+	
+	return NULL;
+}
+
+/* needs more than the buffer it is given, every time */
+static size_t SerializeGrowing(const void *data, void *buffer, size_t size, void *param)
+{
+	UNUSED(data);
+	UNUSED(buffer);
+	UNUSED(param);
+	
+	return size + 1;
+}
+
+/* 4 GiB - longer than a 32 bit length; never written */
+static size_t SerializeHuge(const void *data, void *buffer, size_t size, void *param)
+{
+	UNUSED(data);
+	UNUSED(buffer);
+	UNUSED(size);
+	UNUSED(param);
+	
+	return (size_t)0xFFFFFFFFUL + 1;
+}
+
 static pqueue_ty *CreatePQueue(void)
 {
 	pqueue_ty *pqueue = PQueueCreate(PQCmpObjs, OFFSETOF(celebs_ty, priority));
@@ -0,0 +1,159 @@
+/*******************************************************************************
+******************************* - QUANTILE - **********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* qsort */
+#include <stddef.h>		/* size_t */
+#include <string.h>		/* memcpy */
+
+#include "utilities.h"
+#include "quantile.h"
+
+#define NUM 3000
+#define WINDOW 101
+
+void TestQuantileRunningMedian(void);
+void TestQuantileWindowed(void);
+void TestQuantileOrderStatistics(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+static int CmpIntsQsort(const void *obj1, const void *obj2);
+static int RankOf(const int *items, size_t n, double q);
+
+static int values[NUM];
+static int test_failures = 0;
+
+int main(void)
+{
+	size_t i = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		values[i] = (int)((i * 7919) % 1009);
+	}
+
+	PRINT_MSG(\n--- Tests Quantile Tracker ---\n);
+
+	TestQuantileRunningMedian();
+	TestQuantileWindowed();
+	TestQuantileOrderStatistics();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestQuantileRunningMedian(void)
+{
+	quantile_ty *tracker = QuantileCreate(0.5, CmpInts, NULL);
+	int is_ok = 1;
+	size_t i = 0;
+
+	is_ok &= (NULL == QuantileGet(tracker));
+
+	for (i = 0; i < NUM; ++i)
+	{
+		is_ok &= (NULL != QuantileInsert(tracker, &values[i]));
+
+		if (0 == i % 97)
+		{
+			is_ok &= (RankOf(values, i + 1, 0.5) == *(int *)QuantileGet(tracker));
+		}
+	}
+
+	is_ok &= (NUM == QuantileSize(tracker));
+
+	QuantileDestroy(tracker);
+
+	PRINT_TEST_RESULT(is_ok, "Running median", test_failures);
+}
+
+void TestQuantileWindowed(void)
+{
+	quantile_ty *tracker = QuantileCreate(0.5, CmpInts, NULL);
+	quantile_handle_ty *handles[NUM];
+	int is_ok = 1;
+	size_t i = 0;
+
+	/* the median of the last WINDOW values */
+	for (i = 0; i < NUM; ++i)
+	{
+		handles[i] = QuantileInsert(tracker, &values[i]);
+
+		if (WINDOW <= i)
+		{
+			is_ok &= (&values[i - WINDOW] ==
+						QuantileRemove(tracker, handles[i - WINDOW]));
+			is_ok &= (WINDOW == QuantileSize(tracker));
+			is_ok &= (RankOf(values + i - WINDOW + 1, WINDOW, 0.5) ==
+						*(int *)QuantileGet(tracker));
+		}
+	}
+
+	/* remove the rest, from the middle */
+	for (i = NUM - WINDOW; i < NUM; i += 2)
+	{
+		QuantileRemove(tracker, handles[i]);
+	}
+
+	is_ok &= (WINDOW / 2 == QuantileSize(tracker));
+
+	QuantileDestroy(tracker);
+
+	PRINT_TEST_RESULT(is_ok, "Windowed median", test_failures);
+}
+
+void TestQuantileOrderStatistics(void)
+{
+	double qs[4] = {0, 0.25, 0.99, 1};
+	int is_ok = 1;
+	size_t j = 0;
+	size_t i = 0;
+
+	for (j = 0; j < 4; ++j)
+	{
+		quantile_ty *tracker = QuantileCreate(qs[j], CmpInts, NULL);
+
+		for (i = 0; i < 500; ++i)
+		{
+			QuantileInsert(tracker, &values[i]);
+		}
+
+		is_ok &= (RankOf(values, 500, qs[j]) == *(int *)QuantileGet(tracker));
+
+		QuantileDestroy(tracker);
+	}
+
+	PRINT_TEST_RESULT(is_ok, "Order statistics", test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+
+	return *(const int *)obj1 - *(const int *)obj2;
+}
+
+static int CmpIntsQsort(const void *obj1, const void *obj2)
+{
+	return CmpInts(obj1, obj2, NULL);
+}
+
+/* the value of rank floor(q * (n - 1)), by sorting a copy */
+static int RankOf(const int *items, size_t n, double q)
+{
+	static int sorted[NUM];
+
+	memcpy(sorted, items, n * sizeof(int));
+	qsort(sorted, n, sizeof(int), CmpIntsQsort);
+
+	return sorted[(size_t)(q * (double)(n - 1))];
+}
@@ -13,6 +13,8 @@
 #include "utilities.h"
 #include "sorted_list.h"
 
+#define NUM 1000
+
 void TestSortLCreate(void);
 void TestSortLInsert(void);
 void TestSortLGetData(void);
@@ -22,8 +24,19 @@ void TestSortLNextPrev(void);
 void TestSortLIsSameIter(void);
 void TestSortLFind(void);
 void TestSortLMerge(void);
+void TestSortLMergeGallop(void);
+void TestSortLInsertBatch(void);
+void TestSortLAppend(void);
+void TestSortLSetCmpParam(void);
+void TestSortLSkipIndex(void);
+void TestSortLInsertHint(void);
+void TestSortLRange(int is_indexed);
+void TestSortLCreateFromArray(void);
+void TestSortLAdopt(void);
 
 static int CmpObjects(const void *obj1, const void *obj2, const void *key);
+static int CmpSigned(const void *obj1, const void *obj2, const void *sign);
+static int CmpCounted(const void *obj1, const void *obj2, const void *counter);
 static void PrintSortedList(sortl_ty *sort_list);
 
 
@@ -39,6 +52,16 @@ int main(void)
 	TestSortLIsSameIter();
 	TestSortLFind();
 	TestSortLMerge();
+	TestSortLMergeGallop();
+	TestSortLInsertBatch();
+	TestSortLAppend();
+	TestSortLSetCmpParam();
+	TestSortLSkipIndex();
+	TestSortLInsertHint();
+	TestSortLRange(0);
+	TestSortLRange(1);
+	TestSortLCreateFromArray();
+	TestSortLAdopt();
 	
 	return 0;
 }
@@ -318,10 +341,578 @@ void TestSortLMerge(void)
 	SortLDestroy(donor);
 }
 
+void TestSortLMergeGallop(void)
+{
+	size_t counter = 0;
+	static int nums[NUM];
+	static int equals[NUM / 50];
+	sortl_ty *dest = SortLCreate(CmpCounted, &counter);
+	sortl_ty *donor = SortLCreate(CmpCounted, &counter);
+	sortl_itr_ty runner = {NULL};
+	int prev = -1;
+	size_t i = 0;
+	int is_ok = 1;
+	
+	PRINT_MSG(\n--- Test Merge Gallop ---);
+	
+	/* runs of 50 in turn; the first of each donor run equals the last of 
+		the dest run before it */
+	for (i = 0; i < NUM; ++i)
+	{
+		nums[i] = (int)i;
+		SortLAppend((0 == i / 50 % 2) ? dest : donor, &nums[i]);
+	}
+	
+	for (i = 0; i < NUM / 50; i += 2)
+	{
+		equals[i] = (int)(i * 50 + 49);
+		SortLInsert(donor, &equals[i]);
+	}
+	
+	counter = 0;
+	SortLMerge(dest, donor);
+	
+	/* far less than one comparison per element */
+	is_ok &= (NUM / 2 > counter);
+	is_ok &= (SortLIsEmpty(donor) && NUM + NUM / 100 == SortLCount(dest));
+	
+	for (runner = SortLBegin(dest); !SortLIsSameIter(runner, SortLEnd(dest)); 
+		 runner = SortLNext(runner))
+	{
+		is_ok &= (prev <= *(int *)SortLGetData(runner));
+		
+		/* on ties the element of dest comes first */
+		if (prev == *(int *)SortLGetData(runner))
+		{
+			is_ok &= (&equals[prev / 50] == SortLGetData(runner));
+		}
+		
+		prev = *(int *)SortLGetData(runner);
+	}
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_MSG(\tMerge Gallop SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tMerge Gallop FAILED);
+		DEFAULT;
+	}
+	
+	SortLDestroy(dest);
+	SortLDestroy(donor);
+}
+
+void TestSortLInsertBatch(void)
+{
+	int key = 1;
+	int num1 = 50;
+	int num2 = 10;
+	int batch_nums[] = {70, 5, 50, 20};
+	int expected[] = {5, 10, 20, 50, 50, 70};
+	void *batch[4] = {NULL};
+	sortl_itr_ty runner = {NULL};
+	sortl_ty *sort_list = SortLCreate(CmpObjects, (void *)&key);
+	size_t inserted = 0;
+	size_t i = 0;
+	int is_sorted = 1;
+	
+	SortLInsert(sort_list, (void *)&num1);
+	SortLInsert(sort_list, (void *)&num2);
+	
+	for (i = 0; i < 4; ++i)
+	{
+		batch[i] = &batch_nums[i];
+	}
+	
+	PRINT_MSG(\n--- Test InsertBatch ---);
+	
+	inserted = SortLInsertBatch(sort_list, batch, 4);
+	
+	runner = SortLBegin(sort_list);
+	for (i = 0; i < 6; ++i)
+	{
+		is_sorted &= (expected[i] == *(int *)SortLGetData(runner));
+		runner = SortLNext(runner);
+	}
+	
+	/* the list element comes before an equal batch element */
+	is_sorted &= (&num1 == SortLGetData(SortLPrev(SortLPrev(SortLPrev(runner)))));
+	
+	if (4 == inserted && 6 == SortLCount(sort_list) && is_sorted)
+	{
+		GREEN;
+		PRINT_MSG(\tInsertBatch SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tInsertBatch FAILED);
+		DEFAULT;
+	}
+	
+	SortLDestroy(sort_list);
+}
+
+void TestSortLAppend(void)
+{
+	int key = 1;
+	int nums[] = {3, 8, 8, 21};
+	sortl_ty *sort_list = SortLCreate(CmpObjects, (void *)&key);
+	sortl_itr_ty last = {NULL};
+	size_t i = 0;
+	
+	PRINT_MSG(\n--- Test Append ---);
+	
+	for (i = 0; i < 4; ++i)
+	{
+		last = SortLAppend(sort_list, (void *)&nums[i]);
+	}
+	
+	if (4 == SortLCount(sort_list) && &nums[0] == SortLGetData(SortLBegin(sort_list)) &&
+		SortLIsSameIter(SortLNext(last), SortLEnd(sort_list)))
+	{
+		GREEN;
+		PRINT_MSG(\tAppend SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tAppend FAILED);
+		DEFAULT;
+	}
+	
+	SortLDestroy(sort_list);
+}
+
+void TestSortLSetCmpParam(void)
+{
+	int ascending = 1;
+	int descending = -1;
+	int nums[] = {40, 7, 7, 93, 15, 62, 7, 28};
+	int expected[] = {93, 62, 40, 28, 15, 7, 7, 7};
+	sortl_itr_ty iters[8];
+	sortl_itr_ty runner = {NULL};
+	sortl_ty *sort_list = SortLCreate(CmpSigned, &ascending);
+	size_t i = 0;
+	int is_ok = 1;
+	
+	PRINT_MSG(\n--- Test SetCmpParam ---);
+	
+	for (i = 0; i < 8; ++i)
+	{
+		iters[i] = SortLInsert(sort_list, (void *)&nums[i]);
+	}
+	
+	SortLSetCmpParam(sort_list, &descending);
+	
+	runner = SortLBegin(sort_list);
+	for (i = 0; i < 8; ++i)
+	{
+		is_ok &= (expected[i] == *(int *)SortLGetData(runner));
+		runner = SortLNext(runner);
+	}
+	
+	/* equal elements keep their order */
+	runner = SortLPrev(SortLEnd(sort_list));
+	is_ok &= (&nums[6] == SortLGetData(runner));
+	is_ok &= (&nums[1] == SortLGetData(SortLPrev(SortLPrev(runner))));
+	
+	/* the iterators still refer to the same elements */
+	for (i = 0; i < 8; ++i)
+	{
+		is_ok &= (&nums[i] == SortLGetData(iters[i]));
+	}
+	
+	/* already sorted - nothing moves */
+	SortLSetCmpParam(sort_list, &descending);
+	is_ok &= (&nums[3] == SortLGetData(SortLBegin(sort_list)));
+	is_ok &= (8 == SortLCount(sort_list));
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_MSG(\tSetCmpParam SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tSetCmpParam FAILED);
+		DEFAULT;
+	}
+	
+	SortLDestroy(sort_list);
+}
+
+void TestSortLSkipIndex(void)
+{
+	int ascending = 1;
+	int descending = -1;
+	static int nums[2 * NUM];
+	static sortl_itr_ty iters[2 * NUM];
+	sortl_ty *sort_list = SortLCreate(CmpSigned, &ascending);
+	sortl_ty *donor = SortLCreate(CmpSigned, &ascending);
+	sortl_itr_ty runner = {NULL};
+	sortl_itr_ty found = {NULL};
+	int missing = NUM;
+	int prev = -1;
+	size_t i = 0;
+	int is_ok = 1;
+	
+	PRINT_MSG(\n--- Test SkipIndex ---);
+	
+	is_ok &= (0 == SortLSetSkipIndex(sort_list, 1));
+	
+	/* every value twice */
+	for (i = 0; i < 2 * NUM; ++i)
+	{
+		nums[i] = (int)((i * 7919) % NUM);
+		iters[i] = SortLInsert(sort_list, &nums[i]);
+	}
+	
+	/* the first of each pair is before the second */
+	for (i = 0; i < NUM; ++i)
+	{
+		found = SortLFind(sort_list, &nums[i]);
+		is_ok &= (&nums[i] == SortLGetData(found));
+		is_ok &= (&nums[i + NUM] == SortLGetData(SortLNext(found)));
+	}
+	
+	is_ok &= SortLIsSameIter(SortLFind(sort_list, &missing), SortLEnd(sort_list));
+	
+	for (i = 0; i < NUM; ++i)
+	{
+		SortLRemove(iters[i]);
+	}
+	
+	for (i = NUM; i < 2 * NUM; ++i)
+	{
+		is_ok &= (&nums[i] == SortLGetData(SortLFind(sort_list, &nums[i])));
+	}
+	
+	/* the index follows Merge and SetCmpParam */
+	is_ok &= (0 == SortLSetSkipIndex(donor, 1));
+	SortLInsert(donor, &missing);
+	SortLMerge(sort_list, donor);
+	SortLSetCmpParam(sort_list, &descending);
+	
+	is_ok &= (&missing == SortLGetData(SortLFind(sort_list, &missing)));
+	is_ok &= (&missing == SortLGetData(SortLBegin(sort_list)));
+	
+	SortLRemove(SortLBegin(sort_list));
+	SortLSetSkipIndex(sort_list, 0);
+	SortLSetCmpParam(sort_list, &ascending);
+	
+	runner = SortLBegin(sort_list);
+	while (!SortLIsSameIter(runner, SortLEnd(sort_list)))
+	{
+		is_ok &= (prev + 1 == *(int *)SortLGetData(runner));
+		prev = *(int *)SortLGetData(runner);
+		runner = SortLNext(runner);
+	}
+	
+	is_ok &= (NUM == SortLCount(sort_list) && SortLIsEmpty(donor));
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_MSG(\tSkipIndex SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tSkipIndex FAILED);
+		DEFAULT;
+	}
+	
+	SortLDestroy(sort_list);
+	SortLDestroy(donor);
+}
+
+void TestSortLInsertHint(void)
+{
+	size_t counter = 0;
+	static int nums[NUM];
+	sortl_ty *sort_list = SortLCreate(CmpCounted, &counter);
+	sortl_itr_ty middle = {NULL};
+	sortl_itr_ty where = {NULL};
+	int near = NUM / 2;
+	int equal = 0;
+	size_t i = 0;
+	int is_ok = 1;
+	
+	PRINT_MSG(\n--- Test InsertHint ---);
+	
+	/* in order, but every 8th one a bit late */
+	for (i = 0; i < NUM; ++i)
+	{
+		nums[i] = (0 == i % 8 && 0 < i) ? (int)i - 3 : (int)i;
+		SortLInsert(sort_list, &nums[i]);
+	}
+	
+	is_ok &= (4 * NUM > counter);
+	
+	/* a late one is placed after the equal ones */
+	is_ok &= (&nums[8] == SortLGetData(SortLNext(SortLFind(sort_list, &nums[5]))));
+	
+	middle = SortLFind(sort_list, &near);
+	counter = 0;
+	
+	/* one step from the hint */
+	where = SortLInsertHint(sort_list, middle, &near);
+	is_ok &= SortLIsSameIter(SortLNext(middle), where);
+	is_ok &= (2 == counter);
+	
+	where = SortLInsertHint(sort_list, SortLEnd(sort_list), &equal);
+	is_ok &= (&equal == SortLGetData(SortLNext(SortLBegin(sort_list))));
+	
+	/* the last insertion is removed - the next one starts next to it */
+	SortLRemove(where);
+	SortLInsert(sort_list, &equal);
+	is_ok &= (&equal == SortLGetData(SortLNext(SortLBegin(sort_list))));
+	
+	is_ok &= (NUM + 2 == SortLCount(sort_list));
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_MSG(\tInsertHint SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tInsertHint FAILED);
+		DEFAULT;
+	}
+	
+	SortLDestroy(sort_list);
+}
+
+void TestSortLRange(int is_indexed)
+{
+	int ascending = 1;
+	static int nums[NUM];
+	sortl_ty *sort_list = SortLCreate(CmpSigned, &ascending);
+	sortl_ty *band = SortLCreate(CmpSigned, &ascending);
+	sortl_itr_ty from = {NULL};
+	sortl_itr_ty to = {NULL};
+	sortl_itr_ty runner = {NULL};
+	int low = 40;
+	int high = 49;
+	int value = 42;
+	int prev = 0;
+	size_t count = 0;
+	size_t i = 0;
+	int is_ok = 1;
+	
+	PRINT_MSG(\n--- Test Bounds and ExtractRange ---);
+	
+	SortLSetSkipIndex(sort_list, is_indexed);
+	SortLSetSkipIndex(band, is_indexed);
+	
+	/* every value 10 times */
+	for (i = 0; i < NUM; ++i)
+	{
+		nums[i] = (int)(i % 100);
+		SortLInsert(sort_list, &nums[i]);
+	}
+	
+	SortLEqualRange(sort_list, &value, &from, &to);
+	
+	for (runner = from; !SortLIsSameIter(runner, to); runner = SortLNext(runner))
+	{
+		is_ok &= (value == *(int *)SortLGetData(runner));
+		++count;
+	}
+	
+	is_ok &= (10 == count);
+	is_ok &= SortLIsSameIter(from, SortLLowerBound(sort_list, &value));
+	is_ok &= SortLIsSameIter(to, SortLUpperBound(sort_list, &value));
+	is_ok &= (value + 1 == *(int *)SortLGetData(to));
+	
+	/* two bands, the bigger one after */
+	SortLExtractRange(sort_list, SortLLowerBound(sort_list, &low), 
+					  SortLUpperBound(sort_list, &high), band);
+	low = 50;
+	high = 59;
+	SortLExtractRange(sort_list, SortLLowerBound(sort_list, &low), 
+					  SortLUpperBound(sort_list, &high), band);
+	
+	is_ok &= (NUM - 200 == SortLCount(sort_list) && 200 == SortLCount(band));
+	
+	SortLEqualRange(sort_list, &value, &from, &to);
+	is_ok &= SortLIsSameIter(from, to);
+	is_ok &= (39 == *(int *)SortLGetData(SortLPrev(from)));
+	is_ok &= (60 == *(int *)SortLGetData(from));
+	is_ok &= (&nums[42] == SortLGetData(SortLFind(band, &value)));
+	
+	prev = 40;
+	for (runner = SortLBegin(band); !SortLIsSameIter(runner, SortLEnd(band)); 
+		 runner = SortLNext(runner))
+	{
+		is_ok &= (prev <= *(int *)SortLGetData(runner));
+		prev = *(int *)SortLGetData(runner);
+	}
+	
+	/* both lists are still usable - list has no tower on a moved node */
+	while (!SortLIsEmpty(band))
+	{
+		SortLRemove(SortLBegin(band));
+	}
+	
+	SortLInsert(sort_list, &value);
+	is_ok &= (&value == SortLGetData(SortLFind(sort_list, &value)));
+	is_ok &= (&nums[99] == SortLGetData(SortLUpperBound(sort_list, &nums[98])));
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_MSG(\tBounds and ExtractRange SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tBounds and ExtractRange FAILED);
+		DEFAULT;
+	}
+	
+	SortLDestroy(sort_list);
+	SortLDestroy(band);
+}
+
 
 /*******************************************************************************
 *******************************************************************************/
 
+void TestSortLCreateFromArray(void)
+{
+	size_t counter = 0;
+	static int nums[NUM];
+	static void *items[NUM];
+	sortl_ty *sort_list = NULL;
+	sortl_itr_ty runner = {NULL};
+	int *prev = NULL;
+	size_t i = 0;
+	int is_ok = 1;
+	
+	PRINT_MSG(\n--- Test CreateFromArray ---);
+	
+	/* every value 4 times */
+	for (i = 0; i < NUM; ++i)
+	{
+		nums[i] = (int)((i * 7919) % (NUM / 4));
+		items[i] = &nums[i];
+	}
+	
+	sort_list = SortLCreateFromArray(CmpCounted, &counter, items, NUM);
+	
+	is_ok &= (NUM == SortLCount(sort_list));
+	
+	/* n * log(n) - not a search per element */
+	is_ok &= (NUM * 12 > counter);
+	
+	for (runner = SortLBegin(sort_list); 
+		 !SortLIsSameIter(runner, SortLEnd(sort_list)); 
+		 runner = SortLNext(runner))
+	{
+		/* equal elements keep the order of items */
+		is_ok &= (NULL == prev || *prev < *(int *)SortLGetData(runner) || 
+				  (*prev == *(int *)SortLGetData(runner) && 
+				   prev < (int *)SortLGetData(runner)));
+		prev = (int *)SortLGetData(runner);
+	}
+	
+	SortLDestroy(sort_list);
+	
+	sort_list = SortLCreateFromArray(CmpCounted, &counter, NULL, 0);
+	is_ok &= SortLIsEmpty(sort_list);
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_MSG(\tCreateFromArray SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tCreateFromArray FAILED);
+		DEFAULT;
+	}
+	
+	SortLDestroy(sort_list);
+}
+
+void TestSortLAdopt(void)
+{
+	int ascending = 1;
+	static int nums[NUM];
+	sortl_ty *sort_list = SortLCreate(CmpSigned, &ascending);
+	dlist_ty *dlist = DListCreate();
+	sortl_itr_ty runner = {NULL};
+	int first = 10;
+	int prev = -1;
+	size_t i = 0;
+	int is_ok = 1;
+	
+	PRINT_MSG(\n--- Test Adopt ---);
+	
+	SortLInsert(sort_list, &first);
+	SortLSetSkipIndex(sort_list, 1);
+	
+	for (i = 0; i < NUM; ++i)
+	{
+		nums[i] = (int)((NUM - i) * 7 % NUM);
+		DListPushBack(dlist, &nums[i]);
+	}
+	
+	SortLAdopt(sort_list, dlist);
+	
+	is_ok &= (DListIsEmpty(dlist) && NUM + 1 == SortLCount(sort_list));
+	
+	for (runner = SortLBegin(sort_list); 
+		 !SortLIsSameIter(runner, SortLEnd(sort_list)); 
+		 runner = SortLNext(runner))
+	{
+		is_ok &= (prev <= *(int *)SortLGetData(runner));
+		prev = *(int *)SortLGetData(runner);
+	}
+	
+	/* the element of the list goes first; the index follows */
+	is_ok &= (&first == SortLGetData(SortLFind(sort_list, &first)));
+	is_ok &= (&nums[NUM / 2] == SortLGetData(SortLFind(sort_list, &nums[NUM / 2])));
+	
+	/* an empty dlist changes nothing */
+	SortLAdopt(sort_list, dlist);
+	is_ok &= (NUM + 1 == SortLCount(sort_list));
+	
+	if (is_ok)
+	{
+		GREEN;
+		PRINT_MSG(\tAdopt SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tAdopt FAILED);
+		DEFAULT;
+	}
+	
+	DListDestroy(dlist);
+	SortLDestroy(sort_list);
+}
+
 static void PrintSortedList(sortl_ty *sort_list)
 {
 	sortl_itr_ty running_itr = SortLBegin(sort_list);
@@ -345,3 +936,15 @@ static int CmpObjects(const void *obj1, const void *obj2, const void *key)
 	UNUSED(key);
 	return (*(int *)obj1 - *(int *)obj2);
 }
+
+static int CmpSigned(const void *obj1, const void *obj2, const void *sign)
+{
+	return *(const int *)sign * (*(const int *)obj1 - *(const int *)obj2);
+}
+
+static int CmpCounted(const void *obj1, const void *obj2, const void *counter)
+{
+	++*(size_t *)counter;
+	
+	return (*(int *)obj1 - *(int *)obj2);
+}
@@ -0,0 +1,158 @@
+/*******************************************************************************
+********************************* - TOP K - ***********************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "topk.h"
+
+#define NUM 100000
+#define K 1000
+
+void TestTopKOffer(void);
+void TestTopKOfferBatch(void);
+void TestTopKFewItems(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+
+static int values[NUM];
+static int test_failures = 0;
+
+int main(void)
+{
+	size_t i = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		values[i] = (int)((i * 7919) % NUM);
+	}
+
+	PRINT_MSG(\n--- Tests Top K ---\n);
+
+	TestTopKOffer();
+	TestTopKOfferBatch();
+	TestTopKFewItems();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestTopKOffer(void)
+{
+	topk_ty *tk = TopKCreate(K, CmpInts, NULL);
+	void *out[K];
+	size_t num_dropped = 0;
+	void *dropped = NULL;
+	int is_ok = 1;
+	size_t i = 0;
+
+	is_ok &= (NULL == TopKThreshold(tk));
+
+	for (i = 0; i < NUM; ++i)
+	{
+		dropped = TopKOffer(tk, &values[i]);
+		num_dropped += (NULL != dropped);
+	}
+
+	is_ok &= (NUM - K == num_dropped);
+	is_ok &= (K == TopKSize(tk));
+	is_ok &= (NUM - K == *(int *)TopKThreshold(tk));
+
+	/* biggest first; twice, since Result keeps the items */
+	is_ok &= (K == TopKResult(tk, out));
+	is_ok &= (K == TopKResult(tk, out));
+
+	for (i = 0; i < K; ++i)
+	{
+		is_ok &= (NUM - 1 - (int)i == *(int *)out[i]);
+	}
+
+	is_ok &= (&values[0] == TopKOffer(tk, &values[0]));
+
+	TopKDestroy(tk);
+
+	PRINT_TEST_RESULT(is_ok, "Offer Result", test_failures);
+}
+
+void TestTopKOfferBatch(void)
+{
+	topk_ty *tk = TopKCreate(K, CmpInts, NULL);
+	void *items[NUM];
+	void *out[K];
+	size_t num_dropped = 0;
+	int is_ok = 1;
+	size_t i = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		items[i] = &values[i];
+	}
+
+	/* in two batches; the dropped items come first */
+	num_dropped = TopKOfferBatch(tk, items, NUM / 2);
+	num_dropped += TopKOfferBatch(tk, items + NUM / 2, NUM - NUM / 2);
+
+	is_ok &= (NUM - K == num_dropped);
+	is_ok &= (K == TopKResult(tk, out));
+
+	for (i = 0; i < K; ++i)
+	{
+		is_ok &= (NUM - 1 - (int)i == *(int *)out[i]);
+	}
+
+	for (i = 0; i < NUM / 2 - K; ++i)
+	{
+		is_ok &= (NUM - K > *(int *)items[i]);
+	}
+
+	TopKDestroy(tk);
+
+	PRINT_TEST_RESULT(is_ok, "OfferBatch", test_failures);
+}
+
+void TestTopKFewItems(void)
+{
+	topk_ty *tk = TopKCreate(K, CmpInts, NULL);
+	topk_ty *none = TopKCreate(0, CmpInts, NULL);
+	void *out[K];
+	int is_ok = 1;
+	size_t i = 0;
+
+	for (i = 0; i < 10; ++i)
+	{
+		is_ok &= (NULL == TopKOffer(tk, &values[i]));
+	}
+
+	is_ok &= (NULL == TopKThreshold(tk));
+	is_ok &= (10 == TopKResult(tk, out));
+
+	for (i = 1; i < 10; ++i)
+	{
+		is_ok &= (0 < CmpInts(out[i - 1], out[i], NULL));
+	}
+
+	is_ok &= (&values[1] == TopKOffer(none, &values[1]));
+	is_ok &= (0 == TopKSize(none));
+
+	TopKDestroy(tk);
+	TopKDestroy(none);
+
+	PRINT_TEST_RESULT(is_ok, "Fewer than K", test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+
+	return *(const int *)obj1 - *(const int *)obj2;
+}
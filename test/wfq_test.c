@@ -0,0 +1,203 @@
+/*******************************************************************************
+************************ - WEIGHTED FAIR QUEUING - *****************************
+***************************** DATA STRUCTURES **********************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stddef.h>		/* size_t */
+#include <limits.h>		/* CHAR_BIT, ULONG_MAX */
+
+#include "utilities.h"
+#include "wfq.h"
+
+#define NUM 1000
+
+void TestWFQWeights(void);
+void TestWFQIdleTenant(void);
+void TestWFQCost(void);
+void TestWFQWrap(void);
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param);
+
+static int values[NUM];
+static int test_failures = 0;
+
+int main(void)
+{
+	size_t i = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		values[i] = (int)i;
+	}
+
+	PRINT_MSG(\n--- Tests Weighted Fair Queuing ---\n);
+
+	TestWFQWeights();
+	TestWFQIdleTenant();
+	TestWFQCost();
+	TestWFQWrap();
+
+	return (0 != test_failures);
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestWFQWeights(void)
+{
+	wfq_ty *wfq = WFQCreate(3, CmpInts, NULL);
+	size_t served[3] = {0};
+	size_t tenant = 0;
+	int prev[3] = {-1, -1, -1};
+	int *data = NULL;
+	int is_ok = 1;
+	size_t i = 0;
+
+	WFQSetWeight(wfq, 1, 2);
+	WFQSetWeight(wfq, 2, 5);
+
+	/* every tenant backlogged; each in its own priority order */
+	for (i = 0; i < 3 * 300; ++i)
+	{
+		is_ok &= (0 == WFQEnqueue(wfq, i % 3, &values[NUM - 1 - i], 1));
+	}
+
+	is_ok &= (900 == WFQSize(wfq) && 300 == WFQTenantSize(wfq, 2));
+
+	/* 1 : 2 : 5 while all of them are backlogged */
+	for (i = 0; i < 400; ++i)
+	{
+		data = (int *)WFQDequeue(wfq, &tenant);
+		is_ok &= (prev[tenant] < *data);
+		prev[tenant] = *data;
+		++served[tenant];
+	}
+
+	is_ok &= (50 == served[0] && 100 == served[1] && 250 == served[2]);
+
+	while (NULL != WFQDequeue(wfq, NULL))
+	{
+		/* empty */
+	}
+
+	is_ok &= (0 == WFQSize(wfq));
+
+	WFQDestroy(wfq);
+
+	PRINT_TEST_RESULT(is_ok, "Weights", test_failures);
+}
+
+void TestWFQIdleTenant(void)
+{
+	wfq_ty *wfq = WFQCreate(1000, CmpInts, NULL);
+	size_t tenant = 0;
+	int is_ok = 1;
+	size_t i = 0;
+
+	for (i = 0; i < NUM; ++i)
+	{
+		WFQEnqueue(wfq, 0, &values[i], 1);
+	}
+
+	for (i = 0; i < NUM / 2; ++i)
+	{
+		WFQDequeue(wfq, NULL);
+	}
+
+	/* a light tenant waking up is not behind the heavy one's backlog */
+	WFQEnqueue(wfq, 999, &values[0], 1);
+	WFQDequeue(wfq, &tenant);
+
+	if (999 != tenant)
+	{
+		WFQDequeue(wfq, &tenant);
+	}
+
+	is_ok &= (999 == tenant);
+	is_ok &= (0 == WFQTenantSize(wfq, 999));
+
+	/* elements left are freed with the scheduler */
+	WFQDestroy(wfq);
+
+	PRINT_TEST_RESULT(is_ok, "Idle tenant", test_failures);
+}
+
+void TestWFQCost(void)
+{
+	wfq_ty *wfq = WFQCreate(2, CmpInts, NULL);
+	size_t served[2] = {0};
+	size_t tenant = 0;
+	int is_ok = 1;
+	size_t i = 0;
+
+	/* same weight; tenant 0 sends elements 4 times as big */
+	for (i = 0; i < 200; ++i)
+	{
+		WFQEnqueue(wfq, 0, &values[i], 4);
+		WFQEnqueue(wfq, 1, &values[i], 1);
+	}
+
+	for (i = 0; i < 100; ++i)
+	{
+		WFQDequeue(wfq, &tenant);
+		++served[tenant];
+	}
+
+	is_ok &= (20 == served[0] && 80 == served[1]);
+
+	WFQDestroy(wfq);
+
+	PRINT_TEST_RESULT(is_ok, "Cost", test_failures);
+}
+
+void TestWFQWrap(void)
+{
+	wfq_ty *wfq = WFQCreate(2, CmpInts, NULL);
+	/* a quarter of the virtual clock at weight 1 */
+	unsigned long cost = 1UL << (sizeof(unsigned long) * CHAR_BIT - 18);
+	size_t tenant = 0;
+	int is_ok = 1;
+	size_t i = 0;
+
+	WFQSetWeight(wfq, 1, 2);
+
+	/* the clock wraps after 4 elements of tenant 0 */
+	for (i = 0; i < 6; ++i)
+	{
+		WFQEnqueue(wfq, 0, &values[i], cost);
+		WFQEnqueue(wfq, 1, &values[2 * i], cost);
+		WFQEnqueue(wfq, 1, &values[2 * i + 1], cost);
+	}
+
+	/* 1, then 0 and 1 at each equal tag, then 1 again */
+	for (i = 0; i < 18; ++i)
+	{
+		WFQDequeue(wfq, &tenant);
+		is_ok &= ((1 == i % 3) == (0 == tenant));
+	}
+
+	/* a cost that would overflow still comes after a cheap one */
+	WFQEnqueue(wfq, 0, &values[0], ULONG_MAX / 2 + 1);
+	WFQEnqueue(wfq, 1, &values[0], 1);
+	WFQDequeue(wfq, &tenant);
+	is_ok &= (1 == tenant);
+	WFQDequeue(wfq, &tenant);
+	is_ok &= (0 == tenant && 0 == WFQSize(wfq));
+
+	WFQDestroy(wfq);
+
+	PRINT_TEST_RESULT(is_ok, "Wrap", test_failures);
+}
+
+/*-------------------------------Side Function-------------------------------*/
+
+static int CmpInts(const void *obj1, const void *obj2, const void *param)
+{
+	UNUSED(param);
+
+	return *(const int *)obj1 - *(const int *)obj2;
+}